@@ -106,6 +106,18 @@ DEFINE_string(
     posix_api_type,
     XFERBENCH_POSIX_API_AIO,
     "API type for POSIX operations [AIO, URING, POSIXAIO] (only used with POSIX backend)");
+DEFINE_string(posix_uring_mode,
+              XFERBENCH_POSIX_URING_MODE_INTERRUPT,
+              "io_uring completion mode [INTERRUPT, SQPOLL, IOPOLL] (only used with "
+              "posix_api_type URING, IOPOLL requires storage_enable_direct)");
+DEFINE_int32(posix_sqpoll_cpu,
+             -1,
+             "CPU to pin the io_uring SQPOLL thread to, -1 for no affinity (only used with "
+             "posix_uring_mode SQPOLL)");
+DEFINE_string(posix_uring_rings,
+              XFERBENCH_POSIX_URING_RINGS_POOLED,
+              "io_uring rings [POOLED, PER_REQUEST], rings shared by all requests or set up per "
+              "request (only used with posix_api_type URING)");
 
 // DOCA GPUNetIO options - only used when backend is DOCA GPUNetIO
 DEFINE_string(gpunetio_device_list, "0", "Comma-separated GPU CUDA device id to use for \
@@ -184,6 +196,9 @@ std::string xferBenchConfig::gpunetio_oob_list = "";
 std::vector<std::string> devices = { };
 int xferBenchConfig::num_files = 0;
 std::string xferBenchConfig::posix_api_type = "";
+std::string xferBenchConfig::posix_uring_mode = "";
+int xferBenchConfig::posix_sqpoll_cpu = -1;
+std::string xferBenchConfig::posix_uring_rings = "";
 std::string xferBenchConfig::filepath = "";
 bool xferBenchConfig::storage_enable_direct = false;
 long xferBenchConfig::page_size = sysconf(_SC_PAGESIZE);
@@ -246,6 +261,33 @@ xferBenchConfig::loadFromFlags() {
                           << ". Must be one of [AIO, URING, POSIXAIO]" << std::endl;
                 return -1;
             }
+
+            posix_uring_mode = FLAGS_posix_uring_mode;
+            posix_sqpoll_cpu = FLAGS_posix_sqpoll_cpu;
+
+            // Validate POSIX io_uring mode
+            if (posix_uring_mode != XFERBENCH_POSIX_URING_MODE_INTERRUPT &&
+                posix_uring_mode != XFERBENCH_POSIX_URING_MODE_SQPOLL &&
+                posix_uring_mode != XFERBENCH_POSIX_URING_MODE_IOPOLL) {
+                std::cerr << "Invalid POSIX io_uring mode: " << posix_uring_mode
+                          << ". Must be one of [INTERRUPT, SQPOLL, IOPOLL]" << std::endl;
+                return -1;
+            }
+
+            if (posix_uring_mode == XFERBENCH_POSIX_URING_MODE_IOPOLL &&
+                !FLAGS_storage_enable_direct) {
+                std::cerr << "POSIX io_uring mode IOPOLL requires --storage_enable_direct"
+                          << std::endl;
+                return -1;
+            }
+
+            posix_uring_rings = FLAGS_posix_uring_rings;
+            if (posix_uring_rings != XFERBENCH_POSIX_URING_RINGS_POOLED &&
+                posix_uring_rings != XFERBENCH_POSIX_URING_RINGS_PER_REQUEST) {
+                std::cerr << "Invalid POSIX io_uring rings: " << posix_uring_rings
+                          << ". Must be one of [POOLED, PER_REQUEST]" << std::endl;
+                return -1;
+            }
         }
 
         // Load DOCA-specific configurations if backend is DOCA
@@ -452,6 +494,16 @@ xferBenchConfig::printConfig() {
         // Print POSIX options if backend is POSIX
         if (backend == XFERBENCH_BACKEND_POSIX) {
             printOption("POSIX API type (--posix_api_type=[AIO,URING,POSIXAIO])", posix_api_type);
+            if (posix_api_type == XFERBENCH_POSIX_API_URING) {
+                printOption("POSIX io_uring mode (--posix_uring_mode=[INTERRUPT,SQPOLL,IOPOLL])",
+                            posix_uring_mode);
+                if (posix_uring_mode == XFERBENCH_POSIX_URING_MODE_SQPOLL) {
+                    printOption("POSIX SQPOLL CPU (--posix_sqpoll_cpu=N)",
+                                std::to_string(posix_sqpoll_cpu));
+                }
+                printOption("POSIX io_uring rings (--posix_uring_rings=[POOLED,PER_REQUEST])",
+                            posix_uring_rings);
+            }
         }
 
         // Print OBJ options if backend is OBJ
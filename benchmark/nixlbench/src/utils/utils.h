@@ -81,6 +81,13 @@
 #define XFERBENCH_POSIX_API_URING "URING"
 #define XFERBENCH_POSIX_API_POSIXAIO "POSIXAIO"
 
+// POSIX io_uring modes
+#define XFERBENCH_POSIX_URING_MODE_INTERRUPT "INTERRUPT"
+#define XFERBENCH_POSIX_URING_MODE_SQPOLL "SQPOLL"
+#define XFERBENCH_POSIX_URING_MODE_IOPOLL "IOPOLL"
+#define XFERBENCH_POSIX_URING_RINGS_POOLED "POOLED"
+#define XFERBENCH_POSIX_URING_RINGS_PER_REQUEST "PER_REQUEST"
+
 // OBJ S3 scheme types
 #define XFERBENCH_OBJ_SCHEME_HTTP "http"
 #define XFERBENCH_OBJ_SCHEME_HTTPS "https"
@@ -153,6 +160,9 @@ class xferBenchConfig {
         static bool enable_vmm;
         static int num_files;
         static std::string posix_api_type;
+        static std::string posix_uring_mode;
+        static int posix_sqpoll_cpu;
+        static std::string posix_uring_rings;
         static bool storage_enable_direct;
         static int gds_batch_pool_size;
         static int gds_batch_limit;
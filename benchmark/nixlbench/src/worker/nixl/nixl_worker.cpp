@@ -178,6 +178,16 @@ xferBenchNixlWorker::xferBenchNixlWorker(int *argc, char ***argv, std::vector<st
             backend_params["use_aio"] = "false";
             backend_params["use_uring"] = "true";
             backend_params["use_posix_aio"] = "false";
+            if (xferBenchConfig::posix_uring_mode == XFERBENCH_POSIX_URING_MODE_SQPOLL) {
+                backend_params["uring_sqpoll"] = "true";
+                backend_params["uring_sqpoll_cpu"] =
+                    std::to_string(xferBenchConfig::posix_sqpoll_cpu);
+            } else if (xferBenchConfig::posix_uring_mode == XFERBENCH_POSIX_URING_MODE_IOPOLL) {
+                backend_params["uring_iopoll"] = "true";
+            }
+            if (xferBenchConfig::posix_uring_rings == XFERBENCH_POSIX_URING_RINGS_PER_REQUEST) {
+                backend_params["uring_ring_per_request"] = "true";
+            }
         } else if (xferBenchConfig::posix_api_type == XFERBENCH_POSIX_API_POSIXAIO) {
             backend_params["use_aio"] = "false";
             backend_params["use_uring"] = "false";
@@ -33,6 +33,7 @@ namespace fs = std::filesystem;
 
 #include "common/cyclic_buffer.h"
 #include "telemetry_event.h"
+#include "telemetry_histogram.h"
 
 volatile sig_atomic_t g_running = true;
 
@@ -89,6 +90,32 @@ print_telemetry_event(const nixlTelemetryEvent &event) {
     std::cout << "===========================" << std::endl;
 }
 
+void
+print_latency_histograms(const sharedLatencyHistograms &histograms) {
+    std::cout << "\n=== NIXL Transfer Latencies (us) ===" << std::endl;
+    for (size_t i = 0; i < histograms.size(); ++i) {
+        const nixlTelemetryHistSlot &slot = histograms[i];
+        std::cout << slot.backend_ << " " << nixlEnumStrings::xferOpStr(slot.op_) << " to '"
+                  << slot.remoteAgent_ << "'" << std::endl;
+        for (const auto &[name, hist] : {std::make_pair("xfer", &slot.xferTime_),
+                                         std::make_pair("post", &slot.postTime_)}) {
+            std::cout << "  " << name << ": count " << hist->count() << ", p50 "
+                      << hist->percentile(0.5) << ", p99 " << hist->percentile(0.99) << ", p999 "
+                      << hist->percentile(0.999) << ", max " << hist->max() << std::endl;
+        }
+    }
+    std::cout << "====================================" << std::endl;
+}
+
+uint64_t
+total_latency_count(const sharedLatencyHistograms &histograms) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < histograms.size(); ++i) {
+        total += histograms[i].xferTime_.count();
+    }
+    return total;
+}
+
 void
 usage() {
     std::cout << "Usage: telemetry_reader <telemetry_file_path>" << std::endl;
@@ -123,16 +150,40 @@ main(int argc, char *argv[]) {
                   << std::endl;
         std::cout << "Buffer capacity: " << buffer.capacity() << " events" << std::endl;
 
+        // Latency histograms are optional, agents before they were added do not write them
+        std::unique_ptr<sharedLatencyHistograms> histograms;
+        const std::string histograms_path = std::string(telemetry_path) + TELEMETRY_HIST_SUFFIX;
+        if (fs::exists(histograms_path)) {
+            histograms = std::make_unique<sharedLatencyHistograms>(histograms_path, false);
+        }
+
         nixlTelemetryEvent event;
         uint64_t event_count = 0;
+        uint64_t printed_latency_count = 0;
+        auto last_latency_print = std::chrono::steady_clock::now();
 
         while (g_running) {
             if (buffer.pop(event)) {
                 event_count++;
                 print_telemetry_event(event);
-            } else {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                continue;
             }
+
+            // Percentiles are read in place, print them at most once a second
+            const auto now = std::chrono::steady_clock::now();
+            if (histograms && (now - last_latency_print >= std::chrono::seconds(1))) {
+                const uint64_t latency_count = total_latency_count(*histograms);
+                if (latency_count != printed_latency_count) {
+                    print_latency_histograms(*histograms);
+                    printed_latency_count = latency_count;
+                }
+                last_latency_print = now;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+
+        if (histograms) {
+            print_latency_histograms(*histograms);
         }
 
         std::cout << "\nTotal events read: " << event_count << std::endl;
@@ -25,7 +25,7 @@
 
 #include "nixl_types.h"
 #include "backend_aux.h"
-#include "telemetry_event.h"
+#include "telemetry_queue.h"
 
 constexpr size_t MAX_TELEMETRY_QUEUE_SIZE = 1000;
 
@@ -35,8 +35,7 @@ class nixlBackendEngine {
         // Members that cannot be modified by a child backend and parent bookkeep
         nixl_backend_t  backendType;
         nixl_b_params_t customParams;
-        std::vector<nixlTelemetryEvent> telemetryEvents_;
-        std::mutex telemetryEventsMutex_;
+        nixlTelemetryQueue telemetryEvents_{MAX_TELEMETRY_QUEUE_SIZE};
 
     protected:
         // Members that can be accessed by the child (localAgent cannot be modified)
@@ -64,14 +63,14 @@ class nixlBackendEngine {
         void
         addTelemetryEvent(const std::string &event_name, uint64_t value) {
             if (!enableTelemetry_) return;
-            if (telemetryEvents_.size() >= MAX_TELEMETRY_QUEUE_SIZE) return;
-            std::lock_guard<std::mutex> lock(telemetryEventsMutex_);
-            telemetryEvents_.emplace_back(std::chrono::duration_cast<std::chrono::microseconds>(
-                                              std::chrono::system_clock::now().time_since_epoch())
-                                              .count(),
-                                          nixl_telemetry_category_t::NIXL_TELEMETRY_BACKEND,
-                                          event_name,
-                                          value);
+            // Dropped if this thread recorded MAX_TELEMETRY_QUEUE_SIZE events since the last drain
+            telemetryEvents_.push(
+                nixlTelemetryEvent(std::chrono::duration_cast<std::chrono::microseconds>(
+                                       std::chrono::system_clock::now().time_since_epoch())
+                                       .count(),
+                                   nixl_telemetry_category_t::NIXL_TELEMETRY_BACKEND,
+                                   event_name,
+                                   value));
         }
 
     public:
@@ -91,8 +90,15 @@ class nixlBackendEngine {
 
         std::vector<nixlTelemetryEvent>
         getTelemetryEvents() {
-            std::lock_guard<std::mutex> lock(telemetryEventsMutex_);
-            return std::move(telemetryEvents_);
+            std::vector<nixlTelemetryEvent> events;
+            telemetryEvents_.drain(events);
+            return events;
+        }
+
+        // Pending events to consume in place with nixlTelemetryQueue::merge
+        void
+        collectTelemetryEvents(nixlTelemetryQueue::cursors_t &cursors) {
+            telemetryEvents_.collect(cursors);
         }
 
         bool getInitErr() const noexcept { return initErr; }
@@ -105,6 +105,17 @@ class nixlAgent {
         createBackend (const nixl_backend_t &type,
                        const nixl_b_params_t &params,
                        nixlBackendH* &backend);
+
+        /**
+         * @brief  Set the order in which createXferReq considers backends when the request
+         *         does not specify any. Backends that are not listed are considered after
+         *         the listed ones. An empty list restores the default order.
+         *
+         * @param  backends      Backend handles, most preferred first
+         * @return nixl_status_t Error code if call was not successful
+         */
+        nixl_status_t
+        setBackendPreference (const std::vector<nixlBackendH*> &backends);
         /**
          * @brief  Register a memory/storage with NIXL. If a list of backends hints is provided
          *         (via extra_params), the registration is limited to the specified backends.
@@ -207,6 +218,48 @@ class nixlAgent {
                      const std::vector<int> &remote_indices,
                      nixlXferReqH* &req_hndl,
                      const nixl_opt_args_t* extra_params = nullptr) const;
+        /**
+         * @brief  Prepare a transfer template `tmpl_hndl`, a fixed pairing of indices from
+         *         already prepared descriptor list handles, such as the blocks of a layer.
+         *         The backend selection and the index and length checks of makeXferReq are
+         *         done once here, so requests made from the template skip them. The template
+         *         keeps the prepared descriptors, the memory behind them should stay
+         *         registered while it is in use.
+         *
+         * @param  local_side       Local prepared descriptor list handle
+         * @param  local_indices    Indices list to the local prepared descriptor list handle
+         * @param  remote_side      Remote (or loopback) prepared descriptor list handle
+         * @param  remote_indices   Indices list to the remote prepared descriptor list handle
+         * @param  tmpl_hndl  [out] Transfer template handle output
+         * @param  extra_params     Optional additional parameters, only the backends are used
+         * @return nixl_status_t    Error code if call was not successful
+         */
+        nixl_status_t
+        prepXferTemplate (const nixlDlistH* local_side,
+                          const std::vector<int> &local_indices,
+                          const nixlDlistH* remote_side,
+                          const std::vector<int> &remote_indices,
+                          nixlXferTemplateH* &tmpl_hndl,
+                          const nixl_opt_args_t* extra_params = nullptr) const;
+        /**
+         * @brief  Make a transfer request `req_handl` from a prepared transfer template,
+         *         with all of its index pairs or the ones selected by a mask. Back to back
+         *         pairs are merged unless skipDescMerge is set in extra_params. Optionally,
+         *         a notification message can also be provided through extra_params.
+         *
+         * @param  operation        Operation for transfer (e.g., NIXL_WRITE)
+         * @param  tmpl_hndl        Transfer template handle from prepXferTemplate
+         * @param  selected         Mask of the template pairs to transfer, or empty for all
+         * @param  req_handle [out] Transfer request handle output
+         * @param  extra_params     Optional additional parameters used in making a transfer request
+         * @return nixl_status_t    Error code if call was not successful
+         */
+        nixl_status_t
+        makeXferReq (const nixl_xfer_op_t &operation,
+                     const nixlXferTemplateH* tmpl_hndl,
+                     const std::vector<bool> &selected,
+                     nixlXferReqH* &req_hndl,
+                     const nixl_opt_args_t* extra_params = nullptr) const;
         /**
          * @brief  A combined API, to create a transfer request from two descriptor lists.
          *         NIXL will prepare each side and create a transfer handle `req_hndl`.
@@ -224,6 +277,7 @@ class nixlAgent {
          *         createXfer will result in repeated computation, such as validity checks and
          *         pre-processing done in the preparation step. If a list of backends hints is
          *         provided (via extra_params), the selection is limited to the specified backends.
+         *         Back to back pairs are merged only if mergeDescs is set in extra_params.
          *         Optionally, a notification message can also be provided through extra_params.
          *
          * @param  operation      Operation for transfer (e.g., NIXL_WRITE)
@@ -320,7 +374,9 @@ class nixlAgent {
         releaseXferReq (nixlXferReqH* req_hndl) const;
 
         /**
-         * @brief  Create a GPU transfer request from a transfer request.
+         * @brief  Create a GPU transfer request from a transfer request. Descriptor indices
+         *         on the GPU follow the request lists, so requests with merged descriptors
+         *         are rejected.
          *
          * @param  req_hndl     [in]  Transfer request obtained from makeXferReq/createXferReq
          * @param  gpu_req_hndl [out] GPU transfer request handle
@@ -383,6 +439,16 @@ class nixlAgent {
         nixl_status_t
         releasedDlistH (nixlDlistH* dlist_hndl) const;
 
+        /**
+         * @brief  Release the transfer template handle `tmpl_hndl`. Transfer requests made
+         *         from it are not affected.
+         *
+         * @param  tmpl_hndl     Transfer template handle to be released
+         * @return nixl_status_t Error code if call was not successful
+         */
+        nixl_status_t
+        releaseXferTemplate (nixlXferTemplateH* tmpl_hndl) const;
+
 
         /*** Notification Handling ***/
 
@@ -447,6 +513,20 @@ class nixlAgent {
                           nixl_blob_t &str,
                           const nixl_opt_args_t* extra_params = nullptr) const;
 
+        /**
+         * @brief  Get the changes of this agent's metadata since a version loaded by another
+         *         agent, as reported by its getRemoteMDVersion. Loading the delta applies
+         *         the registrations and deregistrations since that version in place. If the
+         *         changes since that version are not kept anymore, or the version is not from
+         *         this agent instance, the full metadata is returned instead.
+         *
+         * @param  since_version [in]  Version of the metadata loaded by the other agent
+         * @param  str           [out] The serialized metadata delta or full metadata blob
+         * @return nixl_status_t       Error code if call was not successful
+         */
+        nixl_status_t
+        getLocalMDDelta(const uint64_t since_version, nixl_blob_t &str) const;
+
         /**
          * @brief  Load other agent's metadata and unpack it internally. Now the local
          *         agent can initiate transfers towards the remote agent.
@@ -470,14 +550,59 @@ class nixlAgent {
         nixl_status_t
         invalidateRemoteMD (const std::string &remote_agent);
 
+        /**
+         * @brief  Get the version of the metadata loaded for a remote agent, to request only
+         *         the changes since then through its getLocalMDDelta. Transfer requests
+         *         created before a delta removing descriptors of that agent have to be recreated.
+         *
+         * @param  remote_agent  Remote agent name
+         * @param  version [out] Loaded metadata version
+         * @return nixl_status_t NIXL_ERR_NOT_FOUND if no full metadata of that agent was loaded
+         */
+        nixl_status_t
+        getRemoteMDVersion(const std::string &remote_agent, uint64_t &version) const;
+
+        /**
+         * @brief  Save the metadata loaded for a remote agent to a snapshot file, to be loaded
+         *         with loadRemoteMDSnapshot after a restart instead of fetching it again.
+         *
+         * @param  remote_agent  Remote agent name
+         * @param  path          Snapshot file path, replaced atomically if it exists
+         * @return nixl_status_t Error code if call was not successful
+         */
+        nixl_status_t
+        saveRemoteMD(const std::string &remote_agent, const std::string &path) const;
+
+        /**
+         * @brief  Load remote agent metadata from a snapshot file saved by saveRemoteMD. The file
+         *         is mapped and deserialized in place. The next fetchRemoteMD from the peer
+         *         validates it: the snapshot is kept if the peer can send the changes since its
+         *         version, and is replaced by the fresh metadata otherwise. Loading any other
+         *         metadata of that agent replaces it too. Until validated, transfers toward
+         *         that agent fail with NIXL_ERR_NOT_ALLOWED, unless use_unvalidated is set.
+         *
+         * @param  path             Snapshot file path
+         * @param  agent_name [out] Agent name extracted from the snapshot
+         * @param  use_unvalidated  Allow transfers before validation, with descriptors the peer
+         *                          might have deregistered since the snapshot was saved
+         * @return nixl_status_t    NIXL_ERR_NOT_ALLOWED if that agent is already loaded
+         *                          from another source, error code if call was not successful
+         */
+        nixl_status_t
+        loadRemoteMDSnapshot(const std::string &path,
+                             std::string &agent_name,
+                             bool use_unvalidated = false);
+
         /*** Metadata handling through direct channels (p2p socket and ETCD) ***/
         /**
          * @brief  Send your own agent metadata to a remote location.
          *
-         * @param  extra_params  Only to optionally specify IP address and/or port.
+         * @param  extra_params  Only to optionally specify IP address and/or port, or peers.
          *                       If IP is specified, this will enable peer to peer sending of your metadata.
          *                       If IP unspecified, this will send your data to the metadata server.
          *                       Port can be specified or defaults to default_comm_port.
+         *                       If peers is specified, the metadata is sent to all of them, directly
+         *                       or forwarded through a tree of fanoutDegree peers per agent.
          *
          * @return nixl_status_t Error code if call was not successful
          */
@@ -496,6 +621,7 @@ class nixlAgent {
          *         If 'extra_params->ip_addr' is set, the metadata will only be sent to a single peer, otherwise
          *         it will be sent to the central metadata server, if supported.
          *         If 'extra_params->port' can be set in addition to IP address, or will default to default_comm_port.
+         *         If 'extra_params->peers' is set, the metadata is sent to all of them as in sendLocalMD.
          *         The 'extra_params->metadataLabel' is required when sending to a central metadata server and
          *         ignored when sending to a peer.
          *
@@ -511,7 +637,8 @@ class nixlAgent {
         /**
          * @brief  Fetch other agent's metadata from a peer or central metadata server,
          *         then unpack it internally. When fetching from a peer, only the full metadata
-         *         is supported. When fetching from a central metadata server, the metadataLabel
+         *         is supported, sent as a delta since the loaded version if there is one.
+         *         When fetching from a central metadata server, the metadataLabel
          *         can be specified to fetch partial metadata.
          *
          * @param  remote_name   Name of remote agent to fetch from ETCD or socket.
@@ -22,6 +22,7 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <cassert>
 #include "nixl_types.h"
 
 /**
@@ -265,12 +266,18 @@ public:
 
     /**
      * @brief Operator [] overloading, get/set descriptor at [index].
-     *        Can throw std::out_of_range exception.
+     *        Defined here so backend loops over descriptors can inline the access.
      */
-    const T &
-    operator[](unsigned int index) const;
+    inline const T &
+    operator[](unsigned int index) const {
+        return descs[index];
+    }
+
     virtual T &
-    operator[](unsigned int index);
+    operator[](unsigned int index) {
+        assert(index < descs.size());
+        return descs[index];
+    }
 
     /**
      * @brief Vector like iterators for const and non-const elements
@@ -50,8 +50,8 @@ class nixlAgentConfig {
         uint64_t pthrDelay;
         /**
          * @var Listener thread frequency knob (in us)
-         *      Listener thread sleeps in a similar way to progress thread, desrcibed previously.
-         *      These will be combined into a unified NIXL Thread API in a future version.
+         *      Unused, the listener thread blocks in epoll until a peer message, a new
+         *      connection or a local request arrives. Kept for API compatibility.
          */
         uint64_t lthrDelay;
 
@@ -61,6 +61,21 @@ class nixlAgentConfig {
          */
         std::chrono::microseconds etcdWatchTimeout;
 
+        /**
+         * @var Compact encoding of the descriptor lists in the local metadata
+         *      Delta/varint encoded descriptors and deduplicated metadata blobs. Agents of
+         *      versions without it cannot load such metadata, so it is disabled by default.
+         */
+        bool compactMetadata = false;
+
+        /**
+         * @var Lazy unpacking of loaded remote metadata
+         *      Remote descriptors keep their metadata blob, which is unpacked by the backend
+         *      on the first transfer preparation that uses them. Backends then load remote
+         *      metadata concurrently with other transfers, so it is disabled by default.
+         */
+        bool lazyRemoteMD = false;
+
         /**
          * @brief  Agent configuration constructor for enabling various features.
          * @param use_prog_thread    flag to determine use of progress thread
@@ -69,7 +84,7 @@ class nixlAgentConfig {
          * @param sync_mode          Optional Thread synchronization mode
          * @param num_workers        Optional number of shared workers per backend
          * @param pthr_delay_us      Optional delay for pthread in us
-         * @param lthr_delay_us      Optional delay for listener thread in us
+         * @param lthr_delay_us      Unused, the listener thread sleeps until it has work
          * @param capture_telemetry  Optional flag to enable telemetry capture
          * @param etcd_watch_timeout Optional timeout for etcd watch operations in microseconds
          */
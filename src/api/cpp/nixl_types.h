@@ -28,6 +28,7 @@ class nixlSerDes;
 class nixlDlistH;
 class nixlBackendH;
 class nixlXferReqH;
+class nixlXferTemplateH;
 class nixlAgentData;
 
 
@@ -185,6 +186,13 @@ struct nixlAgentOptionalArgs {
      */
     bool skipDescMerge = false;
 
+    /**
+     * @var mergeDescs boolean to merge consecutive descriptors, used in createXferReq.
+     *      Off by default, as descriptor indices of the request (e.g. in GPU transfer
+     *      requests) then no longer match the given lists.
+     */
+    bool mergeDescs = false;
+
     /**
      * @var includeConnInfo boolean to include connection information in the metadata,
      *                      used in getLocalPartialMD.
@@ -203,6 +211,21 @@ struct nixlAgentOptionalArgs {
      */
     int port = default_comm_port;
 
+    /**
+     * @var peers Used to send metadata to several peers (IP address and port) at once,
+     *            used in sendLocalMD and sendLocalPartialMD. If set, ipAddr and port are ignored.
+     *            The metadata is serialized once and shared between the sends.
+     */
+    std::vector<std::pair<std::string, int>> peers;
+
+    /**
+     * @var fanoutDegree Maximum number of peers an agent sends to when peers is set. Each of
+     *                   them forwards the metadata to its share of the remaining peers the
+     *                   same way, so N peers receive it in O(log N) rounds. 0 sends to
+     *                   every peer directly.
+     */
+    unsigned int fanoutDegree = 0;
+
     /**
      * @var metadataLabel Used to specify the label of the metadata to be sent/fetched
      *                    when working with ETCD metadata server. The label will be appended to the
@@ -271,6 +294,12 @@ struct nixlXferTelemetry {
      *      If any merging of descriptors were performed, it will be reflected here.
      */
     size_t descCount;
+
+    /**
+     * @var requestedDescCount Number of descriptors given to the transfer request,
+     *      before merging.
+     */
+    size_t requestedDescCount;
 };
 
 /**
@@ -557,6 +557,7 @@ class nixl_agent:
     @param notif_msg Optional notification message.
            notif_msg should be bytes, as that is what will be returned to the target, but will work with str too.
     @param backends Optional list of backend names to limit which backends NIXL can use.
+    @param merge_descs Whether to merge back to back descriptors, off by default.
     @return Opaque handle for posting/checking transfer.
             The handle can be released by calling release_xfer_handle from agent, or release() method on itself.
     """
@@ -569,6 +570,7 @@ class nixl_agent:
         remote_agent: str,
         notif_msg: bytes = b"",
         backends: list[str] = [],
+        merge_descs: bool = False,
     ) -> nixl_xfer_handle:
         op = self.nixl_ops[operation]
         handle_list = []
@@ -576,7 +578,7 @@ class nixl_agent:
             handle_list.append(self.backends[backend_string])
 
         handle = self.agent.createXferReq(
-            op, local_descs, remote_descs, remote_agent, notif_msg, handle_list
+            op, local_descs, remote_descs, remote_agent, notif_msg, handle_list, merge_descs
         )
 
         return nixl_xfer_handle(self.agent, handle)
@@ -623,7 +625,8 @@ class nixl_agent:
            The output object has three time values fields in microseconds
            (startTime, postDuration, xferDuration), as well as integer totalBytes transferred
            for the request, and integer descCount representing number of descriptors involved
-           (for example if there was some merging of descriptors).
+           (for example if there was some merging of descriptors), out of requestedDescCount
+           descriptors given to the request.
 
     @param handle Handle to the transfer operation, from make_prepped_xfer or initialize_xfer.
     @return nixlXferTelemetry object
@@ -90,6 +90,30 @@ public:
     nixlNoTelemetryError(const char *what) : runtime_error(what) {}
 };
 
+// Indices from a python list, or a 1D numpy array of uint32 or int32
+std::vector<int>
+init_indices(py::object &indices) {
+    if (py::isinstance<py::array>(indices)) {
+        auto indices_array = indices.cast<py::array_t<uint32_t>>();
+        if (indices_array.ndim() != 1)
+            throw std::invalid_argument("indices numpy array must be 1D");
+        if (!py::dtype::of<uint32_t>().equal(indices_array.dtype()) &&
+            !py::dtype::of<int32_t>().equal(indices_array.dtype()))
+            throw std::invalid_argument("indices numpy array must be 1D of uint32 or int32");
+        if (!(indices_array.flags() & py::array::c_style))
+            throw std::invalid_argument("indices numpy array must be C-contiguous");
+        // We assume that the indices array matches the nixlBasicDesc layout so we
+        // can simply memcpy
+        std::vector<int> ret(indices_array.size());
+        std::memcpy(ret.data(),
+                    indices_array.data(),
+                    indices_array.size() * sizeof(uint32_t));
+        return ret;
+    } else {
+        return indices.cast<std::vector<int>>();
+    }
+}
+
 void
 throw_nixl_exception(const nixl_status_t &status) {
     switch (status) {
@@ -199,7 +223,8 @@ PYBIND11_MODULE(_bindings, m) {
         .def_property_readonly("xferDuration",
                                [](const nixl_xfer_telem_t &t) { return t.xferDuration.count(); })
         .def_readonly("totalBytes", &nixl_xfer_telem_t::totalBytes)
-        .def_readonly("descCount", &nixl_xfer_telem_t::descCount);
+        .def_readonly("descCount", &nixl_xfer_telem_t::descCount)
+        .def_readonly("requestedDescCount", &nixl_xfer_telem_t::requestedDescCount);
 
 
     py::register_exception<nixlNotPostedError>(m, "nixlNotPostedError");
@@ -422,7 +447,9 @@ PYBIND11_MODULE(_bindings, m) {
         .def(py::init<bool, bool, int, nixl_thread_sync_t, int>())
         .def(py::init<bool, bool, int, nixl_thread_sync_t, int, uint64_t>())
         .def(py::init<bool, bool, int, nixl_thread_sync_t, int, uint64_t, uint64_t>())
-        .def(py::init<bool, bool, int, nixl_thread_sync_t, int, uint64_t, uint64_t, bool>());
+        .def(py::init<bool, bool, int, nixl_thread_sync_t, int, uint64_t, uint64_t, bool>())
+        .def_readwrite("compactMetadata", &nixlAgentConfig::compactMetadata)
+        .def_readwrite("lazyRemoteMD", &nixlAgentConfig::lazyRemoteMD);
 
     // note: pybind will automatically convert notif_map to python types:
     // so, a Dictionary of string: List<string>
@@ -466,6 +493,16 @@ PYBIND11_MODULE(_bindings, m) {
                  throw_nixl_exception(agent.createBackend(type, initParams, backend));
                  return (uintptr_t)backend;
              })
+        .def("setBackendPreference",
+             [](nixlAgent &agent, std::vector<uintptr_t> backends) -> nixl_status_t {
+                 std::vector<nixlBackendH *> order;
+                 for (uintptr_t backend : backends)
+                     order.push_back((nixlBackendH *)backend);
+
+                 nixl_status_t ret = agent.setBackendPreference(order);
+                 throw_nixl_exception(ret);
+                 return ret;
+             })
         .def(
             "registerMem",
             [](nixlAgent &agent,
@@ -570,31 +607,8 @@ PYBIND11_MODULE(_bindings, m) {
                 std::vector<int> local_indices_vec;
                 std::vector<int> remote_indices_vec;
 
-                auto init_indices_lambda = [](py::object &indices) -> std::vector<int> {
-                    if (py::isinstance<py::array>(indices)) {
-                        auto indices_array = indices.cast<py::array_t<uint32_t>>();
-                        if (indices_array.ndim() != 1)
-                            throw std::invalid_argument("indices numpy array must be 1D");
-                        if (!py::dtype::of<uint32_t>().equal(indices_array.dtype()) &&
-                            !py::dtype::of<int32_t>().equal(indices_array.dtype()))
-                            throw std::invalid_argument(
-                                "indices numpy array must be 1D of uint32 or int32");
-                        if (!(indices_array.flags() & py::array::c_style))
-                            throw std::invalid_argument("indices numpy array must be C-contiguous");
-                        // We assume that the indices array matches the nixlBasicDesc layout so we
-                        // can simply memcpy
-                        std::vector<int> ret(indices_array.size());
-                        std::memcpy(ret.data(),
-                                    indices_array.data(),
-                                    indices_array.size() * sizeof(uint32_t));
-                        return ret;
-                    } else {
-                        return indices.cast<std::vector<int>>();
-                    }
-                };
-
-                local_indices_vec = init_indices_lambda(local_indices);
-                remote_indices_vec = init_indices_lambda(remote_indices);
+                local_indices_vec = init_indices(local_indices);
+                remote_indices_vec = init_indices(remote_indices);
 
                 throw_nixl_exception(agent.makeXferReq(operation,
                                                        (nixlDlistH *)local_side,
@@ -614,6 +628,64 @@ PYBIND11_MODULE(_bindings, m) {
             py::arg("notif_msg") = std::string(""),
             py::arg("backend") = std::vector<uintptr_t>({}),
             py::arg("skip_desc_merg") = false)
+        .def(
+            "prepXferTemplate",
+            [](nixlAgent &agent,
+               uintptr_t local_side,
+               py::object local_indices,
+               uintptr_t remote_side,
+               py::object remote_indices,
+               std::vector<uintptr_t> backends) -> uintptr_t {
+                nixlXferTemplateH *handle = nullptr;
+                nixl_opt_args_t extra_params;
+
+                for (uintptr_t backend : backends)
+                    extra_params.backends.push_back((nixlBackendH *)backend);
+
+                throw_nixl_exception(agent.prepXferTemplate((nixlDlistH *)local_side,
+                                                            init_indices(local_indices),
+                                                            (nixlDlistH *)remote_side,
+                                                            init_indices(remote_indices),
+                                                            handle,
+                                                            &extra_params));
+
+                return (uintptr_t)handle;
+            },
+            py::arg("local_side"),
+            py::arg("local_indices"),
+            py::arg("remote_side"),
+            py::arg("remote_indices"),
+            py::arg("backend") = std::vector<uintptr_t>({}))
+        .def(
+            "makeXferReqFromTemplate",
+            [](nixlAgent &agent,
+               const nixl_xfer_op_t &operation,
+               uintptr_t tmpl_hndl,
+               const std::vector<bool> &selected,
+               const std::string &notif_msg,
+               bool skip_desc_merge) -> uintptr_t {
+                nixlXferReqH *handle = nullptr;
+                nixl_opt_args_t extra_params;
+
+                if (notif_msg.size() > 0) {
+                    extra_params.notifMsg = notif_msg;
+                    extra_params.hasNotif = true;
+                }
+                extra_params.skipDescMerge = skip_desc_merge;
+
+                throw_nixl_exception(agent.makeXferReq(operation,
+                                                       (nixlXferTemplateH *)tmpl_hndl,
+                                                       selected,
+                                                       handle,
+                                                       &extra_params));
+
+                return (uintptr_t)handle;
+            },
+            py::arg("operation"),
+            py::arg("tmpl_hndl"),
+            py::arg("selected") = std::vector<bool>({}),
+            py::arg("notif_msg") = std::string(""),
+            py::arg("skip_desc_merge") = false)
         .def(
             "createXferReq",
             [](nixlAgent &agent,
@@ -622,7 +694,8 @@ PYBIND11_MODULE(_bindings, m) {
                const nixl_xfer_dlist_t &remote_descs,
                const std::string &remote_agent,
                const std::string &notif_msg,
-               std::vector<uintptr_t> backends) -> uintptr_t {
+               std::vector<uintptr_t> backends,
+               bool merge_descs) -> uintptr_t {
                 nixlXferReqH *handle = nullptr;
                 nixl_opt_args_t extra_params;
 
@@ -633,6 +706,7 @@ PYBIND11_MODULE(_bindings, m) {
                     extra_params.notifMsg = notif_msg;
                     extra_params.hasNotif = true;
                 }
+                extra_params.mergeDescs = merge_descs;
                 nixl_status_t ret = agent.createXferReq(
                     operation, local_descs, remote_descs, remote_agent, handle, &extra_params);
 
@@ -644,7 +718,8 @@ PYBIND11_MODULE(_bindings, m) {
             py::arg("remote_descs"),
             py::arg("remote_agent"),
             py::arg("notif_msg") = std::string(""),
-            py::arg("backend") = std::vector<uintptr_t>({}))
+            py::arg("backend") = std::vector<uintptr_t>({}),
+            py::arg("merge_descs") = false)
         .def(
             "estimateXferCost",
             [](nixlAgent &agent, uintptr_t reqh) -> std::tuple<int64_t, int64_t, int> {
@@ -707,6 +782,12 @@ PYBIND11_MODULE(_bindings, m) {
                  throw_nixl_exception(ret);
                  return ret;
              })
+        .def("releaseXferTemplate",
+             [](nixlAgent &agent, uintptr_t handle) -> nixl_status_t {
+                 nixl_status_t ret = agent.releaseXferTemplate((nixlXferTemplateH *)handle);
+                 throw_nixl_exception(ret);
+                 return ret;
+             })
         .def(
             "getNotifs",
             [](nixlAgent &agent,
@@ -758,6 +839,12 @@ PYBIND11_MODULE(_bindings, m) {
                  throw_nixl_exception(agent.getLocalMD(ret_str));
                  return py::bytes(ret_str);
              })
+        .def("getLocalMDDelta",
+             [](nixlAgent &agent, uint64_t since_version) -> py::bytes {
+                 std::string ret_str("");
+                 throw_nixl_exception(agent.getLocalMDDelta(since_version, ret_str));
+                 return py::bytes(ret_str);
+             })
         .def(
             "getLocalPartialMD",
             [](nixlAgent &agent,
@@ -786,6 +873,23 @@ PYBIND11_MODULE(_bindings, m) {
                  return py::bytes(remote_name);
              })
         .def("invalidateRemoteMD", &nixlAgent::invalidateRemoteMD)
+        .def("saveRemoteMD", &nixlAgent::saveRemoteMD)
+        .def(
+            "loadRemoteMDSnapshot",
+            [](nixlAgent &agent, const std::string &path, bool use_unvalidated) -> py::bytes {
+                std::string remote_name("");
+                throw_nixl_exception(
+                    agent.loadRemoteMDSnapshot(path, remote_name, use_unvalidated));
+                return py::bytes(remote_name);
+            },
+            py::arg("path"),
+            py::arg("use_unvalidated") = false)
+        .def("getRemoteMDVersion",
+             [](nixlAgent &agent, const std::string &remote_agent) -> uint64_t {
+                 uint64_t version = 0;
+                 throw_nixl_exception(agent.getRemoteMDVersion(remote_agent, version));
+                 return version;
+             })
         .def(
             "sendLocalMD",
             [](nixlAgent &agent, std::string ip_addr, int port) {
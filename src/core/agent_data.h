@@ -17,9 +17,13 @@
 #ifndef __AGENT_DATA_H_
 #define __AGENT_DATA_H_
 
+#include <deque>
+#include <string_view>
+
 #include "common/str_tools.h"
 #include "mem_section.h"
 #include "telemetry.h"
+#include "transfer_request.h"
 #include "stream/metadata_stream.h"
 #include "sync.h"
 
@@ -35,6 +39,8 @@ class SyncClient;
 #endif // HAVE_ETCD
 
 using backend_list_t = std::vector<nixlBackendEngine*>;
+// Backend per (local memory type, remote memory type) pair, indexed by local * (FILE_SEG+1) + remote
+using backend_sel_t = std::array<nixlBackendEngine*, (FILE_SEG+1) * (FILE_SEG+1)>;
 
 //Internal typedef to define metadata communication request types
 //To be extended with ETCD operations
@@ -42,6 +48,7 @@ enum nixl_comm_t {
     SOCK_SEND,
     SOCK_FETCH,
     SOCK_INVAL,
+    SOCK_FANOUT,
     SOCK_MAX,
 #if HAVE_ETCD
     ETCD_SEND,
@@ -54,16 +61,28 @@ enum nixl_comm_t {
 // 1) Command type
 // 2) IP Address
 // 3) Port
-// 4) Metadata to send (for sendLocalMD calls)
+// 4) Metadata to send (for sendLocalMD calls), or remote agent name (for fetchRemoteMD calls)
+// SOCK_FANOUT carries the encoded peer list as IP Address and the fanout degree as Port
 using nixl_comm_req_t = std::tuple<nixl_comm_t, std::string, int, nixl_blob_t>;
 
 using nixl_socket_peer_t = std::pair<std::string, int>;
 
+// Registration change of a backend supporting remote, kept to serve metadata deltas
+struct nixlMDChange {
+    uint64_t                   version;
+    section_key_t              section;
+    bool                       removed;
+    std::vector<nixlBasicDesc> descs;
+};
+
 class nixlAgentData {
     private:
         std::string     name;
         nixlAgentConfig config;
         nixlLock        lock;
+        // Post and status of requests with a current remoteEpoch skip the lock, remote
+        // metadata is freed only after the readers of the older epoch left
+        nixlGracePeriod xferGrace;
         bool telemetryEnabled = false;
 
         // some handle that can be used to instantiate an object from the lib
@@ -78,6 +97,17 @@ class nixlAgentData {
         std::unordered_map<nixl_backend_t, nixlBackendH*> backendHandles;
         std::unordered_map<nixl_backend_t, nixl_blob_t>   connMD;
 
+        // Recycled transfer request handles
+        nixlXferReqPool xferReqPool;
+
+        // Order in which createXferReq tries backends when none are specified
+        backend_list_t backendPreference;
+        // Backend last selected by createXferReq per remote agent and memory types. Reset
+        // whenever registrations, remote metadata or the preference change.
+        std::unordered_map<std::string, backend_sel_t,
+                           std::hash<std::string>, strEqual> backendSelection;
+        std::mutex backendSelectionLock;
+
         // Bookkeeping from GPU request handles to backend engines
         std::unordered_map<nixlGpuXferReqH, nixlBackendEngine *> gpuReqToEngine;
 
@@ -89,6 +119,31 @@ class nixlAgentData {
                            std::hash<std::string>, strEqual>     remoteBackends;
         std::unordered_map<std::string, nixlRemoteSection*,
                            std::hash<std::string>, strEqual>     remoteSections;
+        // Bumped whenever a remote section is dropped or has descriptors removed, lets
+        // transfer requests skip the lookup above and the lock while it is unchanged
+        std::atomic<uint64_t>                                    remoteEpoch{0};
+        // remoteEpoch after the section of a remote was dropped or had descriptors removed
+        // in place. Requests toward that remote created before it are stale for good, even
+        // once the remote is loaded again.
+        std::unordered_map<std::string, uint64_t,
+                           std::hash<std::string>, strEqual>     remoteStaleEpochs;
+
+        // Version of the local metadata, bumped by each published registration change.
+        // Starts at a random base so a restarted agent does not match the versions
+        // loaded from its previous instance.
+        uint64_t                                                 mdVersion;
+        // Changes after mdLogStart, oldest first, bounded to mdChangeLogMax descriptors
+        std::deque<nixlMDChange>                                 mdChangeLog;
+        uint64_t                                                 mdLogStart;
+        size_t                                                   mdChangeLogDescs = 0;
+        static constexpr size_t                                  mdChangeLogMax = 1 << 20;
+        // Metadata version loaded per remote agent, if it was published with one
+        std::unordered_map<std::string, uint64_t,
+                           std::hash<std::string>, strEqual>     remoteMDVersions;
+        // Remote agents loaded from a snapshot, until a delta on top of it validates it,
+        // and whether transfers may use the snapshot before that
+        std::unordered_map<std::string, bool,
+                           std::hash<std::string>, strEqual>     remoteSnapshots;
 
         // State/methods for listener thread
         nixlMDStreamListener *listener;
@@ -96,6 +151,9 @@ class nixlAgentData {
         std::thread commThread;
         std::vector<nixl_comm_req_t> commQueue;
         std::mutex commLock;
+        // The comm thread sleeps on commEpollFd, commEventFd wakes it for new work or stop
+        int commEpollFd = -1;
+        int commEventFd = -1;
         std::atomic<bool> commThreadStop;
         std::atomic<bool> agentShutdown;
         bool useEtcd;
@@ -107,6 +165,9 @@ class nixlAgentData {
         void
         commWorkerInternal(nixlAgent *myAgent);
         void enqueueCommWork(nixl_comm_req_t request);
+        void enqueueCommFanout(const std::vector<nixl_socket_peer_t> &peers,
+                               unsigned int degree,
+                               nixl_blob_t md);
         void getCommWork(std::vector<nixl_comm_req_t> &req_list);
         nixl_status_t
         loadConnInfo(const std::string &remote_name,
@@ -115,8 +176,75 @@ class nixlAgentData {
         nixl_status_t
         loadRemoteSections(const std::string &remote_name, nixlSerDes &sd);
         nixl_status_t
+        loadRemoteMD(std::string_view remote_metadata, std::string &agent_name);
+        nixl_status_t
+        loadRemoteDelta(const std::string &remote_name,
+                        uint64_t from_version,
+                        nixlSerDes &sd);
+        void
+        eraseRemoteVersion(const std::string &remote_name);
+        nixl_status_t
         invalidateRemoteData(const std::string &remote_name);
 
+        void
+        recordMDChange(const nixl_reg_dlist_t &descs,
+                       const backend_list_t &backends,
+                       bool removed);
+
+        // Frees the section of remote_name once no post/status uses it and makes the
+        // requests toward it stale, called with the exclusive lock held
+        void
+        dropRemoteSection(const std::string &remote_name);
+        // Whether transfers may use the loaded metadata of remote_name, false for a
+        // snapshot not validated yet unless that was allowed. Called with the lock held.
+        bool
+        isRemoteUsable(const std::string &remote_name) const;
+        // Whether remote_name is still loaded, called with the lock held. No lookup
+        // while seen_epoch is current, otherwise seen_epoch is refreshed.
+        bool
+        isRemoteValid(const std::string &remote_name, uint64_t &seen_epoch);
+        nixlBackendEngine*
+        getSelectedBackend(const std::string &remote_name,
+                           nixl_mem_t local_mem,
+                           nixl_mem_t remote_mem);
+        void
+        setSelectedBackend(const std::string &remote_name,
+                           nixl_mem_t local_mem,
+                           nixl_mem_t remote_mem,
+                           nixlBackendEngine *backend);
+        void
+        clearSelectedBackends();
+
+        // Checks the index pairs of two prepped lists and picks their common backend,
+        // called with the lock held. remote_epoch is the one to stamp the request with.
+        nixl_status_t
+        selectXferPairs(const nixlDlistH* local_side,
+                        const std::vector<int> &local_indices,
+                        const nixlDlistH* remote_side,
+                        const std::vector<int> &remote_indices,
+                        const nixl_opt_args_t* extra_params,
+                        nixlBackendEngine* &backend,
+                        size_t &total_bytes,
+                        uint64_t &remote_epoch);
+        // Merges and prepares in its backend a pooled handle filled in by makeXferReq
+        nixl_status_t
+        prepPooledXferReq(nixlXferReqPool::handle_ptr_t &handle,
+                          const nixl_xfer_op_t &operation,
+                          size_t total_bytes,
+                          const nixl_opt_args_t* extra_params,
+                          nixlXferReqH* &req_hndl);
+
+        // Invalidate a remote reported as disconnected by a backend on the transfer path,
+        // trading the read section or shared guard of the caller for the exclusive lock
+        void
+        invalidateDisconnected(const std::string &remote_name,
+                               nixlGraceGuard &grace,
+                               std::shared_lock<nixlLock> &guard);
+        // Bumps remoteEpoch, then waits for post/status calls still using the older
+        // remote metadata. Called with the exclusive lock held, before any of it is freed.
+        uint64_t
+        retireRemoteEpoch();
+
     public:
         nixlAgentData(const std::string &name, const nixlAgentConfig &cfg);
         ~nixlAgentData();
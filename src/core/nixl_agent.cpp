@@ -17,8 +17,17 @@
 
 #include <iostream>
 #include <chrono>
+#include <cstring>
 #include <iostream>
 #include <numeric>
+#include <algorithm>
+#include <random>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "nixl.h"
 #include "serdes/serdes.h"
@@ -97,6 +106,19 @@ nixlXferReqH::updateRequestStats(std::unique_ptr<nixlTelemetry> &telemetry_pub,
     if (telemetry_pub && (stat_status != NIXL_TELEMETRY_POST)) {
         telemetry_pub->addPostTime(telemetry.postDuration);
         telemetry_pub->addXferTime(duration, backendOp == NIXL_WRITE, telemetry.totalBytes);
+
+        // A slot can also be nullptr when the histograms are full, hence the engine check
+        if ((latencyHistEngine != engine) || (latencyHistOp != backendOp) ||
+            (latencyHistAgent != remoteAgent)) {
+            latencyHist = telemetry_pub->histogram(engine->getType(), remoteAgent, backendOp);
+            latencyHistEngine = engine;
+            latencyHistAgent = remoteAgent;
+            latencyHistOp = backendOp;
+        }
+        if (latencyHist) {
+            latencyHist->xferTime_.record(duration.count());
+            latencyHist->postTime_.record(telemetry.postDuration.count());
+        }
     }
 
     NIXL_TRACE << "[NIXL TELEMETRY]: From backend " << engine->getType()
@@ -105,11 +127,127 @@ nixlXferReqH::updateRequestStats(std::unique_ptr<nixlTelemetry> &telemetry_pub,
                << duration.count() << "us.";
 }
 
+// Pairs continue each other if both sides are back to back, within the same registration
+static inline bool
+continuesPair(const nixlMetaDesc &local_prev, const nixlMetaDesc &remote_prev,
+              const nixlMetaDesc &local_next, const nixlMetaDesc &remote_next) {
+    return (local_prev.addr + local_prev.len == local_next.addr) &
+           (remote_prev.addr + remote_prev.len == remote_next.addr) &
+           (local_prev.metadataP == local_next.metadataP) &
+           (remote_prev.metadataP == remote_next.metadataP) &
+           (local_prev.devId == local_next.devId) &
+           (remote_prev.devId == remote_next.devId);
+}
+
+// Full metadata ends with its version, partial metadata has none. Read before loading, so a
+// new version replaces the loaded metadata instead of adding to it.
+static bool
+trailingMDVersion(std::string_view md, uint64_t &version) {
+    static constexpr std::string_view tag = "MDVer";
+    const size_t field_size = nixlSerDes::fieldSize(tag, sizeof(version));
+    if (md.size() < field_size) {
+        return false;
+    }
+
+    const std::string_view field = md.substr(md.size() - field_size);
+    size_t len;
+    std::memcpy(&len, field.data() + tag.size(), sizeof(len));
+    if ((field.substr(0, tag.size()) != tag) || (len != sizeof(version)) ||
+        (field.back() != '|')) {
+        return false;
+    }
+
+    std::memcpy(&version, field.data() + tag.size() + sizeof(len), sizeof(version));
+    return true;
+}
+
+void
+nixlXferReqH::mergeDescs() {
+    const size_t count = initiatorDescs->descCount();
+    auto local = initiatorDescs->begin();
+    auto remote = targetDescs->begin();
+
+    // Fast path, lists without any pair to merge are left untouched
+    size_t i = 1;
+    while ((i < count) && !continuesPair(local[i - 1], remote[i - 1], local[i], remote[i]))
+        ++i;
+    if (i >= count)
+        return;
+
+    // Pairs are compacted in place from the first merge on
+    size_t j = i - 1;
+    for (; i < count; ++i) {
+        if (continuesPair(local[j], remote[j], local[i], remote[i])) {
+            local[j].len += local[i].len;
+            remote[j].len += remote[i].len;
+        } else {
+            ++j;
+            local[j] = local[i];
+            remote[j] = remote[i];
+        }
+    }
+
+    NIXL_DEBUG << "reqH descList size down to " << j + 1;
+    initiatorDescs->resize(j + 1);
+    targetDescs->resize(j + 1);
+    descsMerged = true;
+}
+
+/*** nixlXferReqPool implementation ***/
+nixlXferReqPool::handle_ptr_t
+nixlXferReqPool::get(const nixl_mem_t &initiator_type, const nixl_mem_t &target_type) {
+    nixlXferReqH *req = nullptr;
+    {
+        const std::lock_guard<std::mutex> guard(lock);
+        if (!cached.empty()) {
+            req = cached.back();
+            cached.pop_back();
+        }
+    }
+
+    if (!req) {
+        req = new nixlXferReqH;
+        req->initiatorDescs = new nixl_meta_dlist_t(initiator_type);
+        req->targetDescs = new nixl_meta_dlist_t(target_type);
+    } else {
+        // Assigning an empty list keeps the capacity of the cached one
+        *req->initiatorDescs = nixl_meta_dlist_t(initiator_type);
+        *req->targetDescs = nixl_meta_dlist_t(target_type);
+    }
+    return handle_ptr_t(req, recycler{this});
+}
+
+void
+nixlXferReqPool::put(nixlXferReqH *req) {
+    if (req->backendHandle) {
+        req->engine->releaseReqH(req->backendHandle);
+        req->backendHandle = nullptr;
+    }
+    req->engine = nullptr;
+    req->remoteAgent.clear();
+    req->remoteEpoch = 0;
+    req->notifMsg.clear();
+    req->hasNotif = false;
+    req->descsMerged = false;
+    req->status = NIXL_ERR_NOT_POSTED;
+    req->telemetry = nixl_xfer_telem_t();
+
+    {
+        const std::lock_guard<std::mutex> guard(lock);
+        if (cached.size() < maxCached) {
+            cached.push_back(req);
+            return;
+        }
+    }
+    delete req;
+}
+
 /*** nixlAgentData constructor/destructor, as part of nixlAgent's ***/
 nixlAgentData::nixlAgentData(const std::string &name, const nixlAgentConfig &cfg)
     : name(name),
       config(cfg),
-      lock(cfg.syncMode) {
+      lock(cfg.syncMode),
+      xferGrace(cfg.syncMode) {
 #if HAVE_ETCD
     if (getenv("NIXL_ETCD_ENDPOINTS")) {
         useEtcd = true;
@@ -125,6 +263,9 @@ nixlAgentData::nixlAgentData(const std::string &name, const nixlAgentConfig &cfg
         throw std::invalid_argument("Agent needs a name");
 
     memorySection = new nixlLocalSection();
+    mdVersion = static_cast<uint64_t>(std::random_device{}()) << 32;
+    mdLogStart = mdVersion;
+
     const char *telemetry_env_val = std::getenv(TELEMETRY_ENABLED_VAR);
     const char *telemetry_env_dir = std::getenv(TELEMETRY_DIR_VAR);
 
@@ -193,6 +334,11 @@ nixlAgent::nixlAgent(const std::string &name, const nixlAgentConfig &cfg) :
     }
 
     if (data->useEtcd || cfg.useListenThread) {
+        data->commEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        data->commEpollFd = epoll_create1(EPOLL_CLOEXEC);
+        if ((data->commEventFd < 0) || (data->commEpollFd < 0))
+            throw std::runtime_error("Failed to create the communication thread event fds");
+
         data->commThreadStop = false;
         data->agentShutdown = false;
         data->commThread = std::thread(&nixlAgentData::commWorker, data.get(), std::ref(*this));
@@ -207,7 +353,10 @@ nixlAgent::~nixlAgent() {
         }
 
         data->commThreadStop = true;
+        eventfd_write(data->commEventFd, 1);
         if(data->commThread.joinable()) data->commThread.join();
+        close(data->commEpollFd);
+        close(data->commEventFd);
 
         try {
             if (data->commThreadException_) {
@@ -423,15 +572,33 @@ nixlAgent::queryMem(const nixl_reg_dlist_t &descs,
     return extra_params->backends[0]->engine->queryMem(descs, resp);
 }
 
+nixl_status_t
+nixlAgent::setBackendPreference(const std::vector<nixlBackendH*> &backends) {
+    backend_list_t preference;
+    for (auto & backend : backends) {
+        if (!backend) {
+            NIXL_ERROR_FUNC << "backend handle is null";
+            return NIXL_ERR_INVALID_PARAM;
+        }
+        preference.push_back(backend->engine);
+    }
+
+    NIXL_LOCK_GUARD(data->lock);
+    data->backendPreference = std::move(preference);
+    data->clearSelectedBackends();
+    return NIXL_SUCCESS;
+}
+
 nixl_status_t
 nixlAgent::registerMem(const nixl_reg_dlist_t &descs,
                        const nixl_opt_args_t* extra_params) {
 
     backend_list_t* backend_list;
+    backend_list_t  registered;
     nixl_status_t   ret;
-    unsigned int    count = 0;
 
     NIXL_LOCK_GUARD(data->lock);
+    data->clearSelectedBackends();
     if (!extra_params || extra_params->backends.size() == 0) {
         backend_list = &data->memToBackend[descs.getType()];
         if (backend_list->empty()) {
@@ -460,11 +627,11 @@ nixlAgent::registerMem(const nixl_reg_dlist_t &descs,
                 ret = data->remoteSections[data->name]->loadLocalData(
                                                         sec_descs, backend);
                 if (ret == NIXL_SUCCESS)
-                    count++;
+                    registered.push_back(backend);
                 else
                     data->memorySection->remDescList(descs, backend);
             } else {
-                count++;
+                registered.push_back(backend);
             }
         } // a bad_ret can be saved in an else
     }
@@ -472,7 +639,8 @@ nixlAgent::registerMem(const nixl_reg_dlist_t &descs,
     if (extra_params && extra_params->backends.size() > 0)
         delete backend_list;
 
-    if (count > 0) {
+    if (!registered.empty()) {
+        data->recordMDChange(descs, registered, false);
         // sum all the sizes of the descriptors using std::accumulate
         if (data->telemetry_) {
             uint64_t total_size = std::accumulate(
@@ -494,9 +662,11 @@ nixlAgent::deregisterMem(const nixl_reg_dlist_t &descs,
 
 
     backend_set_t     backend_set;
+    backend_list_t    deregistered;
     nixl_status_t     ret, bad_ret=NIXL_SUCCESS;
 
     NIXL_LOCK_GUARD(data->lock);
+    data->clearSelectedBackends();
     if (!extra_params || extra_params->backends.size() == 0) {
         backend_set_t* avail_backends;
         avail_backends = data->memorySection->queryBackends(
@@ -517,7 +687,10 @@ nixlAgent::deregisterMem(const nixl_reg_dlist_t &descs,
         ret = data->memorySection->remDescList(descs, backend);
         if (ret != NIXL_SUCCESS)
             bad_ret = ret;
+        else
+            deregistered.push_back(backend);
     }
+    data->recordMDChange(descs, deregistered, true);
     if (bad_ret == NIXL_SUCCESS) {
         if (data->telemetry_) {
             uint64_t total_size = std::accumulate(
@@ -606,6 +779,13 @@ nixlAgent::prepXferDlist (const std::string &agent_name,
         return NIXL_ERR_NOT_FOUND;
     }
 
+    if (!init_side && !data->isRemoteUsable(agent_name)) {
+        NIXL_ERROR_FUNC << "metadata snapshot of remote agent '" << agent_name
+                        << "' is not validated yet";
+        data->addErrorTelemetry(NIXL_ERR_NOT_ALLOWED);
+        return NIXL_ERR_NOT_ALLOWED;
+    }
+
     if (!extra_params || extra_params->backends.size() == 0) {
         if (!init_side)
             backend_set = data->remoteSections[agent_name]->
@@ -634,6 +814,7 @@ nixlAgent::prepXferDlist (const std::string &agent_name,
     } else {
         handle->isLocal     = false;
         handle->remoteAgent = agent_name;
+        handle->remoteEpoch = data->remoteEpoch.load(std::memory_order_acquire);
     }
 
     for (auto & backend : *backend_set) {
@@ -670,39 +851,39 @@ nixlAgent::prepXferDlist (const std::string &agent_name,
 }
 
 nixl_status_t
-nixlAgent::makeXferReq (const nixl_xfer_op_t &operation,
-                        const nixlDlistH* local_side,
-                        const std::vector<int> &local_indices,
-                        const nixlDlistH* remote_side,
-                        const std::vector<int> &remote_indices,
-                        nixlXferReqH* &req_hndl,
-                        const nixl_opt_args_t* extra_params) const {
+nixlAgentData::selectXferPairs(const nixlDlistH* local_side,
+                               const std::vector<int> &local_indices,
+                               const nixlDlistH* remote_side,
+                               const std::vector<int> &remote_indices,
+                               const nixl_opt_args_t* extra_params,
+                               nixlBackendEngine* &backend,
+                               size_t &total_bytes,
+                               uint64_t &remote_epoch) {
 
-    nixl_opt_b_args_t  opt_args;
-    nixl_status_t      ret;
-    int                desc_count = (int) local_indices.size();
-    nixlBackendEngine* backend    = nullptr;
+    int desc_count = (int) local_indices.size();
 
-    req_hndl = nullptr;
+    backend = nullptr;
+    total_bytes = 0;
 
     if (!local_side || !remote_side) {
         NIXL_ERROR_FUNC << "local or remote side handle is null";
-        data->addErrorTelemetry(NIXL_ERR_INVALID_PARAM);
+        addErrorTelemetry(NIXL_ERR_INVALID_PARAM);
         return NIXL_ERR_INVALID_PARAM;
     }
 
     if ((!local_side->isLocal) || (remote_side->isLocal)) {
         NIXL_ERROR_FUNC << "invalid sides (local must be local, remote must be remote)";
-        data->addErrorTelemetry(NIXL_ERR_INVALID_PARAM);
+        addErrorTelemetry(NIXL_ERR_INVALID_PARAM);
         return NIXL_ERR_INVALID_PARAM;
     }
 
-    NIXL_LOCK_GUARD(data->lock);
-    // The remote was invalidated in between prepXferDlist and this call
-    if (data->remoteSections.count(remote_side->remoteAgent) == 0) {
+    // The remote was invalidated, or had descriptors removed, in between prepXferDlist and
+    // this call, so the prepped remote descriptors may refer to freed metadata
+    remote_epoch = remote_side->remoteEpoch;
+    if (!isRemoteValid(remote_side->remoteAgent, remote_epoch)) {
         NIXL_ERROR_FUNC << "remote agent '" << remote_side->remoteAgent
                         << "' was invalidated in between prepXferDlist and this call";
-        data->addErrorTelemetry(NIXL_ERR_NOT_FOUND);
+        addErrorTelemetry(NIXL_ERR_NOT_FOUND);
         return NIXL_ERR_NOT_FOUND;
     }
 
@@ -733,9 +914,8 @@ nixlAgent::makeXferReq (const nixl_xfer_op_t &operation,
         return NIXL_ERR_INVALID_PARAM;
     }
 
-    nixl_meta_dlist_t* local_descs  = local_side->descs.at(backend);
-    nixl_meta_dlist_t* remote_descs = remote_side->descs.at(backend);
-    size_t total_bytes = 0;
+    const nixl_meta_dlist_t* local_descs  = local_side->descs.at(backend);
+    const nixl_meta_dlist_t* remote_descs = remote_side->descs.at(backend);
 
     if ((desc_count == 0) || (remote_indices.size() == 0) ||
         (desc_count != (int)remote_indices.size())) {
@@ -744,108 +924,90 @@ nixlAgent::makeXferReq (const nixl_xfer_op_t &operation,
         return NIXL_ERR_INVALID_PARAM;
     }
 
-    for (int i=0; i<desc_count; ++i) {
-        if ((local_indices[i] >= local_descs->descCount()) || (local_indices[i] < 0)) {
+    // Both checks run over the whole list without early exit, so the compiler can vectorize
+    // them. The failing index is only searched for when reporting an error.
+    const unsigned local_count = local_descs->descCount();
+    const unsigned remote_count = remote_descs->descCount();
+    bool out_of_range = false;
+    for (int i=0; i<desc_count; ++i)
+        out_of_range |= (static_cast<unsigned>(local_indices[i]) >= local_count) |
+                        (static_cast<unsigned>(remote_indices[i]) >= remote_count);
+
+    size_t len_diff = 0;
+    if (!out_of_range) {
+        for (int i=0; i<desc_count; ++i) {
+            const size_t len = (*local_descs)[local_indices[i]].len;
+            len_diff |= len ^ (*remote_descs)[remote_indices[i]].len;
+            total_bytes += len;
+        }
+    }
+
+    for (int i=0; (out_of_range || len_diff) && i<desc_count; ++i) {
+        if (static_cast<unsigned>(local_indices[i]) >= local_count) {
             NIXL_ERROR_FUNC << "local index out of range at index " << i << " with value "
                             << local_indices[i];
             return NIXL_ERR_INVALID_PARAM;
         }
-        if ((remote_indices[i] >= remote_descs->descCount()) || (remote_indices[i] < 0)) {
+        if (static_cast<unsigned>(remote_indices[i]) >= remote_count) {
             NIXL_ERROR_FUNC << "remote index out of range at index " << i << " with value "
                             << remote_indices[i];
             return NIXL_ERR_INVALID_PARAM;
         }
-        if ((*local_descs)[local_indices[i]].len != (*remote_descs)[remote_indices[i]].len) {
+        if (!out_of_range &&
+            (*local_descs)[local_indices[i]].len != (*remote_descs)[remote_indices[i]].len) {
             NIXL_ERROR_FUNC << "length mismatch at index pair " << i << " with local index "
                             << local_indices[i] << " and remote index " << remote_indices[i];
             return NIXL_ERR_INVALID_PARAM;
         }
-        total_bytes += (*local_descs)[local_indices[i]].len;
     }
 
+    return NIXL_SUCCESS;
+}
+
+nixl_status_t
+nixlAgentData::prepPooledXferReq(nixlXferReqPool::handle_ptr_t &handle,
+                                 const nixl_xfer_op_t &operation,
+                                 size_t total_bytes,
+                                 const nixl_opt_args_t* extra_params,
+                                 nixlXferReqH* &req_hndl) {
+    nixl_opt_b_args_t opt_args;
+
     if (extra_params && extra_params->hasNotif) {
         opt_args.notifMsg = extra_params->notifMsg;
         opt_args.hasNotif = true;
     }
 
-    if ((opt_args.hasNotif) && (!backend->supportsNotif())) {
-        NIXL_ERROR_FUNC << "the selected backend '" << backend->getType()
+    if ((opt_args.hasNotif) && (!handle->engine->supportsNotif())) {
+        NIXL_ERROR_FUNC << "the selected backend '" << handle->engine->getType()
                         << "' does not support notifications";
         return NIXL_ERR_BACKEND;
     }
 
-    std::unique_ptr<nixlXferReqH> handle = std::make_unique<nixlXferReqH>();
-    handle->initiatorDescs = new nixl_meta_dlist_t(local_descs->getType(), desc_count);
-
-    handle->targetDescs = new nixl_meta_dlist_t(remote_descs->getType(), desc_count);
-
-    if (extra_params && extra_params->skipDescMerge) {
-        for (int i=0; i<desc_count; ++i) {
-            (*handle->initiatorDescs)[i] =
-                                     (*local_descs)[local_indices[i]];
-            (*handle->targetDescs)[i] =
-                                     (*remote_descs)[remote_indices[i]];
-        }
-    } else {
-        int i = 0, j = 0; //final list size
-        while (i<(desc_count)) {
-            nixlMetaDesc local_desc1  = (*local_descs) [local_indices[i]];
-            nixlMetaDesc remote_desc1 = (*remote_descs)[remote_indices[i]];
-
-            if(i != (desc_count-1) ) {
-                nixlMetaDesc* local_desc2  = &((*local_descs) [local_indices[i+1]]);
-                nixlMetaDesc* remote_desc2 = &((*remote_descs)[remote_indices[i+1]]);
-
-              while (((local_desc1.addr + local_desc1.len) == local_desc2->addr)
-                  && ((remote_desc1.addr + remote_desc1.len) == remote_desc2->addr)
-                  && (local_desc1.metadataP == local_desc2->metadataP)
-                  && (remote_desc1.metadataP == remote_desc2->metadataP)
-                  && (local_desc1.devId == local_desc2->devId)
-                  && (remote_desc1.devId == remote_desc2->devId)) {
-
-                    local_desc1.len += local_desc2->len;
-                    remote_desc1.len += remote_desc2->len;
-
-                    i++;
-                    if(i == (desc_count-1)) break;
-
-                    local_desc2  = &((*local_descs) [local_indices[i+1]]);
-                    remote_desc2 = &((*remote_descs)[remote_indices[i+1]]);
-                }
-            }
-
-            (*handle->initiatorDescs)[j] = local_desc1;
-            (*handle->targetDescs)   [j] = remote_desc1;
-            j++;
-            i++;
-        }
-        NIXL_DEBUG << "reqH descList size down to " << j;
-        handle->initiatorDescs->resize(j);
-        handle->targetDescs->resize(j);
-    }
+    const size_t requested_count = handle->initiatorDescs->descCount();
+    if (!extra_params || !extra_params->skipDescMerge)
+        handle->mergeDescs();
 
-    handle->engine = backend;
-    handle->remoteAgent = remote_side->remoteAgent;
     handle->notifMsg = opt_args.notifMsg;
     handle->hasNotif = opt_args.hasNotif;
     handle->backendOp = operation;
     handle->status = NIXL_ERR_NOT_POSTED;
 
-    if (data->telemetryEnabled) {
+    if (telemetryEnabled) {
         handle->telemetry.totalBytes = total_bytes;
+        handle->telemetry.requestedDescCount = requested_count;
         handle->telemetry.descCount = handle->initiatorDescs->descCount();
     }
 
-    ret = handle->engine->prepXfer (handle->backendOp,
-                                    *handle->initiatorDescs,
-                                    *handle->targetDescs,
-                                    handle->remoteAgent,
-                                    handle->backendHandle,
-                                    &opt_args);
+    const nixl_status_t ret = handle->engine->prepXfer(handle->backendOp,
+                                                       *handle->initiatorDescs,
+                                                       *handle->targetDescs,
+                                                       handle->remoteAgent,
+                                                       handle->backendHandle,
+                                                       &opt_args);
     if (ret != NIXL_SUCCESS) {
-        NIXL_ERROR_FUNC << "backend '" << backend->getType()
+        NIXL_ERROR_FUNC << "backend '" << handle->engine->getType()
                         << "' failed to prepare the transfer request with status " << ret;
-        data->addErrorTelemetry(ret);
+        addErrorTelemetry(ret);
         return ret;
     }
 
@@ -853,6 +1015,154 @@ nixlAgent::makeXferReq (const nixl_xfer_op_t &operation,
     return NIXL_SUCCESS;
 }
 
+nixl_status_t
+nixlAgent::makeXferReq (const nixl_xfer_op_t &operation,
+                        const nixlDlistH* local_side,
+                        const std::vector<int> &local_indices,
+                        const nixlDlistH* remote_side,
+                        const std::vector<int> &remote_indices,
+                        nixlXferReqH* &req_hndl,
+                        const nixl_opt_args_t* extra_params) const {
+
+    nixlBackendEngine* backend = nullptr;
+    size_t total_bytes = 0;
+    uint64_t remote_epoch = 0;
+
+    req_hndl = nullptr;
+
+    NIXL_SHARED_LOCK_GUARD(data->lock);
+    nixl_status_t ret = data->selectXferPairs(local_side, local_indices,
+                                              remote_side, remote_indices,
+                                              extra_params, backend, total_bytes,
+                                              remote_epoch);
+    if (ret != NIXL_SUCCESS)
+        return ret;
+
+    // The pairs go straight into the pooled handle, merged there like a template's
+    const nixl_meta_dlist_t* local_descs  = local_side->descs.at(backend);
+    const nixl_meta_dlist_t* remote_descs = remote_side->descs.at(backend);
+    const int desc_count = (int) local_indices.size();
+
+    auto handle = data->xferReqPool.get(local_descs->getType(), remote_descs->getType());
+    handle->initiatorDescs->resize(desc_count);
+    handle->targetDescs->resize(desc_count);
+    for (int i=0; i<desc_count; ++i) {
+        (*handle->initiatorDescs)[i] = (*local_descs)[local_indices[i]];
+        (*handle->targetDescs)[i] = (*remote_descs)[remote_indices[i]];
+    }
+
+    handle->engine = backend;
+    handle->remoteAgent = remote_side->remoteAgent;
+    handle->remoteEpoch = remote_epoch;
+
+    return data->prepPooledXferReq(handle, operation, total_bytes, extra_params, req_hndl);
+}
+
+nixl_status_t
+nixlAgent::prepXferTemplate (const nixlDlistH* local_side,
+                             const std::vector<int> &local_indices,
+                             const nixlDlistH* remote_side,
+                             const std::vector<int> &remote_indices,
+                             nixlXferTemplateH* &tmpl_hndl,
+                             const nixl_opt_args_t* extra_params) const {
+
+    nixlBackendEngine* backend = nullptr;
+    size_t total_bytes = 0;
+    uint64_t remote_epoch = 0;
+
+    tmpl_hndl = nullptr;
+
+    NIXL_SHARED_LOCK_GUARD(data->lock);
+    const nixl_status_t ret = data->selectXferPairs(local_side, local_indices,
+                                                    remote_side, remote_indices,
+                                                    extra_params, backend, total_bytes,
+                                              remote_epoch);
+    if (ret != NIXL_SUCCESS)
+        return ret;
+
+    const nixl_meta_dlist_t* local_descs  = local_side->descs.at(backend);
+    const nixl_meta_dlist_t* remote_descs = remote_side->descs.at(backend);
+    const int desc_count = (int) local_indices.size();
+
+    auto tmpl = std::make_unique<nixlXferTemplateH>(local_descs->getType(),
+                                                    remote_descs->getType());
+    tmpl->initiatorDescs.resize(desc_count);
+    tmpl->targetDescs.resize(desc_count);
+    for (int i=0; i<desc_count; ++i) {
+        tmpl->initiatorDescs[i] = (*local_descs)[local_indices[i]];
+        tmpl->targetDescs[i] = (*remote_descs)[remote_indices[i]];
+    }
+
+    tmpl->engine = backend;
+    tmpl->totalBytes = total_bytes;
+    tmpl->remoteAgent = remote_side->remoteAgent;
+    tmpl->remoteEpoch = remote_epoch;
+
+    tmpl_hndl = tmpl.release();
+    return NIXL_SUCCESS;
+}
+
+nixl_status_t
+nixlAgent::makeXferReq (const nixl_xfer_op_t &operation,
+                        const nixlXferTemplateH* tmpl_hndl,
+                        const std::vector<bool> &selected,
+                        nixlXferReqH* &req_hndl,
+                        const nixl_opt_args_t* extra_params) const {
+
+    req_hndl = nullptr;
+
+    if (!tmpl_hndl) {
+        NIXL_ERROR_FUNC << "transfer template handle is null";
+        data->addErrorTelemetry(NIXL_ERR_INVALID_PARAM);
+        return NIXL_ERR_INVALID_PARAM;
+    }
+
+    const nixl_meta_dlist_t &local_descs  = tmpl_hndl->initiatorDescs;
+    const nixl_meta_dlist_t &remote_descs = tmpl_hndl->targetDescs;
+    const int desc_count = local_descs.descCount();
+    if (!selected.empty() && (selected.size() != (size_t)desc_count)) {
+        NIXL_ERROR_FUNC << "selection mask size (" << selected.size()
+                        << ") differs from the template size (" << desc_count << ")";
+        return NIXL_ERR_INVALID_PARAM;
+    }
+
+    NIXL_SHARED_LOCK_GUARD(data->lock);
+    // The remote was invalidated or had descriptors removed since the template was prepared
+    uint64_t remote_epoch = tmpl_hndl->remoteEpoch;
+    if (!data->isRemoteValid(tmpl_hndl->remoteAgent, remote_epoch)) {
+        NIXL_ERROR_FUNC << "remote agent '" << tmpl_hndl->remoteAgent
+                        << "' was invalidated after transfer template preparation";
+        data->addErrorTelemetry(NIXL_ERR_NOT_FOUND);
+        return NIXL_ERR_NOT_FOUND;
+    }
+
+    auto handle = data->xferReqPool.get(local_descs.getType(), remote_descs.getType());
+    size_t total_bytes = tmpl_hndl->totalBytes;
+    if (selected.empty()) {
+        *handle->initiatorDescs = local_descs;
+        *handle->targetDescs = remote_descs;
+    } else {
+        total_bytes = 0;
+        for (int i=0; i<desc_count; ++i) {
+            if (!selected[i])
+                continue;
+            handle->initiatorDescs->addDesc(local_descs[i]);
+            handle->targetDescs->addDesc(remote_descs[i]);
+            total_bytes += local_descs[i].len;
+        }
+        if (handle->initiatorDescs->isEmpty()) {
+            NIXL_ERROR_FUNC << "no descriptor pair selected from the transfer template";
+            return NIXL_ERR_INVALID_PARAM;
+        }
+    }
+
+    handle->engine = tmpl_hndl->engine;
+    handle->remoteAgent = tmpl_hndl->remoteAgent;
+    handle->remoteEpoch = remote_epoch;
+
+    return data->prepPooledXferReq(handle, operation, total_bytes, extra_params, req_hndl);
+}
+
 nixl_status_t
 nixlAgent::createXferReq(const nixl_xfer_op_t &operation,
                          const nixl_xfer_dlist_t &local_descs,
@@ -863,8 +1173,6 @@ nixlAgent::createXferReq(const nixl_xfer_op_t &operation,
     nixl_status_t     ret1, ret2;
     nixl_opt_b_args_t opt_args;
 
-    std::unique_ptr<backend_set_t> backend_set = std::make_unique<backend_set_t>();
-
     req_hndl = nullptr;
 
     NIXL_SHARED_LOCK_GUARD(data->lock);
@@ -875,6 +1183,13 @@ nixlAgent::createXferReq(const nixl_xfer_op_t &operation,
         return NIXL_ERR_NOT_FOUND;
     }
 
+    if (!data->isRemoteUsable(remote_agent)) {
+        NIXL_ERROR_FUNC << "metadata snapshot of remote agent '" << remote_agent
+                        << "' is not validated yet";
+        data->addErrorTelemetry(NIXL_ERR_NOT_ALLOWED);
+        return NIXL_ERR_NOT_ALLOWED;
+    }
+
     size_t total_bytes = 0;
     // Check the correspondence between descriptor lists
     if (local_descs.descCount() != remote_descs.descCount()) {
@@ -882,64 +1197,98 @@ nixlAgent::createXferReq(const nixl_xfer_op_t &operation,
                         << ", remote=" << remote_descs.descCount() << ")";
         return NIXL_ERR_INVALID_PARAM;
     }
+    // No early exit, so the compiler can vectorize the comparison
+    size_t len_diff = 0;
     for (int i = 0; i < local_descs.descCount(); ++i) {
+        len_diff |= local_descs[i].len ^ remote_descs[i].len;
+        total_bytes += local_descs[i].len;
+    }
+    for (int i = 0; len_diff && i < local_descs.descCount(); ++i) {
         if (local_descs[i].len != remote_descs[i].len) {
             NIXL_ERROR_FUNC << "length mismatch at index " << i;
             return NIXL_ERR_INVALID_PARAM;
         }
-        total_bytes += local_descs[i].len;
     }
 
+    // TODO: when central KV is supported, add a call to fetchRemoteMD
+
+    auto handle = data->xferReqPool.get(local_descs.getType(), remote_descs.getType());
+    nixlRemoteSection *remote_section = data->remoteSections[remote_agent];
+
+    // The first backend with the required registrations on both sides is selected
+    auto try_backend = [&](nixlBackendEngine *backend) {
+        // If populate fails, it clears the resp before return
+        ret1 = data->memorySection->populate(
+                     local_descs, backend, *handle->initiatorDescs);
+        ret2 = remote_section->populate(
+                     remote_descs, backend, *handle->targetDescs);
+
+        if ((ret1 == NIXL_SUCCESS) && (ret2 == NIXL_SUCCESS)) {
+            NIXL_INFO << "Selected backend: " << backend->getType();
+            handle->engine = backend;
+            return true;
+        }
+        return false;
+    };
+
     if (!extra_params || extra_params->backends.size() == 0) {
         // Finding backends that support the corresponding memories
-        // locally and remotely, and find the common ones.
+        // locally and remotely, and try the common ones in place.
         backend_set_t* local_set =
             data->memorySection->queryBackends(local_descs.getType());
         backend_set_t* remote_set =
-            data->remoteSections[remote_agent]->queryBackends(
-                                                remote_descs.getType());
+            remote_section->queryBackends(remote_descs.getType());
         if (!local_set || !remote_set) {
             NIXL_ERROR_FUNC << "no backends found for local or remote for their "
                                "corresponding memory type";
             return NIXL_ERR_NOT_FOUND;
         }
 
-        for (auto & elm : *local_set)
-            if (remote_set->count(elm) != 0)
-                backend_set->insert(elm);
-
-        if (backend_set->empty()) {
-            NIXL_ERROR_FUNC << "no potential backend found to be able to do the transfer";
-            return NIXL_ERR_NOT_FOUND;
-        }
-    } else {
-        for (auto & elm : extra_params->backends)
-            backend_set->insert(elm->engine);
-    }
-
-    // TODO: when central KV is supported, add a call to fetchRemoteMD
-    // TODO: merge descriptors back to back in memory (like makeXferReq).
-    // TODO [Perf]: Avoid heap allocation on the datapath, maybe use a mem pool
-
-    std::unique_ptr<nixlXferReqH> handle = std::make_unique<nixlXferReqH>();
-    handle->initiatorDescs = new nixl_meta_dlist_t(local_descs.getType());
+        // The backend selected last time for these memory types is very likely to fit again
+        nixlBackendEngine *selected = data->getSelectedBackend(
+                                   remote_agent, local_descs.getType(), remote_descs.getType());
+        if (!selected || !try_backend(selected)) {
+            bool found_common = false;
+            auto is_common = [&](nixlBackendEngine *backend) {
+                return local_set->count(backend) != 0 && remote_set->count(backend) != 0;
+            };
+
+            // Preferred backends first, in the order set by the user, then the others
+            for (auto & backend : data->backendPreference) {
+                if ((backend == selected) || !is_common(backend))
+                    continue;
+                found_common = true;
+                if (try_backend(backend))
+                    break;
+            }
 
-    handle->targetDescs = new nixl_meta_dlist_t(remote_descs.getType());
+            if (!handle->engine) {
+                const auto &preference = data->backendPreference;
+                for (auto & backend : *local_set) {
+                    if ((backend == selected) || !is_common(backend) ||
+                        (std::find(preference.begin(), preference.end(), backend) !=
+                         preference.end()))
+                        continue;
+                    found_common = true;
+                    if (try_backend(backend))
+                        break;
+                }
+            }
 
-    // Currently we loop through and find first local match. Can use a
-    // preference list or more exhaustive search.
-    for (auto & backend : *backend_set) {
-        // If populate fails, it clears the resp before return
-        ret1 = data->memorySection->populate(
-                     local_descs, backend, *handle->initiatorDescs);
-        ret2 = data->remoteSections[remote_agent]->populate(
-                     remote_descs, backend, *handle->targetDescs);
+            if (!found_common && !selected) {
+                NIXL_ERROR_FUNC << "no potential backend found to be able to do the transfer";
+                return NIXL_ERR_NOT_FOUND;
+            }
 
-        if ((ret1 == NIXL_SUCCESS) && (ret2 == NIXL_SUCCESS)) {
-            NIXL_INFO << "Selected backend: " << backend->getType();
-            handle->engine = backend;
-            break;
+            if (handle->engine)
+                data->setSelectedBackend(remote_agent, local_descs.getType(),
+                                         remote_descs.getType(), handle->engine);
         }
+    } else {
+        // Specified backends are tried in the order given by the user
+        for (auto & elm : extra_params->backends)
+            if (try_backend(elm->engine))
+                break;
     }
 
     if (!handle->engine) {
@@ -949,6 +1298,10 @@ nixlAgent::createXferReq(const nixl_xfer_op_t &operation,
         return NIXL_ERR_NOT_FOUND;
     }
 
+    const size_t desc_count = handle->initiatorDescs->descCount();
+    if (extra_params && extra_params->mergeDescs)
+        handle->mergeDescs();
+
     if (extra_params) {
         if (extra_params->hasNotif) {
             opt_args.notifMsg = extra_params->notifMsg;
@@ -967,6 +1320,7 @@ nixlAgent::createXferReq(const nixl_xfer_op_t &operation,
     }
 
     handle->remoteAgent = remote_agent;
+    handle->remoteEpoch = data->remoteEpoch.load(std::memory_order_acquire);
     handle->backendOp = operation;
     handle->status = NIXL_ERR_NOT_POSTED;
     handle->notifMsg = opt_args.notifMsg;
@@ -974,6 +1328,7 @@ nixlAgent::createXferReq(const nixl_xfer_op_t &operation,
 
     if (data->telemetryEnabled) {
         handle->telemetry.totalBytes = total_bytes;
+        handle->telemetry.requestedDescCount = desc_count;
         handle->telemetry.descCount = handle->initiatorDescs->descCount();
     }
 
@@ -1053,13 +1408,19 @@ nixlAgent::postXferReq(nixlXferReqH *req_hndl,
         req_hndl->telemetry.startTime = std::chrono::steady_clock::now();
     }
 
-    NIXL_SHARED_LOCK_GUARD(data->lock);
-    // Check if the remote was invalidated before post/repost
-    if (data->remoteSections.count(req_hndl->remoteAgent) == 0) {
-        NIXL_ERROR_FUNC << "remote agent '" << req_hndl->remoteAgent
-                        << "' was invalidated after transfer request creation";
-        data->addErrorTelemetry(NIXL_ERR_NOT_FOUND);
-        return NIXL_ERR_NOT_FOUND;
+    // While no remote was dropped since the request was made, the read section keeps the
+    // remote metadata the backend handle refers to alive. Otherwise the shared lock does,
+    // after checking if the remote was invalidated before post/repost.
+    nixlGraceGuard grace(data->xferGrace);
+    std::shared_lock<nixlLock> guard(data->lock, std::defer_lock);
+    if (!grace.tryEnter(data->remoteEpoch, req_hndl->remoteEpoch)) {
+        guard.lock();
+        if (!data->isRemoteValid(req_hndl->remoteAgent, req_hndl->remoteEpoch)) {
+            NIXL_ERROR_FUNC << "remote agent '" << req_hndl->remoteAgent
+                            << "' was invalidated after transfer request creation";
+            data->addErrorTelemetry(NIXL_ERR_NOT_FOUND);
+            return NIXL_ERR_NOT_FOUND;
+        }
     }
 
     // We can't repost while a request is in progress
@@ -1072,7 +1433,7 @@ nixlAgent::postXferReq(nixlXferReqH *req_hndl,
         }
 
         if (req_hndl->status == NIXL_ERR_REMOTE_DISCONNECT) {
-            data->invalidateRemoteData(req_hndl->remoteAgent);
+            data->invalidateDisconnected(req_hndl->remoteAgent, grace, guard);
             NIXL_ERROR_FUNC << "remote agent '" << req_hndl->remoteAgent
                             << "' was disconnected after transfer request creation";
             return NIXL_ERR_REMOTE_DISCONNECT;
@@ -1117,7 +1478,7 @@ nixlAgent::postXferReq(nixlXferReqH *req_hndl,
         if (req_hndl->status == NIXL_ERR_REMOTE_DISCONNECT) {
             NIXL_ERROR_FUNC << "remote agent '" << req_hndl->remoteAgent
                             << "' was disconnected after transfer request creation";
-            data->invalidateRemoteData(req_hndl->remoteAgent);
+            data->invalidateDisconnected(req_hndl->remoteAgent, grace, guard);
             return NIXL_ERR_REMOTE_DISCONNECT;
         } else {
             NIXL_ERROR_FUNC << "backend '" << req_hndl->engine->getType()
@@ -1142,21 +1503,26 @@ nixlAgent::postXferReq(nixlXferReqH *req_hndl,
 nixl_status_t
 nixlAgent::getXferStatus (nixlXferReqH *req_hndl) const {
 
-    NIXL_SHARED_LOCK_GUARD(data->lock);
     // If the status is done, no need to recheck and no state changes.
     // Same for users incorrectly recalling this method in error/done.
     if (req_hndl->status == NIXL_IN_PROG) {
-        // Check if the remote was invalidated before completion
-        if (data->remoteSections.count(req_hndl->remoteAgent) == 0) {
-            NIXL_ERROR_FUNC << "remote agent '" << req_hndl->remoteAgent
-                            << "' was invalidated during transfer";
-            return NIXL_ERR_NOT_FOUND;
+        // Same locking as postXferReq
+        nixlGraceGuard grace(data->xferGrace);
+        std::shared_lock<nixlLock> guard(data->lock, std::defer_lock);
+        if (!grace.tryEnter(data->remoteEpoch, req_hndl->remoteEpoch)) {
+            guard.lock();
+            // Check if the remote was invalidated before completion
+            if (!data->isRemoteValid(req_hndl->remoteAgent, req_hndl->remoteEpoch)) {
+                NIXL_ERROR_FUNC << "remote agent '" << req_hndl->remoteAgent
+                                << "' was invalidated during transfer";
+                return NIXL_ERR_NOT_FOUND;
+            }
         }
 
         req_hndl->status = req_hndl->engine->checkXfer(req_hndl->backendHandle);
         if (req_hndl->status < 0) {
             if (req_hndl->status == NIXL_ERR_REMOTE_DISCONNECT) {
-                data->invalidateRemoteData(req_hndl->remoteAgent);
+                data->invalidateDisconnected(req_hndl->remoteAgent, grace, guard);
                 return NIXL_ERR_REMOTE_DISCONNECT;
             } else {
                 NIXL_ERROR_FUNC << "backend '" << req_hndl->engine->getType()
@@ -1226,7 +1592,7 @@ nixlAgent::releaseXferReq(nixlXferReqH *req_hndl) const {
             req_hndl->backendHandle = nullptr;
         }
     }
-    delete req_hndl;
+    data->xferReqPool.put(req_hndl);
     return NIXL_SUCCESS;
 }
 
@@ -1242,6 +1608,12 @@ nixlAgent::createGpuXferReq(const nixlXferReqH &req_hndl, nixlGpuXferReqH &gpu_r
         return NIXL_ERR_INVALID_PARAM;
     }
 
+    if (req_hndl.descsMerged) {
+        NIXL_ERROR_FUNC << "Invalid request handle[" << &req_hndl
+                        << "]: descriptors were merged, GPU descriptor indices would not match";
+        return NIXL_ERR_INVALID_PARAM;
+    }
+
     NIXL_SHARED_LOCK_GUARD(data->lock);
     const auto status = req_hndl.engine->createGpuXferReq(
         *req_hndl.backendHandle, *req_hndl.initiatorDescs, *req_hndl.targetDescs, gpu_req_hndl);
@@ -1352,6 +1724,12 @@ nixlAgent::releasedDlistH (nixlDlistH* dlist_hndl) const {
     return NIXL_SUCCESS;
 }
 
+nixl_status_t
+nixlAgent::releaseXferTemplate (nixlXferTemplateH* tmpl_hndl) const {
+    delete tmpl_hndl;
+    return NIXL_SUCCESS;
+}
+
 nixl_status_t
 nixlAgent::getNotifs(nixl_notifs_t &notif_map,
                      const nixl_opt_args_t* extra_params) {
@@ -1505,16 +1883,97 @@ nixlAgent::getLocalMD (nixl_blob_t &str) const {
     ret = sd.addStr("", "MemSection");
     if (ret) return NIXL_ERR_UNKNOWN;
 
-    ret = data->memorySection->serialize(&sd);
+    ret = data->memorySection->serialize(&sd, data->config.compactMetadata);
     if (ret) {
         NIXL_ERROR_FUNC << "serialization failed";
         return ret;
     }
 
-    str = sd.exportStr();
+    // Trailing field, skipped by agents not loading deltas
+    ret = sd.addBuf("MDVer", &data->mdVersion, sizeof(data->mdVersion));
+    if (ret) return NIXL_ERR_UNKNOWN;
+
+    str = std::move(sd).exportStr();
     return NIXL_SUCCESS;
 }
 
+nixl_status_t
+nixlAgent::getLocalMDDelta(const uint64_t since_version, nixl_blob_t &str) const {
+    nixl_status_t ret;
+
+    {
+        NIXL_LOCK_GUARD(data->lock);
+        if ((since_version >= data->mdLogStart) && (since_version <= data->mdVersion)) {
+            // Net changes per section, descriptors both removed and registered again are
+            // removed first, as their metadata might have changed
+            section_delta_t removed, changed;
+            auto it = std::upper_bound(data->mdChangeLog.begin(),
+                                       data->mdChangeLog.end(),
+                                       since_version,
+                                       [](uint64_t version, const nixlMDChange &change) {
+                                           return version < change.version;
+                                       });
+            for (; it != data->mdChangeLog.end(); ++it) {
+                auto &target = it->removed ? removed[it->section] : changed[it->section];
+                target.insert(target.end(), it->descs.begin(), it->descs.end());
+            }
+
+            auto dedup = [](section_delta_t &delta) {
+                size_t count = 0;
+                for (auto &[sec_key, descs] : delta) {
+                    std::sort(descs.begin(), descs.end());
+                    descs.erase(std::unique(descs.begin(), descs.end()), descs.end());
+                    count += descs.size();
+                }
+                return count;
+            };
+            size_t removed_cnt = dedup(removed);
+            dedup(changed);
+
+            nixlSerDes sd;
+            ret = sd.addStr("Agent", data->name);
+            if (ret) return NIXL_ERR_UNKNOWN;
+            ret = sd.addBuf("MDFrom", &since_version, sizeof(since_version));
+            if (ret) return NIXL_ERR_UNKNOWN;
+
+            // Backends created since since_version need their connection info as well
+            size_t conn_cnt = data->connMD.size();
+            ret = sd.addBuf("Conns", &conn_cnt, sizeof(conn_cnt));
+            if (ret) return NIXL_ERR_UNKNOWN;
+
+            for (auto &c : data->connMD) {
+                ret = sd.addStr("t", c.first);
+                if (ret) break;
+                ret = sd.addStr("c", c.second);
+                if (ret) break;
+            }
+            if (ret) return NIXL_ERR_UNKNOWN;
+
+            ret = sd.addStr("", "MemDelta");
+            if (ret) return NIXL_ERR_UNKNOWN;
+            ret = sd.addBuf("MDVer", &data->mdVersion, sizeof(data->mdVersion));
+            if (ret) return NIXL_ERR_UNKNOWN;
+            ret = sd.addBuf("MDRemoved", &removed_cnt, sizeof(removed_cnt));
+            if (ret) return NIXL_ERR_UNKNOWN;
+
+            ret = data->memorySection->serializeDelta(
+                &sd, removed, changed, data->config.compactMetadata);
+            if (ret) {
+                NIXL_ERROR_FUNC << "serialization failed";
+                return ret;
+            }
+
+            str = std::move(sd).exportStr();
+            return NIXL_SUCCESS;
+        }
+    }
+
+    // Changes since then were dropped from the log, or are from another instance
+    NIXL_DEBUG << "Version " << since_version << " not in the change log of agent "
+               << data->name << ", sending the full metadata";
+    return getLocalMD(str);
+}
+
 nixl_status_t
 nixlAgent::getLocalPartialMD(const nixl_reg_dlist_t &descs,
                              nixl_blob_t &str,
@@ -1584,26 +2043,26 @@ nixlAgent::getLocalPartialMD(const nixl_reg_dlist_t &descs,
     ret = sd.addStr("", "MemSection");
     if (ret) return NIXL_ERR_UNKNOWN;
 
-    ret = data->memorySection->serializePartial(&sd, selected_engines, descs);
+    ret = data->memorySection->serializePartial(
+        &sd, selected_engines, descs, data->config.compactMetadata);
     if (ret) {
         NIXL_ERROR_FUNC << "serialization failed";
         return ret;
     }
 
-    str = sd.exportStr();
+    str = std::move(sd).exportStr();
     return NIXL_SUCCESS;
 }
 
 nixl_status_t
-nixlAgent::loadRemoteMD (const nixl_blob_t &remote_metadata,
-                         std::string &agent_name) {
+nixlAgentData::loadRemoteMD(std::string_view remote_metadata, std::string &agent_name) {
     nixlSerDes sd;
     nixl_blob_t conn_info;
     nixl_backend_t nixl_backend;
     nixl_status_t ret;
 
-    NIXL_LOCK_GUARD(data->lock);
-    ret = sd.importStr(remote_metadata);
+    // Caller keeps remote_metadata alive, no need for a copy
+    ret = sd.importView(remote_metadata);
     if (ret != NIXL_SUCCESS) {
         NIXL_ERROR_FUNC << "failed to deserialize remote metadata";
         return NIXL_ERR_MISMATCH;
@@ -1615,7 +2074,7 @@ nixlAgent::loadRemoteMD (const nixl_blob_t &remote_metadata,
         return NIXL_ERR_MISMATCH;
     }
 
-    if (remote_agent == data->name) {
+    if (remote_agent == name) {
         NIXL_ERROR_FUNC << "remote agent name same as local agent, "
                            "no need to load metadata";
         return NIXL_ERR_INVALID_PARAM;
@@ -1623,6 +2082,32 @@ nixlAgent::loadRemoteMD (const nixl_blob_t &remote_metadata,
 
     NIXL_DEBUG << "Loading remote metadata for agent: " << remote_agent;
 
+    // Deltas give their base version first, any other metadata replaces a snapshot
+    // that was not validated by a delta yet
+    uint64_t from_version = 0;
+    const bool is_delta = sd.hasTag("MDFrom");
+    if (is_delta && (sd.getBuf("MDFrom", &from_version, sizeof(from_version)) != NIXL_SUCCESS)) {
+        NIXL_ERROR_FUNC << "failed to deserialize remote metadata";
+        return NIXL_ERR_MISMATCH;
+    }
+    if (!is_delta && (remoteSnapshots.count(remote_agent) != 0)) {
+        NIXL_DEBUG << "Replacing metadata snapshot of agent " << remote_agent;
+        invalidateRemoteData(remote_agent);
+    }
+
+    // Full metadata of another version replaces the loaded one, as descriptors deregistered
+    // since then are missing from it. Partial metadata only adds to the loaded one.
+    uint64_t full_version;
+    if (!is_delta && (remoteSections.count(remote_agent) != 0) &&
+        trailingMDVersion(remote_metadata, full_version)) {
+        auto it_version = remoteMDVersions.find(remote_agent);
+        if ((it_version == remoteMDVersions.end()) || (it_version->second != full_version)) {
+            NIXL_DEBUG << "Replacing metadata of agent " << remote_agent << " with version "
+                       << full_version;
+            invalidateRemoteData(remote_agent);
+        }
+    }
+
     size_t conn_cnt;
     ret = sd.getBuf("Conns", &conn_cnt, sizeof(conn_cnt));
     if (ret != NIXL_SUCCESS) {
@@ -1640,7 +2125,7 @@ nixlAgent::loadRemoteMD (const nixl_blob_t &remote_metadata,
             return NIXL_ERR_MISMATCH;
         }
 
-        ret = data->loadConnInfo(remote_agent, nixl_backend, conn_info);
+        ret = loadConnInfo(remote_agent, nixl_backend, conn_info);
         if (ret == NIXL_SUCCESS) {
             count++;
         } else if (ret != NIXL_ERR_NOT_SUPPORTED) {
@@ -1655,12 +2140,21 @@ nixlAgent::loadRemoteMD (const nixl_blob_t &remote_metadata,
         return NIXL_ERR_BACKEND;
     }
 
-    if (sd.getStr("") != "MemSection") {
+    const std::string_view section_type = sd.getStrView("");
+    if (is_delta && (section_type == "MemDelta")) {
+        ret = loadRemoteDelta(remote_agent, from_version, sd);
+    } else if (!is_delta && (section_type == "MemSection")) {
+        ret = loadRemoteSections(remote_agent, sd);
+        // Only full metadata has a version, partial metadata leaves the loaded one as is
+        uint64_t version;
+        if ((ret == NIXL_SUCCESS) && sd.hasTag("MDVer") &&
+            (sd.getBuf("MDVer", &version, sizeof(version)) == NIXL_SUCCESS))
+            remoteMDVersions[remote_agent] = version;
+    } else {
         NIXL_ERROR_FUNC << "failed to deserialize remote metadata";
         return NIXL_ERR_MISMATCH;
     }
 
-    ret = data->loadRemoteSections(remote_agent, sd);
     if (ret != NIXL_SUCCESS) {
         NIXL_ERROR_FUNC << "error loading remote metadata for agent '" << remote_agent
                         << "' with status " << ret;
@@ -1671,6 +2165,13 @@ nixlAgent::loadRemoteMD (const nixl_blob_t &remote_metadata,
     return NIXL_SUCCESS;
 }
 
+nixl_status_t
+nixlAgent::loadRemoteMD (const nixl_blob_t &remote_metadata,
+                         std::string &agent_name) {
+    NIXL_LOCK_GUARD(data->lock);
+    return data->loadRemoteMD(remote_metadata, agent_name);
+}
+
 nixl_status_t
 nixlAgent::invalidateRemoteMD(const std::string &remote_agent) {
     NIXL_LOCK_GUARD(data->lock);
@@ -1680,10 +2181,12 @@ nixlAgent::invalidateRemoteMD(const std::string &remote_agent) {
         return NIXL_ERR_INVALID_PARAM;
     }
 
+    data->clearSelectedBackends();
+
     nixl_status_t ret = NIXL_ERR_NOT_FOUND;
+    data->eraseRemoteVersion(remote_agent);
     if (data->remoteSections.count(remote_agent) != 0) {
-        delete data->remoteSections[remote_agent];
-        data->remoteSections.erase(remote_agent);
+        data->dropRemoteSection(remote_agent);
         ret = NIXL_SUCCESS;
     }
 
@@ -1702,6 +2205,150 @@ nixlAgent::invalidateRemoteMD(const std::string &remote_agent) {
     return ret;
 }
 
+nixl_status_t
+nixlAgent::getRemoteMDVersion(const std::string &remote_agent, uint64_t &version) const {
+    NIXL_LOCK_GUARD(data->lock);
+    auto it = data->remoteMDVersions.find(remote_agent);
+    if (it == data->remoteMDVersions.end())
+        return NIXL_ERR_NOT_FOUND;
+
+    version = it->second;
+    return NIXL_SUCCESS;
+}
+
+nixl_status_t
+nixlAgent::saveRemoteMD(const std::string &remote_agent, const std::string &path) const {
+    nixl_blob_t snapshot;
+    nixl_status_t ret;
+
+    {
+        NIXL_LOCK_GUARD(data->lock);
+        auto it = data->remoteSections.find(remote_agent);
+        if ((remote_agent == data->name) || (it == data->remoteSections.end())) {
+            NIXL_ERROR_FUNC << "metadata for remote agent '" << remote_agent << "' not found";
+            return NIXL_ERR_NOT_FOUND;
+        }
+
+        // Same layout as the full metadata sent by the remote agent
+        nixlSerDes sd;
+        ret = sd.addStr("Agent", remote_agent);
+        if (ret) return NIXL_ERR_UNKNOWN;
+
+        auto it_conns = data->remoteBackends.find(remote_agent);
+        size_t conn_cnt = (it_conns == data->remoteBackends.end()) ? 0 : it_conns->second.size();
+        ret = sd.addBuf("Conns", &conn_cnt, sizeof(conn_cnt));
+        if (ret) return NIXL_ERR_UNKNOWN;
+
+        if (conn_cnt > 0) {
+            for (auto &c : it_conns->second) {
+                ret = sd.addStr("t", c.first);
+                if (ret) break;
+                ret = sd.addStr("c", c.second);
+                if (ret) break;
+            }
+            if (ret) return NIXL_ERR_UNKNOWN;
+        }
+
+        ret = sd.addStr("", "MemSection");
+        if (ret) return NIXL_ERR_UNKNOWN;
+
+        ret = it->second->serialize(&sd);
+        if (ret) {
+            NIXL_ERROR_FUNC << "serialization failed";
+            return ret;
+        }
+
+        // Without a version the snapshot is replaced on the next fetch
+        auto it_version = data->remoteMDVersions.find(remote_agent);
+        if (it_version != data->remoteMDVersions.end()) {
+            ret = sd.addBuf("MDVer", &it_version->second, sizeof(it_version->second));
+            if (ret) return NIXL_ERR_UNKNOWN;
+        }
+
+        snapshot = std::move(sd).exportStr();
+    }
+
+    // Written aside and renamed, so loading never sees a partial snapshot
+    const std::string tmp_path = path + ".tmp";
+    int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        NIXL_PERROR << "Failed to create metadata snapshot " << tmp_path;
+        return NIXL_ERR_UNKNOWN;
+    }
+
+    size_t offset = 0;
+    while (offset < snapshot.size()) {
+        const ssize_t written = write(fd, snapshot.data() + offset, snapshot.size() - offset);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            NIXL_PERROR << "Failed to write metadata snapshot " << tmp_path;
+            close(fd);
+            unlink(tmp_path.c_str());
+            return NIXL_ERR_UNKNOWN;
+        }
+        offset += written;
+    }
+
+    if ((close(fd) != 0) || (rename(tmp_path.c_str(), path.c_str()) != 0)) {
+        NIXL_PERROR << "Failed to save metadata snapshot " << path;
+        unlink(tmp_path.c_str());
+        return NIXL_ERR_UNKNOWN;
+    }
+
+    return NIXL_SUCCESS;
+}
+
+nixl_status_t
+nixlAgent::loadRemoteMDSnapshot(const std::string &path,
+                                std::string &agent_name,
+                                bool use_unvalidated) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        NIXL_PERROR << "Failed to open metadata snapshot " << path;
+        return NIXL_ERR_NOT_FOUND;
+    }
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || (st.st_size == 0)) {
+        NIXL_ERROR_FUNC << "empty or unreadable metadata snapshot " << path;
+        close(fd);
+        return NIXL_ERR_MISMATCH;
+    }
+
+    // Deserialized in place, only the pages of the file are read
+    void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        NIXL_PERROR << "Failed to map metadata snapshot " << path;
+        return NIXL_ERR_UNKNOWN;
+    }
+    madvise(addr, st.st_size, MADV_SEQUENTIAL);
+    const std::string_view snapshot(static_cast<const char *>(addr), st.st_size);
+
+    nixl_status_t ret;
+    {
+        NIXL_LOCK_GUARD(data->lock);
+        nixlSerDes sd;
+        std::string remote_agent;
+        if (sd.importView(snapshot) == NIXL_SUCCESS)
+            remote_agent = sd.getStr("Agent");
+
+        if ((data->remoteSections.count(remote_agent) != 0) &&
+            (data->remoteSnapshots.count(remote_agent) == 0)) {
+            NIXL_ERROR_FUNC << "metadata of agent '" << remote_agent << "' is already loaded";
+            ret = NIXL_ERR_NOT_ALLOWED;
+        } else {
+            ret = data->loadRemoteMD(snapshot, agent_name);
+            if (ret == NIXL_SUCCESS)
+                data->remoteSnapshots[agent_name] = use_unvalidated;
+        }
+    }
+
+    munmap(addr, st.st_size);
+    return ret;
+}
+
 nixl_status_t
 nixlAgent::sendLocalMD (const nixl_opt_args_t* extra_params) const {
     nixl_blob_t myMD;
@@ -1711,6 +2358,12 @@ nixlAgent::sendLocalMD (const nixl_opt_args_t* extra_params) const {
         return ret;
     }
 
+    // If peers are provided, fan out to all of them through sockets
+    if (extra_params && !extra_params->peers.empty()) {
+        data->enqueueCommFanout(extra_params->peers, extra_params->fanoutDegree, std::move(myMD));
+        return NIXL_SUCCESS;
+    }
+
     // If IP is provided, use socket-based communication
     if (extra_params && !extra_params->ipAddr.empty()) {
         data->enqueueCommWork(std::make_tuple(SOCK_SEND, extra_params->ipAddr, extra_params->port, std::move(myMD)));
@@ -1742,6 +2395,12 @@ nixlAgent::sendLocalPartialMD(const nixl_reg_dlist_t &descs,
         return ret;
     }
 
+    // If peers are provided, fan out to all of them through sockets
+    if (extra_params && !extra_params->peers.empty()) {
+        data->enqueueCommFanout(extra_params->peers, extra_params->fanoutDegree, std::move(myMD));
+        return NIXL_SUCCESS;
+    }
+
     // If IP is provided, use socket-based communication
     if (extra_params && !extra_params->ipAddr.empty()) {
         data->enqueueCommWork(std::make_tuple(SOCK_SEND, extra_params->ipAddr, extra_params->port, std::move(myMD)));
@@ -1771,7 +2430,7 @@ nixlAgent::fetchRemoteMD (const std::string remote_name,
                           const nixl_opt_args_t* extra_params) {
     // If IP is provided, use socket-based communication
     if (extra_params && !extra_params->ipAddr.empty()) {
-        data->enqueueCommWork(std::make_tuple(SOCK_FETCH, extra_params->ipAddr, extra_params->port, ""));
+        data->enqueueCommWork(std::make_tuple(SOCK_FETCH, extra_params->ipAddr, extra_params->port, remote_name));
         return NIXL_SUCCESS;
     }
 
@@ -1818,7 +2477,7 @@ nixl_status_t
 nixlAgent::checkRemoteMD (const std::string remote_name,
                           const nixl_xfer_dlist_t &descs) const {
     NIXL_LOCK_GUARD(data->lock);
-    if (data->remoteSections.count(remote_name) != 0) {
+    if ((data->remoteSections.count(remote_name) != 0) && data->isRemoteUsable(remote_name)) {
         if (descs.descCount() == 0) {
             return NIXL_SUCCESS;
         } else {
@@ -17,17 +17,22 @@
 
 #include <fcntl.h>
 #include "nixl.h"
-#include "common/nixl_time.h"
 #include "common/str_tools.h"
 #include "agent_data.h"
 #include "common/nixl_log.h"
+#include "serdes/serdes.h"
 #if HAVE_ETCD
 #include <etcd/SyncClient.hpp>
 #include <etcd/Watcher.hpp>
 #include <future>
 #endif // HAVE_ETCD
 #include <absl/strings/str_format.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 
 const std::string default_metadata_label = "metadata";
 
@@ -35,7 +40,10 @@ namespace {
 
 static const std::string invalid_label = "invalid";
 
-int connectToIP(std::string ip_addr, int port) {
+// Starts connecting a non-blocking socket without waiting for the handshake, epoll reports
+// the socket writable once the connection is established or failed
+int
+startConnectToIP(const std::string &ip_addr, int port) {
 
     struct sockaddr_in listenerAddr;
     listenerAddr.sin_port   = htons(port);
@@ -56,130 +64,278 @@ int connectToIP(std::string ip_addr, int port) {
     // Connect will return immediately with EINPROGRESS
     int ret = connect(ret_fd, (struct sockaddr*)&listenerAddr, sizeof(listenerAddr));
     if (ret < 0 && errno != EINPROGRESS) {
+        NIXL_PERROR << "connect failed for ip_addr: " << ip_addr << " and port: " << port;
         close(ret_fd);
         return -1;
     }
 
-    // Use poll to wait for connection with timeout
-    struct pollfd pfd;
-    pfd.fd = ret_fd;
-    pfd.events = POLLOUT;
-    pfd.revents = 0;
+    return ret_fd;
+}
 
-    ret = poll(&pfd, 1, 1000); // 1000ms timeout
-    if (ret <= 0) {
-        if (ret < 0) {
-            NIXL_PERROR << "poll failed for ip_addr: " << ip_addr << " and port: " << port;
-        } else {
-            NIXL_ERROR << "poll timed out for ip_addr: " << ip_addr << " and port: " << port;
-        }
-        close(ret_fd);
-        return -1;
+// Whether a connection started by startConnectToIP was established
+bool
+connectSucceeded(int fd) {
+    int error = 0;
+    socklen_t len = sizeof(error);
+    if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &len) < 0) {
+        return false;
     }
+    return error == 0;
+}
 
-    if (!(pfd.revents & POLLOUT)) {
-        NIXL_ERROR << "poll returned but socket not ready for write for ip_addr: " << ip_addr
-                   << " and port: " << port;
-        close(ret_fd);
-        return -1;
+// Messages waiting to be written to the non-blocking peer sockets. A send only writes what
+// the socket accepts, the rest is written when epoll reports the socket writable again.
+// The body of a message can be shared, so a blob fanned out to many peers is not copied.
+class commSendQueue {
+private:
+    struct commMessage {
+        size_t size;
+        std::string header;
+        std::shared_ptr<const nixl_blob_t> body;
+        size_t sent = 0;
+    };
+
+    std::unordered_map<int, std::deque<commMessage>> queues_;
+    std::vector<int> broken_;
+
+public:
+    // Queues the message without writing it, for sockets that are still connecting
+    void
+    enqueue(int fd, std::string header, std::shared_ptr<const nixl_blob_t> body = nullptr) {
+        const size_t body_size = body ? body->size() : 0;
+        queues_[fd].push_back({header.size() + body_size, std::move(header), std::move(body)});
     }
 
-    // Check if connection was successful
-    int error = 0;
-    socklen_t len = sizeof(error);
-    if (getsockopt(ret_fd, SOL_SOCKET, SO_ERROR, &error, &len) < 0 || error != 0) {
-        NIXL_PERROR << "getsockopt failed for ip_addr: " << ip_addr << " and port: " << port;
-        close(ret_fd);
-        return -1;
+    // Returns true if the message could not be written entirely yet
+    bool
+    send(int fd, std::string header, std::shared_ptr<const nixl_blob_t> body = nullptr) {
+        enqueue(fd, std::move(header), std::move(body));
+        return queues_[fd].size() == 1 ? flush(fd) : true;
     }
 
-    return ret_fd;
-}
+    // Returns true if messages are left for the socket. Sockets that failed are reported
+    // by takeBroken, and whatever was queued for them is discarded.
+    bool
+    flush(int fd) {
+        const auto it = queues_.find(fd);
+        if (it == queues_.end()) {
+            return false;
+        }
 
-void
-sendCommMessage(int fd, const std::string& msg) {
-    size_t size = msg.size();
-    constexpr size_t iov_size = 2;
-    struct iovec iov[iov_size] = {
-        {&size, sizeof(size)},
-        {const_cast<char*>(msg.data()), msg.size()}
-    };
+        auto &queue = it->second;
+        while (!queue.empty()) {
+            auto &msg = queue.front();
+            struct iovec iov[3] = {
+                {&msg.size, sizeof(msg.size)},
+                {msg.header.data(), msg.header.size()},
+                {msg.body ? const_cast<char *>(msg.body->data()) : nullptr,
+                 msg.body ? msg.body->size() : 0}};
+
+            size_t skip = msg.sent;
+            int first = 0;
+            while ((first < 2) && (skip >= iov[first].iov_len)) {
+                skip -= iov[first++].iov_len;
+            }
+            iov[first].iov_base = static_cast<char *>(iov[first].iov_base) + skip;
+            iov[first].iov_len -= skip;
+
+            struct msghdr hdr = {};
+            hdr.msg_iov = iov + first;
+            hdr.msg_iovlen = 3 - first;
+            const auto bytes = sendmsg(fd, &hdr, MSG_NOSIGNAL);
+            if (bytes < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    return true;
+                }
 
-    for (size_t i = 0, offset = 0, sent = 0; i < iov_size;) {
-        auto bytes = send(fd,
-                          static_cast<char *>(iov[i].iov_base) + offset,
-                          iov[i].iov_len - offset,
-                          MSG_NOSIGNAL);
-        if (bytes < 0) {
-            if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK) {
-                continue;
+                NIXL_ERROR << absl::StrFormat(
+                    "commSendQueue::flush(fd=%d) %zu/%zu bytes failed, errno=%d",
+                    fd,
+                    msg.sent,
+                    msg.size + sizeof(msg.size),
+                    errno);
+                queues_.erase(it);
+                broken_.push_back(fd);
+                return false;
             }
 
-            throw std::runtime_error(
-                absl::StrFormat("sendCommMessage(fd=%d, msg=%s) %zu/%zu bytes failed, errno=%d",
-                                fd,
-                                msg.c_str(),
-                                sent,
-                                size + sizeof(size),
-                                errno));
+            msg.sent += bytes;
+            if (msg.sent == msg.size + sizeof(msg.size)) {
+                queue.pop_front();
+            }
         }
 
-        offset += bytes;
-        sent += bytes;
-        if (offset == iov[i].iov_len) {
-            offset = 0;
-            ++i;
-        }
+        queues_.erase(it);
+        return false;
     }
-}
 
-bool
-recvCommMessageType(int fd, void *data, size_t size, bool force = false) {
-    for (size_t received = 0; received < size;) {
-        auto bytes = recv(fd, static_cast<char *>(data) + received, size - received, 0);
-        if (bytes > 0) {
-            received += bytes;
-            continue;
-        }
-        if (bytes == 0 && received == 0 && !force) {
-            return false;
+    // Best effort to write out what is left when the comm thread stops
+    void
+    flushAll(int timeout_ms) {
+        while (!queues_.empty()) {
+            const int fd = queues_.begin()->first;
+            struct pollfd pfd = {fd, POLLOUT, 0};
+            while (flush(fd) && (poll(&pfd, 1, timeout_ms) > 0))
+                ;
+            queues_.erase(fd);
         }
+    }
 
-        if (bytes < 0) {
-            if (errno == EINTR) {
+    void
+    drop(int fd) {
+        queues_.erase(fd);
+    }
+
+    std::vector<int>
+    takeBroken() {
+        return std::move(broken_);
+    }
+};
+
+// Bytes received from the non-blocking peer sockets that do not form a whole message yet.
+// A receive only reads what the socket has now, the rest of a message is read when epoll
+// reports the socket readable again.
+class commRecvBuffer {
+private:
+    // data holds the bytes received in [start, end), and room for more after them
+    struct commPending {
+        std::string data;
+        size_t start = 0;
+        size_t end = 0;
+    };
+
+    static constexpr size_t chunkSize = 64 * 1024;
+    // Room made at once for the rest of a message, larger messages grow the buffer as
+    // they arrive, so a bogus size does not allocate by itself
+    static constexpr size_t maxReserve = 64 * 1024 * 1024;
+
+    std::unordered_map<int, commPending> pending_;
+
+public:
+    // Returns false once the peer closed the connection or the socket failed
+    bool
+    receive(int fd) {
+        auto &pending = pending_[fd];
+        while (true) {
+            size_t want = chunkSize;
+            if (pending.end - pending.start >= sizeof(size_t)) {
+                size_t size;
+                std::memcpy(&size, pending.data.data() + pending.start, sizeof(size));
+                const size_t received = pending.end - pending.start - sizeof(size);
+                if (size > received) {
+                    want = std::clamp(size - received, chunkSize, maxReserve);
+                }
+            }
+            if (pending.data.size() - pending.end < want) {
+                pending.data.resize(std::max(pending.end + want, 2 * pending.data.size()));
+            }
+
+            const auto bytes = recv(fd,
+                                    pending.data.data() + pending.end,
+                                    pending.data.size() - pending.end,
+                                    0);
+            if (bytes > 0) {
+                pending.end += bytes;
                 continue;
             }
+            if (bytes == 0) {
+                return false;
+            }
 
+            if (errno == EINTR) {
+                continue;
+            }
             if (errno == EAGAIN || errno == EWOULDBLOCK) {
-                if (!force && received == 0) {
-                    return false; // nothing to read yet
-                }
+                return true;
+            }
 
-                continue;
+            NIXL_ERROR << absl::StrFormat(
+                "commRecvBuffer::receive(fd=%d) failed with %zu bytes pending, errno=%d",
+                fd,
+                pending.end - pending.start,
+                errno);
+            return false;
+        }
+    }
+
+    // Takes the next whole message received from fd, if any
+    bool
+    next(int fd, std::string &msg) {
+        const auto it = pending_.find(fd);
+        if (it == pending_.end()) {
+            return false;
+        }
+
+        auto &pending = it->second;
+        const size_t avail = pending.end - pending.start;
+        size_t size;
+        if (avail >= sizeof(size)) {
+            std::memcpy(&size, pending.data.data() + pending.start, sizeof(size));
+            if (size <= avail - sizeof(size)) {
+                msg.assign(pending.data, pending.start + sizeof(size), size);
+                pending.start += sizeof(size) + size;
+                return true;
             }
         }
 
-        throw std::runtime_error(
-                absl::StrFormat("recvCommMessage(fd=%d) %zu/%zu bytes failed ret=%d errno=%d",
-                                fd,
-                                received,
-                                size,
-                                bytes,
-                                errno));
+        // Keep only the partial message, and no buffer at all between messages
+        if (avail == 0) {
+            pending_.erase(it);
+        } else if (pending.start != 0) {
+            std::memmove(pending.data.data(), pending.data.data() + pending.start, avail);
+            pending.start = 0;
+            pending.end = avail;
+        }
+        return false;
     }
 
-    return true;
+    void
+    drop(int fd) {
+        pending_.erase(fd);
+    }
+};
+
+void
+epollCtlFd(int epoll_fd, int op, int fd, bool want_write = false) {
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN | EPOLLRDHUP | (want_write ? EPOLLOUT : 0);
+    ev.data.fd = fd;
+    if (epoll_ctl(epoll_fd, op, fd, &ev) < 0) {
+        throw std::runtime_error(
+            absl::StrFormat("epoll_ctl(op=%d, fd=%d) failed, errno=%d", op, fd, errno));
+    }
 }
 
-bool
-recvCommMessage(int fd, std::string &msg) {
-    size_t size;
-    if (!recvCommMessageType(fd, &size, sizeof(size))) {
-        return false;
+// Fan-out peer lists travel as "ip:port,ip:port"
+std::string
+encodeCommPeers(const std::vector<nixl_socket_peer_t> &peers) {
+    std::string encoded;
+    for (const auto &[ip, port] : peers) {
+        if (!encoded.empty()) {
+            encoded += ',';
+        }
+        encoded += ip + ':' + std::to_string(port);
     }
+    return encoded;
+}
 
-    msg.resize(size);
-    return recvCommMessageType(fd, msg.data(), size, true);
+std::vector<nixl_socket_peer_t>
+decodeCommPeers(std::string_view encoded) {
+    std::vector<nixl_socket_peer_t> peers;
+    while (!encoded.empty()) {
+        const size_t end = std::min(encoded.find(','), encoded.size());
+        const std::string_view peer = encoded.substr(0, end);
+        const size_t colon = peer.rfind(':');
+        if (colon != std::string_view::npos) {
+            peers.emplace_back(std::string(peer.substr(0, colon)),
+                               std::atoi(std::string(peer.substr(colon + 1)).c_str()));
+        }
+        encoded.remove_prefix(std::min(end + 1, encoded.size()));
+    }
+    return peers;
 }
 
 #if HAVE_ETCD
@@ -192,6 +348,8 @@ private:
     std::unordered_map<std::string, std::unique_ptr<etcd::Watcher>,
                         std::hash<std::string>, strEqual> agentWatchers;
     std::chrono::microseconds watchTimeout_;
+    // Watcher callbacks run on etcd threads, this wakes the comm thread to process them
+    int wakeupFd_;
 
     // Helper function to create etcd key
     std::string makeKey(const std::string& agent_name,
@@ -203,8 +361,10 @@ private:
 
 public:
     nixlEtcdClient(const std::string &my_agent_name,
+                   int wakeup_fd,
                    const std::chrono::microseconds &timeout = std::chrono::microseconds(5000000))
-        : watchTimeout_(timeout) {
+        : watchTimeout_(timeout),
+          wakeupFd_(wakeup_fd) {
         const char* etcd_endpoints = std::getenv("NIXL_ETCD_ENDPOINTS");
         if (!etcd_endpoints || strlen(etcd_endpoints) == 0) {
             throw std::runtime_error("No etcd endpoints provided");
@@ -405,8 +565,11 @@ public:
             if (event.event_type() == etcd::Event::EventType::DELETE_) {
                 NIXL_DEBUG << "Watcher DELETE: " << event.kv().key()
                            << " (rev " << event.kv().modified_index() << ")";
-                std::lock_guard<std::mutex> lock(invalidated_agents_mutex);
-                invalidated_agents.push_back(agent_name);
+                {
+                    std::lock_guard<std::mutex> lock(invalidated_agents_mutex);
+                    invalidated_agents.push_back(agent_name);
+                }
+                eventfd_write(wakeupFd_, 1);
             } else {
                 NIXL_ERROR << "Watcher for " << event.kv().key() << " received unexpected event from etcd: "
                            << event.event_type();
@@ -455,17 +618,223 @@ nixlAgentData::commWorkerInternal(nixlAgent *myAgent) {
     std::unique_ptr<nixlEtcdClient> etcdClient = nullptr;
     // useEtcd is set in nixlAgent constructor and is true if NIXL_ETCD_ENDPOINTS is set
     if(useEtcd) {
-        etcdClient = std::make_unique<nixlEtcdClient>(name, config.etcdWatchTimeout);
+        etcdClient = std::make_unique<nixlEtcdClient>(name, commEventFd, config.etcdWatchTimeout);
     }
 #endif // HAVE_ETCD
+    // Peers asked for a metadata delta, their next LOAD is the reply
+    std::set<nixl_socket_peer_t> delta_peers;
+    // Reverse of remoteSockets, epoll reports ready sockets by fd
+    std::unordered_map<int, nixl_socket_peer_t> socket_peers;
+    commSendQueue sends;
+    commRecvBuffer recvs;
+
+    // Fan-out group whose head is still being connected to, handed to its next peer if that fails
+    struct fanoutGroup {
+        std::vector<nixl_socket_peer_t> rest;
+        unsigned int degree;
+        std::shared_ptr<const nixl_blob_t> md;
+    };
+    struct pendingConnect {
+        std::chrono::steady_clock::time_point deadline;
+        std::vector<fanoutGroup> groups;
+    };
+    // Outgoing connections not established yet, their messages are queued until they are
+    std::unordered_map<int, pendingConnect> connecting;
+    constexpr auto connect_timeout = std::chrono::seconds(1);
+
+    auto add_peer = [&](const nixl_socket_peer_t &peer, int fd, bool want_write = false) {
+        remoteSockets[peer] = fd;
+        socket_peers[fd] = peer;
+        epollCtlFd(commEpollFd, EPOLL_CTL_ADD, fd, want_write);
+    };
+
+    auto drop_peer = [&](int fd) {
+        const auto peer = socket_peers.find(fd);
+        if (peer == socket_peers.end()) {
+            return;
+        }
+        NIXL_DEBUG << "Peer " << peer->second.first << ":" << peer->second.second
+                   << " closed its connection";
+        epoll_ctl(commEpollFd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        sends.drop(fd);
+        recvs.drop(fd);
+        connecting.erase(fd);
+        delta_peers.erase(peer->second);
+        remoteSockets.erase(peer->second);
+        socket_peers.erase(peer);
+    };
+
+    // Never waits for the handshake, a new connection completes when epoll reports it writable
+    auto get_peer_fd = [&](const nixl_socket_peer_t &peer) {
+        const auto client = remoteSockets.find(peer);
+        if (client != remoteSockets.end()) {
+            return client->second;
+        }
+
+        const int new_client = startConnectToIP(peer.first, peer.second);
+        if (new_client == -1) {
+            NIXL_ERROR << "Listener thread could not connect to IP " << peer.first
+                       << " and port " << peer.second;
+            return -1;
+        }
+        add_peer(peer, new_client, true);
+        connecting[new_client].deadline = std::chrono::steady_clock::now() + connect_timeout;
+        return new_client;
+    };
+
+    // Writes what the socket takes now, epoll reports when it can take the rest
+    auto send_msg = [&](int fd,
+                        std::string header,
+                        std::shared_ptr<const nixl_blob_t> body = nullptr) {
+        if (connecting.count(fd) != 0) {
+            sends.enqueue(fd, std::move(header), std::move(body));
+        } else if (sends.send(fd, std::move(header), std::move(body))) {
+            epollCtlFd(commEpollFd, EPOLL_CTL_MOD, fd, true);
+        }
+    };
+
+    // Send md to the first peer of the group that can be connected to, together with the rest
+    // of the group, which it forwards the same way
+    auto fan_out_group = [&](std::vector<nixl_socket_peer_t> group,
+                             unsigned int degree,
+                             const std::shared_ptr<const nixl_blob_t> &md) {
+        size_t head = 0;
+        int fd = -1;
+        while ((head < group.size()) && ((fd = get_peer_fd(group[head])) == -1)) {
+            head++;
+        }
+        if (fd == -1) {
+            return;
+        }
+
+        std::vector<nixl_socket_peer_t> rest(group.begin() + head + 1, group.end());
+        if (rest.empty()) {
+            send_msg(fd, "NIXLCOMM:LOAD", md);
+        } else {
+            send_msg(fd,
+                     "NIXLCOMM:FWRD" + std::to_string(degree) + "|" + encodeCommPeers(rest) + "|",
+                     md);
+        }
+
+        const auto pending = connecting.find(fd);
+        if (pending != connecting.end()) {
+            pending->second.groups.push_back({std::move(rest), degree, md});
+        }
+    };
+
+    // Split the peers in up to degree groups, each sent to its own head
+    auto fan_out = [&](const std::vector<nixl_socket_peer_t> &peers,
+                       unsigned int degree,
+                       const std::shared_ptr<const nixl_blob_t> &md) {
+        const size_t groups = (degree == 0) ? peers.size() : std::min<size_t>(degree, peers.size());
+        for (size_t group = 0; group < groups; group++) {
+            fan_out_group(std::vector<nixl_socket_peer_t>(
+                              peers.begin() + group * peers.size() / groups,
+                              peers.begin() + (group + 1) * peers.size() / groups),
+                          degree,
+                          md);
+        }
+    };
+
+    // Drops a peer that could not be connected to, its fan-out groups go to their next peer
+    auto connect_failed = [&](int fd) {
+        const auto &peer = socket_peers.at(fd);
+        NIXL_ERROR << "Listener thread could not connect to IP " << peer.first << " and port "
+                   << peer.second;
+        std::vector<fanoutGroup> groups = std::move(connecting.at(fd).groups);
+        drop_peer(fd);
+        for (auto &group : groups) {
+            fan_out_group(std::move(group.rest), group.degree, group.md);
+        }
+    };
+
+    const int listener_fd = config.useListenThread ? listener->getListenerFd() : -1;
+    epollCtlFd(commEpollFd, EPOLL_CTL_ADD, commEventFd);
+    if (listener_fd != -1) {
+        epollCtlFd(commEpollFd, EPOLL_CTL_ADD, listener_fd);
+    }
+
+    constexpr int max_events = 64;
+    struct epoll_event events[max_events];
+    std::vector<std::pair<int, uint32_t>> ready_sockets;
+    std::vector<int> writable_sockets;
 
     while(!(commThreadStop)) {
         std::vector<nixl_comm_req_t> work_queue;
+        bool accept_ready = false;
+
+        // Sleep until a peer sends something, a client connects or work is enqueued, or until
+        // the first pending connection times out
+        int timeout_ms = -1;
+        if (!connecting.empty()) {
+            auto deadline = connecting.begin()->second.deadline;
+            for (const auto &pending : connecting) {
+                deadline = std::min(deadline, pending.second.deadline);
+            }
+            const auto wait = std::chrono::ceil<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            timeout_ms = std::max<int64_t>(wait.count(), 0);
+        }
+        const int num_events = epoll_wait(commEpollFd, events, max_events, timeout_ms);
+        if (num_events < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(absl::StrFormat("epoll_wait failed, errno=%d", errno));
+        }
+
+        ready_sockets.clear();
+        writable_sockets.clear();
+        for (int i = 0; i < num_events; i++) {
+            const int fd = events[i].data.fd;
+            if (fd == commEventFd) {
+                eventfd_t count;
+                eventfd_read(commEventFd, &count);
+            } else if (fd == listener_fd) {
+                accept_ready = true;
+            } else {
+                const uint32_t fd_events = events[i].events;
+                if (connecting.count(fd) != 0) {
+                    // Connection established or failed, nothing can be read before that
+                    if ((fd_events & (EPOLLERR | EPOLLHUP)) || !connectSucceeded(fd)) {
+                        connect_failed(fd);
+                        continue;
+                    }
+                    connecting.erase(fd);
+                }
+                if (fd_events & EPOLLOUT) {
+                    writable_sockets.push_back(fd);
+                }
+                if (fd_events & ~EPOLLOUT) {
+                    ready_sockets.emplace_back(fd, fd_events);
+                }
+            }
+        }
 
-        // first, accept new connections
-        int new_fd = 0;
+        // give up on connections that took too long, as their groups may start new ones
+        std::vector<int> timed_out;
+        const auto now = std::chrono::steady_clock::now();
+        for (const auto &[fd, pending] : connecting) {
+            if (pending.deadline <= now) {
+                timed_out.push_back(fd);
+            }
+        }
+        for (const int fd : timed_out) {
+            connect_failed(fd);
+        }
 
-        while(new_fd != -1 && config.useListenThread) {
+        // first, write out what was blocked on full sockets
+        for (const int fd : writable_sockets) {
+            if (!sends.flush(fd) && (socket_peers.count(fd) != 0)) {
+                epollCtlFd(commEpollFd, EPOLL_CTL_MOD, fd);
+            }
+        }
+
+        // then, accept new connections
+        int new_fd = accept_ready ? 0 : -1;
+
+        while(new_fd != -1) {
             new_fd = listener->acceptClient();
             nixl_socket_peer_t accepted_client;
 
@@ -486,7 +855,6 @@ nixlAgentData::commWorkerInternal(nixlAgent *myAgent) {
                 } else {
                     throw std::runtime_error("getpeername failed");
                 }
-                remoteSockets[accepted_client] = new_fd;
 
                 // make new socket nonblocking
                 int new_flags = fcntl(new_fd, F_GETFL, 0) | O_NONBLOCK;
@@ -494,50 +862,55 @@ nixlAgentData::commWorkerInternal(nixlAgent *myAgent) {
                 if (fcntl(new_fd, F_SETFL, new_flags) == -1)
                     throw std::runtime_error("fcntl accept");
 
+                add_peer(accepted_client, new_fd);
             }
         }
 
         // second, do agent commands
         getCommWork(work_queue);
 
-        for(const auto &request: work_queue) {
+        for(auto &request: work_queue) {
 
             // TODO: req_ip and req_port are relevant only for SOCK_*, need different request structure for ETCD_*
-            const auto &[req_command, req_ip, req_port, my_MD] = request;
+            auto &[req_command, req_ip, req_port, my_MD] = request;
 
             nixl_socket_peer_t req_sock = std::make_pair(req_ip, req_port);
+            int client_fd = -1;
 
-            // use remote IP for socket lookup
-            const auto client = remoteSockets.find(req_sock);
-            int client_fd;
-
-            // not connected
-            if (req_command < SOCK_MAX) {
-                if (client == remoteSockets.end()) {
-                    int new_client = connectToIP(req_ip, req_port);
-                    if (new_client == -1) {
-                        NIXL_ERROR << "Listener thread could not connect to IP " << req_ip
-                                   << " and port " << req_port;
-                        continue;
-                    }
-                    remoteSockets[req_sock] = new_client;
-                    client_fd = new_client;
-                } else {
-                    client_fd = client->second;
+            // use remote IP for socket lookup, connect if needed
+            if ((req_command < SOCK_MAX) && (req_command != SOCK_FANOUT)) {
+                client_fd = get_peer_fd(req_sock);
+                if (client_fd == -1) {
+                    continue;
                 }
             }
 
             switch(req_command) {
             case SOCK_SEND: {
-                sendCommMessage(client_fd, "NIXLCOMM:LOAD" + my_MD);
+                send_msg(client_fd, "NIXLCOMM:LOAD", std::make_shared<const nixl_blob_t>(std::move(my_MD)));
+                break;
+            }
+            case SOCK_FANOUT: {
+                fan_out(decodeCommPeers(req_ip),
+                        req_port,
+                        std::make_shared<const nixl_blob_t>(std::move(my_MD)));
                 break;
             }
             case SOCK_FETCH: {
-                sendCommMessage(client_fd, "NIXLCOMM:SEND");
+                // Only ask for the changes if a version of that agent is loaded
+                const std::string &remote_agent = my_MD;
+                uint64_t version;
+                if (!remote_agent.empty() &&
+                    (myAgent->getRemoteMDVersion(remote_agent, version) == NIXL_SUCCESS)) {
+                    send_msg(client_fd, "NIXLCOMM:DLTA" + std::to_string(version));
+                    delta_peers.insert(req_sock);
+                } else {
+                    send_msg(client_fd, "NIXLCOMM:SEND");
+                }
                 break;
             }
             case SOCK_INVAL: {
-                sendCommMessage(client_fd, "NIXLCOMM:INVL" + name);
+                send_msg(client_fd, "NIXLCOMM:INVL" + name);
                 break;
             }
 #if HAVE_ETCD
@@ -613,53 +986,98 @@ nixlAgentData::commWorkerInternal(nixlAgent *myAgent) {
         }
 
         // third, do remote commands
-        auto socket_iter = remoteSockets.begin();
-        while (socket_iter != remoteSockets.end()) {
+        for (const auto &[fd, fd_events] : ready_sockets) {
+            const auto peer_iter = socket_peers.find(fd);
+            if (peer_iter == socket_peers.end()) {
+                continue;
+            }
+            const nixl_socket_peer_t peer = peer_iter->second;
             std::string commands;
             std::vector<std::string> command_list;
             nixl_status_t ret;
 
-            if (!recvCommMessage(socket_iter->second, commands)) {
-                socket_iter++;
-                continue;
-            }
-
-            command_list = str_split_substr(commands, "NIXLCOMM:");
-
-            for(const auto &command : command_list) {
-
-                if(command.size() < 4) continue;
-
-                // always just 4 chars:
-                std::string header = command.substr(0, 4);
-
-                if(header == "LOAD") {
-                    std::string remote_md = command.substr(4);
-                    std::string remote_agent;
-                    ret = myAgent->loadRemoteMD(remote_md, remote_agent);
-                    if(ret != NIXL_SUCCESS) {
-                        NIXL_ERROR << "loadRemoteMD in listener thread failed for md from peer "
-                                   << socket_iter->first.first << ":" << socket_iter->first.second
-                                   << " with error " << ret;
-                        continue;
+            // Read what the peer sent so far and handle the whole messages in it, a partial
+            // message waits for epoll to report the rest. Drop the peer if it hung up.
+            const bool open = recvs.receive(fd);
+            while (recvs.next(fd, commands)) {
+                command_list = str_split_substr(commands, "NIXLCOMM:");
+
+                for(const auto &command : command_list) {
+
+                    if(command.size() < 4) continue;
+
+                    // always just 4 chars:
+                    std::string header = command.substr(0, 4);
+
+                    if(header == "LOAD") {
+                        std::string remote_md = command.substr(4);
+                        std::string remote_agent;
+                        const bool delta_requested = delta_peers.erase(peer) != 0;
+                        ret = myAgent->loadRemoteMD(remote_md, remote_agent);
+                        if(ret != NIXL_SUCCESS) {
+                            NIXL_ERROR << "loadRemoteMD in listener thread failed for md from peer "
+                                       << peer.first << ":" << peer.second
+                                       << " with error " << ret;
+                            // Loaded version changed since the request, fall back to the full MD
+                            if (delta_requested)
+                                send_msg(fd, "NIXLCOMM:SEND");
+                            continue;
+                        }
+                        // not sure what to do with remote_agent
+                    } else if(header == "FWRD") {
+                        // Fanned out metadata, with the peers this agent forwards it to
+                        const size_t peers_start = command.find('|');
+                        const size_t md_start = command.find('|', peers_start + 1);
+                        if (md_start == std::string::npos) {
+                            NIXL_ERROR << "Received malformed forwarded metadata from peer "
+                                       << peer.first << ":" << peer.second;
+                            continue;
+                        }
+
+                        auto remote_md =
+                            std::make_shared<const nixl_blob_t>(command.substr(md_start + 1));
+                        std::string remote_agent;
+                        ret = myAgent->loadRemoteMD(*remote_md, remote_agent);
+                        if(ret != NIXL_SUCCESS) {
+                            NIXL_ERROR << "loadRemoteMD in listener thread failed for md forwarded by peer "
+                                       << peer.first << ":" << peer.second
+                                       << " with error " << ret;
+                        }
+
+                        const unsigned int degree = std::strtoul(command.c_str() + 4, nullptr, 10);
+                        fan_out(decodeCommPeers(std::string_view(command).substr(
+                                    peers_start + 1, md_start - peers_start - 1)),
+                                degree,
+                                remote_md);
+                    } else if(header == "SEND") {
+                        nixl_blob_t my_MD;
+                        myAgent->getLocalMD(my_MD);
+
+                        send_msg(fd, "NIXLCOMM:LOAD", std::make_shared<const nixl_blob_t>(std::move(my_MD)));
+                    } else if(header == "DLTA") {
+                        const uint64_t since_version = std::strtoull(command.c_str() + 4, nullptr, 10);
+                        nixl_blob_t my_MD;
+                        myAgent->getLocalMDDelta(since_version, my_MD);
+
+                        send_msg(fd, "NIXLCOMM:LOAD", std::make_shared<const nixl_blob_t>(std::move(my_MD)));
+                    } else if(header == "INVL") {
+                        std::string remote_agent = command.substr(4);
+                        myAgent->invalidateRemoteMD(remote_agent);
+                        break;
+                    } else {
+                        NIXL_ERROR << "Received socket message with bad header" + header + " from peer "
+                                   << peer.first << ":" << peer.second;
                     }
-                    // not sure what to do with remote_agent
-                } else if(header == "SEND") {
-                    nixl_blob_t my_MD;
-                    myAgent->getLocalMD(my_MD);
-
-                    sendCommMessage(socket_iter->second, std::string("NIXLCOMM:LOAD" + my_MD));
-                } else if(header == "INVL") {
-                    std::string remote_agent = command.substr(4);
-                    myAgent->invalidateRemoteMD(remote_agent);
-                    break;
-                } else {
-                    NIXL_ERROR << "Received socket message with bad header" + header + " from peer "
-                               << socket_iter->first.first << ":" << socket_iter->first.second;
                 }
             }
 
-            socket_iter++;
+            if (!open || (fd_events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR))) {
+                drop_peer(fd);
+            }
+        }
+
+        for (const int fd : sends.takeBroken()) {
+            drop_peer(fd);
         }
 
 #if HAVE_ETCD
@@ -667,12 +1085,9 @@ nixlAgentData::commWorkerInternal(nixlAgent *myAgent) {
             etcdClient->processInvalidatedAgents(myAgent);
         }
 #endif // HAVE_ETCD
-
-        nixlTime::us_t start = nixlTime::getUs();
-        while( (start + config.lthrDelay) > nixlTime::getUs()) {
-            std::this_thread::yield();
-        }
     }
+
+    sends.flushAll(1000);
 }
 
 void nixlAgentData::enqueueCommWork(nixl_comm_req_t request){
@@ -680,8 +1095,18 @@ void nixlAgentData::enqueueCommWork(nixl_comm_req_t request){
         NIXL_WARN << "Agent shutting down, unable to accept new requests";
         return;
     }
-    std::lock_guard<std::mutex> lock(commLock);
-    commQueue.push_back(std::move(request));
+    {
+        std::lock_guard<std::mutex> lock(commLock);
+        commQueue.push_back(std::move(request));
+    }
+    eventfd_write(commEventFd, 1);
+}
+
+void
+nixlAgentData::enqueueCommFanout(const std::vector<nixl_socket_peer_t> &peers,
+                                 unsigned int degree,
+                                 nixl_blob_t md) {
+    enqueueCommWork(std::make_tuple(SOCK_FANOUT, encodeCommPeers(peers), degree, std::move(md)));
 }
 
 void nixlAgentData::getCommWork(std::vector<nixl_comm_req_t> &req_list){
@@ -726,22 +1151,113 @@ nixlAgentData::loadConnInfo(const std::string &remote_name,
 
 nixl_status_t
 nixlAgentData::loadRemoteSections(const std::string &remote_name, nixlSerDes &sd) {
+    clearSelectedBackends();
     if (remoteSections.count(remote_name) == 0) {
-        remoteSections[remote_name] = new nixlRemoteSection(remote_name);
+        remoteSections[remote_name] = new nixlRemoteSection(remote_name, config.lazyRemoteMD);
     }
 
     const nixl_status_t ret = remoteSections[remote_name]->loadRemoteData(&sd, backendEngines);
     // TODO: can be more graceful, if just the new MD blob was improper
     if (ret != NIXL_SUCCESS) {
-        delete remoteSections[remote_name];
-        remoteSections.erase(remote_name);
+        dropRemoteSection(remote_name);
         remoteBackends.erase(remote_name);
+        eraseRemoteVersion(remote_name);
         return ret;
     }
 
     return NIXL_SUCCESS;
 }
 
+nixl_status_t
+nixlAgentData::loadRemoteDelta(const std::string &remote_name,
+                               uint64_t from_version,
+                               nixlSerDes &sd) {
+    uint64_t version;
+    size_t removed_cnt;
+    if ((sd.getBuf("MDVer", &version, sizeof(version)) != NIXL_SUCCESS) ||
+        (sd.getBuf("MDRemoved", &removed_cnt, sizeof(removed_cnt)) != NIXL_SUCCESS))
+        return NIXL_ERR_MISMATCH;
+
+    // The delta only applies on top of the version it was generated from
+    auto it = remoteMDVersions.find(remote_name);
+    if ((it == remoteMDVersions.end()) || (it->second != from_version) ||
+        (remoteSections.count(remote_name) == 0)) {
+        NIXL_ERROR << "Metadata delta of agent " << remote_name << " from version "
+                   << from_version << " does not apply to the loaded metadata";
+        return NIXL_ERR_MISMATCH;
+    }
+
+    clearSelectedBackends();
+    // Removed descriptors are unloaded right away, once post/status calls that might use
+    // them are done. Requests created before the removal fail from now on.
+    if (removed_cnt > 0)
+        remoteStaleEpochs[remote_name] = retireRemoteEpoch();
+
+    const nixl_status_t ret = remoteSections[remote_name]->loadRemoteDelta(&sd, backendEngines);
+    if (ret != NIXL_SUCCESS) {
+        dropRemoteSection(remote_name);
+        remoteBackends.erase(remote_name);
+        eraseRemoteVersion(remote_name);
+        return ret;
+    }
+
+    it->second = version;
+    remoteSnapshots.erase(remote_name);
+    return NIXL_SUCCESS;
+}
+
+void
+nixlAgentData::eraseRemoteVersion(const std::string &remote_name) {
+    remoteMDVersions.erase(remote_name);
+    remoteSnapshots.erase(remote_name);
+}
+
+void
+nixlAgentData::dropRemoteSection(const std::string &remote_name) {
+    auto it = remoteSections.find(remote_name);
+    if (it == remoteSections.end()) {
+        return;
+    }
+
+    remoteStaleEpochs[remote_name] = retireRemoteEpoch();
+    delete it->second;
+    remoteSections.erase(it);
+}
+
+uint64_t
+nixlAgentData::retireRemoteEpoch() {
+    const uint64_t epoch = remoteEpoch.fetch_add(1) + 1;
+    xferGrace.synchronize();
+    return epoch;
+}
+
+void
+nixlAgentData::recordMDChange(const nixl_reg_dlist_t &descs,
+                              const backend_list_t &backends,
+                              bool removed) {
+    bool published = false;
+    for (const auto &backend : backends) {
+        if (!backend->supportsRemote())
+            continue;
+        if (!published) {
+            ++mdVersion;
+            published = true;
+        }
+
+        nixlMDChange change{mdVersion, std::make_pair(descs.getType(), backend), removed, {}};
+        change.descs.assign(descs.begin(), descs.end());
+        mdChangeLogDescs += change.descs.size();
+        mdChangeLog.push_back(std::move(change));
+    }
+
+    // Peers behind the dropped changes get the full metadata
+    while ((mdChangeLogDescs > mdChangeLogMax) && !mdChangeLog.empty()) {
+        mdLogStart = mdChangeLog.front().version;
+        mdChangeLogDescs -= mdChangeLog.front().descs.size();
+        mdChangeLog.pop_front();
+    }
+}
+
 nixl_status_t
 nixlAgentData::invalidateRemoteData(const std::string &remote_name) {
     if (remote_name == name) {
@@ -749,11 +1265,12 @@ nixlAgentData::invalidateRemoteData(const std::string &remote_name) {
         return NIXL_ERR_INVALID_PARAM;
     }
 
+    clearSelectedBackends();
+
     nixl_status_t ret = NIXL_ERR_NOT_FOUND;
-    auto it_section = remoteSections.find(remote_name);
-    if (it_section != remoteSections.end()) {
-        delete it_section->second;
-        remoteSections.erase(it_section);
+    eraseRemoteVersion(remote_name);
+    if (remoteSections.count(remote_name) != 0) {
+        dropRemoteSection(remote_name);
         ret = NIXL_SUCCESS;
     }
 
@@ -769,3 +1286,75 @@ nixlAgentData::invalidateRemoteData(const std::string &remote_name) {
 
     return ret;
 }
+
+bool
+nixlAgentData::isRemoteUsable(const std::string &remote_name) const {
+    const auto it = remoteSnapshots.find(remote_name);
+    return (it == remoteSnapshots.end()) || it->second;
+}
+
+bool
+nixlAgentData::isRemoteValid(const std::string &remote_name, uint64_t &seen_epoch) {
+    // Sections are only dropped under the exclusive lock, after the epoch was bumped
+    // and the readers of the older epoch left
+    const uint64_t epoch = remoteEpoch.load(std::memory_order_acquire);
+    if (seen_epoch == epoch) {
+        return true;
+    }
+
+    if (remoteSections.count(remote_name) == 0) {
+        return false;
+    }
+    // The remote might have been dropped and loaded again, or had descriptors removed
+    auto it_stale = remoteStaleEpochs.find(remote_name);
+    if ((it_stale != remoteStaleEpochs.end()) && (seen_epoch < it_stale->second)) {
+        return false;
+    }
+    seen_epoch = epoch;
+    return true;
+}
+
+nixlBackendEngine*
+nixlAgentData::getSelectedBackend(const std::string &remote_name,
+                                  nixl_mem_t local_mem,
+                                  nixl_mem_t remote_mem) {
+    const std::lock_guard<std::mutex> guard(backendSelectionLock);
+    auto it = backendSelection.find(remote_name);
+    if (it == backendSelection.end()) {
+        return nullptr;
+    }
+    return it->second[local_mem * (FILE_SEG + 1) + remote_mem];
+}
+
+void
+nixlAgentData::setSelectedBackend(const std::string &remote_name,
+                                  nixl_mem_t local_mem,
+                                  nixl_mem_t remote_mem,
+                                  nixlBackendEngine *backend) {
+    const std::lock_guard<std::mutex> guard(backendSelectionLock);
+    auto it = backendSelection.find(remote_name);
+    if (it == backendSelection.end()) {
+        it = backendSelection.emplace(remote_name, backend_sel_t{}).first;
+    }
+    it->second[local_mem * (FILE_SEG + 1) + remote_mem] = backend;
+}
+
+void
+nixlAgentData::clearSelectedBackends() {
+    const std::lock_guard<std::mutex> guard(backendSelectionLock);
+    backendSelection.clear();
+}
+
+void
+nixlAgentData::invalidateDisconnected(const std::string &remote_name,
+                                      nixlGraceGuard &grace,
+                                      std::shared_lock<nixlLock> &guard) {
+    // Leave the read section first, the invalidation waits for it to be empty
+    grace.release();
+    if (guard.owns_lock()) {
+        guard.unlock();
+    }
+
+    NIXL_LOCK_GUARD(lock);
+    invalidateRemoteData(remote_name);
+}
@@ -19,63 +19,163 @@
 #include "common/util.h"
 #include "nixl_params.h"
 #include "absl/synchronization/mutex.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <shared_mutex>
+#include <thread>
 
+// The sync mode is fixed for the lifetime of an agent, so every call is a well predicted
+// branch to the absl::Mutex call (or to nothing in NIXL_THREAD_SYNC_NONE), inlined at the
+// call site instead of an indirect call through a stored callback.
 class nixlLock {
     public:
-        nixlLock(const nixl_thread_sync_t sync_mode) {
-            switch (sync_mode) {
+        explicit nixlLock(const nixl_thread_sync_t sync_mode) : mode(sync_mode) {}
+
+        void lock() {
+            if (mode != nixl_thread_sync_t::NIXL_THREAD_SYNC_NONE) {
+                m.Lock();
+            }
+        }
+
+        void lock_shared() {
+            switch (mode) {
             case nixl_thread_sync_t::NIXL_THREAD_SYNC_NONE:
-                lock_cb = unlock_cb = lock_shared_cb = unlock_shared_cb = []() {};
                 break;
             case nixl_thread_sync_t::NIXL_THREAD_SYNC_STRICT:
-                lock_cb = lock_shared_cb = [this]() {
-                    m.Lock();
-                };
-                unlock_cb = unlock_shared_cb = [this]() {
-                    m.Unlock();
-                };
+                m.Lock();
                 break;
             case nixl_thread_sync_t::NIXL_THREAD_SYNC_RW:
-                lock_cb = [this]() {
-                    m.Lock();
-                };
-                unlock_cb = [this]() {
-                    m.Unlock();
-                };
-                lock_shared_cb = [this]() {
-                    m.ReaderLock();
-                };
-                unlock_shared_cb = [this]() {
-                    m.ReaderUnlock();
-                };
+                m.ReaderLock();
                 break;
             }
         }
 
-        void lock() {
-            lock_cb();
+        void unlock() {
+            if (mode != nixl_thread_sync_t::NIXL_THREAD_SYNC_NONE) {
+                m.Unlock();
+            }
         }
 
-        void lock_shared() {
-            lock_shared_cb();
+        void unlock_shared() {
+            switch (mode) {
+            case nixl_thread_sync_t::NIXL_THREAD_SYNC_NONE:
+                break;
+            case nixl_thread_sync_t::NIXL_THREAD_SYNC_STRICT:
+                m.Unlock();
+                break;
+            case nixl_thread_sync_t::NIXL_THREAD_SYNC_RW:
+                m.ReaderUnlock();
+                break;
+            }
         }
 
-        void unlock() {
-            unlock_cb();
+    private:
+        const nixl_thread_sync_t mode;
+
+        absl::Mutex m;
+};
+
+// Lets readers use memory that writers free, without taking the agent lock. A reader
+// enters a section and re-checks an epoch the writer bumps before freeing. The writer
+// then waits for the readers that entered before the bump, new ones see the new epoch
+// and fall back to the lock. Only used in NIXL_THREAD_SYNC_RW, NIXL_THREAD_SYNC_NONE
+// has no concurrent writers and NIXL_THREAD_SYNC_STRICT always takes the lock.
+class nixlGracePeriod {
+    public:
+        explicit nixlGracePeriod(const nixl_thread_sync_t sync_mode) : mode(sync_mode) {}
+
+        // Enters a read section if epoch still equals seen_epoch, returns false otherwise
+        bool tryEnter(const std::atomic<uint64_t> &epoch, uint64_t seen_epoch, unsigned &token) {
+            switch (mode) {
+            case nixl_thread_sync_t::NIXL_THREAD_SYNC_NONE:
+                return epoch.load(std::memory_order_acquire) == seen_epoch;
+            case nixl_thread_sync_t::NIXL_THREAD_SYNC_STRICT:
+                return false;
+            case nixl_thread_sync_t::NIXL_THREAD_SYNC_RW:
+                break;
+            }
+
+            // seq_cst against the epoch bump and counter scan in synchronize: either the
+            // writer sees this reader, or this reader sees the new epoch
+            token = ((phase.load() & 1) * numStripes) + stripe();
+            counters[token].value.fetch_add(1);
+            if (epoch.load() == seen_epoch) {
+                return true;
+            }
+            exit(token);
+            return false;
         }
 
-        void unlock_shared() {
-            unlock_shared_cb();
+        void exit(unsigned token) {
+            if (mode == nixl_thread_sync_t::NIXL_THREAD_SYNC_RW) {
+                counters[token].value.fetch_sub(1, std::memory_order_release);
+            }
+        }
+
+        // Waits for the readers that entered before the epoch was bumped. Called after the
+        // bump, under the exclusive lock, so writers do not race on the phase.
+        void synchronize() {
+            if (mode != nixl_thread_sync_t::NIXL_THREAD_SYNC_RW) {
+                return;
+            }
+
+            // New readers go to the other phase, so the wait cannot be starved
+            const unsigned old_phase = phase.fetch_add(1) & 1;
+            for (unsigned i = 0; i < numStripes; ++i) {
+                auto &counter = counters[(old_phase * numStripes) + i].value;
+                while (counter.load() != 0) {
+                    std::this_thread::yield();
+                }
+            }
         }
 
     private:
-        std::function<void()> lock_cb;
-        std::function<void()> unlock_cb;
-        std::function<void()> lock_shared_cb;
-        std::function<void()> unlock_shared_cb;
+        static constexpr unsigned numStripes = 32;
 
-        absl::Mutex m;
+        struct alignas(64) stripeCounter {
+            std::atomic<uint64_t> value{0};
+        };
+
+        static unsigned stripe() {
+            static thread_local const unsigned s =
+                std::hash<std::thread::id>{}(std::this_thread::get_id()) % numStripes;
+            return s;
+        }
+
+        const nixl_thread_sync_t mode;
+        std::atomic<unsigned> phase{0};
+        std::array<stripeCounter, 2 * numStripes> counters;
+};
+
+// Leaves the read section of a nixlGracePeriod on scope exit
+class nixlGraceGuard {
+    public:
+        explicit nixlGraceGuard(nixlGracePeriod &grace_period) : gp(grace_period) {}
+        nixlGraceGuard(const nixlGraceGuard &) = delete;
+        nixlGraceGuard &operator=(const nixlGraceGuard &) = delete;
+
+        ~nixlGraceGuard() {
+            release();
+        }
+
+        bool tryEnter(const std::atomic<uint64_t> &epoch, uint64_t seen_epoch) {
+            entered = gp.tryEnter(epoch, seen_epoch, token);
+            return entered;
+        }
+
+        void release() {
+            if (entered) {
+                gp.exit(token);
+                entered = false;
+            }
+        }
+
+    private:
+        nixlGracePeriod &gp;
+        unsigned token = 0;
+        bool entered = false;
 };
 
 #define NIXL_LOCK_GUARD(lock) const std::lock_guard<nixlLock> UNIQUE_NAME(lock_guard) (lock)
@@ -14,6 +14,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <array>
 #include <chrono>
 #include <sstream>
 #include <thread>
@@ -33,9 +34,21 @@ namespace fs = std::filesystem;
 
 constexpr std::chrono::milliseconds DEFAULT_TELEMETRY_RUN_INTERVAL = 100ms;
 constexpr size_t DEFAULT_TELEMETRY_BUFFER_SIZE = 4096;
+constexpr size_t DEFAULT_TELEMETRY_THREAD_EVENTS = 1024;
+constexpr size_t DEFAULT_TELEMETRY_HIST_SLOTS = 64;
+
+namespace {
+uint64_t
+nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+} // namespace
 
 nixlTelemetry::nixlTelemetry(const std::string &file_path, backend_map_t &backend_map)
-    : pool_(1),
+    : events_(DEFAULT_TELEMETRY_THREAD_EVENTS),
+      pool_(1),
       writeTask_(pool_.get_executor(), DEFAULT_TELEMETRY_RUN_INTERVAL, false),
       file_(file_path),
       backendMap_(backend_map) {
@@ -81,6 +94,13 @@ nixlTelemetry::initializeTelemetry() {
     buffer_ = std::make_unique<sharedRingBuffer<nixlTelemetryEvent>>(
         full_file_path, true, TELEMETRY_VERSION, buffer_size);
 
+    auto hist_slots = std::getenv(TELEMETRY_HIST_SLOTS_VAR) ?
+        std::stoul(std::getenv(TELEMETRY_HIST_SLOTS_VAR)) :
+        DEFAULT_TELEMETRY_HIST_SLOTS;
+
+    histograms_ = std::make_unique<sharedLatencyHistograms>(
+        full_file_path.string() + TELEMETRY_HIST_SUFFIX, true, hist_slots);
+
     auto run_interval = std::getenv(TELEMETRY_RUN_INTERVAL_VAR) ?
         std::chrono::milliseconds(std::stoul(std::getenv(TELEMETRY_RUN_INTERVAL_VAR))) :
         DEFAULT_TELEMETRY_RUN_INTERVAL;
@@ -92,38 +112,76 @@ nixlTelemetry::initializeTelemetry() {
     registerPeriodicTask(writeTask_);
 }
 
+void
+nixlTelemetry::writeCounters(uint64_t timestamp_us) {
+    const auto totals = events_.counters();
+    nixlTelemetryQueue::counters_t delta;
+    for (size_t i = 0; i < delta.size(); ++i) {
+        delta[i] = totals[i] - writtenCounters_[i];
+    }
+    writtenCounters_ = totals;
+
+    std::array<nixlTelemetryEvent, 6> events;
+    size_t count = 0;
+    auto add = [&](const char *name, nixl_telemetry_category_t category, uint64_t value) {
+        events[count++] = nixlTelemetryEvent(timestamp_us, category, name, value);
+    };
+
+    if (delta[TX_BYTES] || delta[TX_REQUESTS]) {
+        add("agent_tx_bytes", nixl_telemetry_category_t::NIXL_TELEMETRY_TRANSFER, delta[TX_BYTES]);
+    }
+    if (delta[TX_REQUESTS]) {
+        add("agent_tx_requests_num",
+            nixl_telemetry_category_t::NIXL_TELEMETRY_TRANSFER,
+            delta[TX_REQUESTS]);
+    }
+    if (delta[RX_BYTES] || delta[RX_REQUESTS]) {
+        add("agent_rx_bytes", nixl_telemetry_category_t::NIXL_TELEMETRY_TRANSFER, delta[RX_BYTES]);
+    }
+    if (delta[RX_REQUESTS]) {
+        add("agent_rx_requests_num",
+            nixl_telemetry_category_t::NIXL_TELEMETRY_TRANSFER,
+            delta[RX_REQUESTS]);
+    }
+    // Times are written as the mean over the interval
+    if (delta[XFER_COUNT]) {
+        add("agent_xfer_time",
+            nixl_telemetry_category_t::NIXL_TELEMETRY_PERFORMANCE,
+            delta[XFER_TIME] / delta[XFER_COUNT]);
+    }
+    if (delta[POST_COUNT]) {
+        add("agent_xfer_post_time",
+            nixl_telemetry_category_t::NIXL_TELEMETRY_PERFORMANCE,
+            delta[POST_TIME] / delta[POST_COUNT]);
+    }
+
+    // if full, ignore
+    buffer_->push_n(events.data(), count);
+}
+
 bool
 nixlTelemetry::writeEventHelper() {
-    std::vector<nixlTelemetryEvent> next_queue;
-    // assume next buffer will be the same size as the current one
-    next_queue.reserve(buffer_->capacity());
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        events_.swap(next_queue);
-    }
-    for (auto &event : next_queue) {
+    writeCounters(nowUs());
+
+    // Events are copied once, from the thread buffers they were recorded into to the shared
+    // buffer, merged by timestamp on the way. Agent events are written before backend ones.
+    events_.collect(drainCursors_);
+    nixlTelemetryQueue::merge(drainCursors_, [this](nixlTelemetryEvent *events, size_t count) {
         // if full, ignore
-        buffer_->push(event);
-    }
-    // collect all events and sort them by timestamp
-    std::vector<nixlTelemetryEvent> all_events;
+        buffer_->push_n(events, count);
+    });
+
     for (auto &backend : backendMap_) {
-        auto backend_events = backend.second->getTelemetryEvents();
-        for (auto &event : backend_events) {
-            // don't trust enum value coming from backend,
-            // as it might be different from the one in agent
-            event.category_ = nixl_telemetry_category_t::NIXL_TELEMETRY_BACKEND;
-            all_events.push_back(event);
-        }
-    }
-    std::sort(all_events.begin(),
-              all_events.end(),
-              [](const nixlTelemetryEvent &a, const nixlTelemetryEvent &b) {
-                  return a.timestampUs_ < b.timestampUs_;
-              });
-    for (auto &event : all_events) {
-        buffer_->push(event);
+        backend.second->collectTelemetryEvents(drainCursors_);
     }
+    nixlTelemetryQueue::merge(drainCursors_, [this](nixlTelemetryEvent *events, size_t count) {
+        // don't trust enum value coming from backend,
+        // as it might be different from the one in agent
+        for (size_t i = 0; i < count; ++i) {
+            events[i].category_ = nixl_telemetry_category_t::NIXL_TELEMETRY_BACKEND;
+        }
+        buffer_->push_n(events, count);
+    });
     return true;
 }
 
@@ -148,39 +206,29 @@ void
 nixlTelemetry::updateData(const std::string &event_name,
                           nixl_telemetry_category_t category,
                           uint64_t value) {
-    // agent can be multi-threaded
-    std::lock_guard<std::mutex> lock(mutex_);
-    events_.emplace_back(std::chrono::duration_cast<std::chrono::microseconds>(
-                             std::chrono::system_clock::now().time_since_epoch())
-                             .count(),
-                         category,
-                         event_name,
-                         value);
+    // agent can be multi-threaded, each thread records into its own buffer
+    events_.push(nixlTelemetryEvent(nowUs(), category, event_name, value));
 }
 
 // The next 4 methods might be removed, as addXferTime covers them.
 void
 nixlTelemetry::updateTxBytes(uint64_t tx_bytes) {
-    updateData("agent_tx_bytes", nixl_telemetry_category_t::NIXL_TELEMETRY_TRANSFER, tx_bytes);
+    events_.add(TX_BYTES, tx_bytes);
 }
 
 void
 nixlTelemetry::updateRxBytes(uint64_t rx_bytes) {
-    updateData("agent_rx_bytes", nixl_telemetry_category_t::NIXL_TELEMETRY_TRANSFER, rx_bytes);
+    events_.add(RX_BYTES, rx_bytes);
 }
 
 void
 nixlTelemetry::updateTxRequestsNum(uint32_t tx_requests_num) {
-    updateData("agent_tx_requests_num",
-               nixl_telemetry_category_t::NIXL_TELEMETRY_TRANSFER,
-               tx_requests_num);
+    events_.add(TX_REQUESTS, tx_requests_num);
 }
 
 void
 nixlTelemetry::updateRxRequestsNum(uint32_t rx_requests_num) {
-    updateData("agent_rx_requests_num",
-               nixl_telemetry_category_t::NIXL_TELEMETRY_TRANSFER,
-               rx_requests_num);
+    events_.add(RX_REQUESTS, rx_requests_num);
 }
 
 void
@@ -205,35 +253,36 @@ nixlTelemetry::updateMemoryDeregistered(uint64_t memory_deregistered) {
 
 void
 nixlTelemetry::addXferTime(std::chrono::microseconds xfer_time, bool is_write, uint64_t bytes) {
-    std::string bytes_name;
-    std::string requests_name;
-
-    if (is_write) {
-        bytes_name = "agent_tx_bytes";
-        requests_name = "agent_tx_requests_num";
-    } else {
-        bytes_name = "agent_rx_bytes";
-        requests_name = "agent_rx_requests_num";
-    }
-    auto time = std::chrono::duration_cast<std::chrono::microseconds>(
-                    std::chrono::system_clock::now().time_since_epoch())
-                    .count();
-    std::lock_guard<std::mutex> lock(mutex_);
-    events_.emplace_back(time,
-                         nixl_telemetry_category_t::NIXL_TELEMETRY_PERFORMANCE,
-                         "agent_xfer_time",
-                         xfer_time.count());
-    events_.emplace_back(
-        time, nixl_telemetry_category_t::NIXL_TELEMETRY_TRANSFER, bytes_name.c_str(), bytes);
-    events_.emplace_back(
-        time, nixl_telemetry_category_t::NIXL_TELEMETRY_TRANSFER, requests_name.c_str(), 1);
+    events_.add(is_write ? TX_BYTES : RX_BYTES, bytes);
+    events_.add(is_write ? TX_REQUESTS : RX_REQUESTS, 1);
+    events_.add(XFER_TIME, xfer_time.count());
+    events_.add(XFER_COUNT, 1);
 }
 
 void
 nixlTelemetry::addPostTime(std::chrono::microseconds post_time) {
-    updateData("agent_xfer_post_time",
-               nixl_telemetry_category_t::NIXL_TELEMETRY_PERFORMANCE,
-               post_time.count());
+    events_.add(POST_TIME, post_time.count());
+    events_.add(POST_COUNT, 1);
+}
+
+nixlTelemetryHistSlot *
+nixlTelemetry::histogram(const nixl_backend_t &backend,
+                         const std::string &remote_agent,
+                         nixl_xfer_op_t op) {
+    std::lock_guard<std::mutex> lock(histogramsLock_);
+    auto it = histogramSlots_.find(std::tie(backend, remote_agent, op));
+    if (it != histogramSlots_.end()) {
+        return it->second;
+    }
+
+    nixlTelemetryHistSlot *slot = histograms_->addSlot(backend, remote_agent, op);
+    if (!slot) {
+        NIXL_WARN << "Telemetry histograms full, not recording latencies of " << backend
+                  << " transfers to '" << remote_agent << "'";
+    }
+    // Also remember misses, so the warning is printed once
+    histogramSlots_.emplace(std::make_tuple(backend, remote_agent, op), slot);
+    return slot;
 }
 
 std::string
@@ -19,10 +19,14 @@
 
 #include "common/cyclic_buffer.h"
 #include "telemetry_event.h"
+#include "telemetry_histogram.h"
+#include "telemetry_queue.h"
 #include "mem_section.h"
 #include "nixl_types.h"
 
+#include <map>
 #include <string>
+#include <tuple>
 #include <vector>
 #include <mutex>
 #include <memory>
@@ -72,7 +76,24 @@ public:
     void
     addPostTime(std::chrono::microseconds post_time);
 
+    // Latency histograms of the transfers of a backend to a remote agent, added on first
+    // use. Returns nullptr if the histogram file is full.
+    nixlTelemetryHistSlot *
+    histogram(const nixl_backend_t &backend, const std::string &remote_agent, nixl_xfer_op_t op);
+
 private:
+    // Hot events are summed per thread and written once per interval
+    enum counter_t {
+        TX_BYTES,
+        TX_REQUESTS,
+        RX_BYTES,
+        RX_REQUESTS,
+        XFER_TIME,
+        XFER_COUNT,
+        POST_TIME,
+        POST_COUNT,
+    };
+
     void
     initializeTelemetry();
     void
@@ -81,9 +102,20 @@ private:
     updateData(const std::string &event_name, nixl_telemetry_category_t category, uint64_t value);
     bool
     writeEventHelper();
+    void
+    writeCounters(uint64_t timestamp_us);
     std::unique_ptr<sharedRingBuffer<nixlTelemetryEvent>> buffer_;
-    std::vector<nixlTelemetryEvent> events_;
-    std::mutex mutex_;
+    nixlTelemetryQueue events_;
+    // Counter totals already written to the buffer
+    nixlTelemetryQueue::counters_t writtenCounters_{};
+    // Kept across writes, so they do not allocate once warmed up
+    nixlTelemetryQueue::cursors_t drainCursors_;
+    std::unique_ptr<sharedLatencyHistograms> histograms_;
+    std::mutex histogramsLock_;
+    std::map<std::tuple<nixl_backend_t, std::string, nixl_xfer_op_t>,
+             nixlTelemetryHistSlot *,
+             std::less<>>
+        histogramSlots_;
     asio::thread_pool pool_;
     periodicTask writeTask_;
     std::string file_;
@@ -0,0 +1,172 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _NIXL_TELEMETRY_HISTOGRAM_H
+#define _NIXL_TELEMETRY_HISTOGRAM_H
+
+#include <atomic>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "common/latency_histogram.h"
+#include "telemetry_event.h"
+
+constexpr char TELEMETRY_HIST_SLOTS_VAR[] = "NIXL_TELEMETRY_HIST_SLOTS";
+// Histograms are kept in a second file, next to the event buffer file
+constexpr char TELEMETRY_HIST_SUFFIX[] = ".hist";
+
+constexpr int TELEMETRY_HIST_VERSION = 1;
+constexpr size_t MAX_HIST_AGENT_NAME_LEN = 64;
+
+/**
+ * @struct nixlTelemetryHistSlot
+ * @brief Transfer and post time histograms (in us) of one operation, backend and remote agent
+ */
+struct nixlTelemetryHistSlot {
+    char backend_[MAX_EVENT_NAME_LEN];
+    char remoteAgent_[MAX_HIST_AGENT_NAME_LEN]; // Empty for local transfers
+    nixl_xfer_op_t op_;
+    nixlLatencyHistogram xferTime_;
+    nixlLatencyHistogram postTime_;
+};
+
+/**
+ * @class sharedLatencyHistograms
+ * @brief Fixed table of histogram slots in a shared memory file. The agent adds slots and
+ *        records into them, readers open the file and compute percentiles at any time,
+ *        without consuming anything.
+ */
+class sharedLatencyHistograms {
+public:
+    sharedLatencyHistograms(const std::string &name, bool create, size_t slots = 0) {
+        const int fd = create ? open(name.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR | S_IRGRP |
+                                                                         S_IROTH) :
+                                open(name.c_str(), O_RDWR);
+        if (fd == -1) {
+            throw std::runtime_error("Failed to open histogram file " + name + ": " +
+                                     strerror(errno));
+        }
+
+        if (create) {
+            if (slots == 0) {
+                close(fd);
+                throw std::invalid_argument("Histogram slot count cannot be 0");
+            }
+            mapSize_ = sizeof(tableHeader) + slots * sizeof(nixlTelemetryHistSlot);
+            // Truncating first drops the histograms of a previous run of the agent
+            if ((ftruncate(fd, 0) == -1) || (ftruncate(fd, mapSize_) == -1)) {
+                close(fd);
+                unlink(name.c_str());
+                throw std::runtime_error("Failed to set histogram file size: " + name);
+            }
+        } else {
+            struct stat st;
+            if ((fstat(fd, &st) == -1) || (static_cast<size_t>(st.st_size) < sizeof(tableHeader))) {
+                close(fd);
+                throw std::runtime_error("Histogram file too small: " + name);
+            }
+            mapSize_ = st.st_size;
+        }
+
+        void *ptr = mmap(nullptr, mapSize_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (ptr == MAP_FAILED) {
+            throw std::runtime_error("Failed to map histogram file: " + name);
+        }
+
+        header_ = static_cast<tableHeader *>(ptr);
+        slots_ = reinterpret_cast<nixlTelemetryHistSlot *>(header_ + 1);
+
+        if (create) {
+            // ftruncate zero fills, which is the initial state of every histogram
+            new (header_) tableHeader{{0}, slots, {0}};
+            header_->version.store(TELEMETRY_HIST_VERSION, std::memory_order_release);
+            return;
+        }
+
+        const int version = header_->version.load(std::memory_order_acquire);
+        if ((version != TELEMETRY_HIST_VERSION) ||
+            (mapSize_ < sizeof(tableHeader) + header_->capacity * sizeof(nixlTelemetryHistSlot))) {
+            munmap(header_, mapSize_);
+            throw std::runtime_error("Histogram file version or size mismatch: " + name);
+        }
+    }
+
+    ~sharedLatencyHistograms() {
+        msync(header_, mapSize_, MS_SYNC);
+        munmap(header_, mapSize_);
+    }
+
+    sharedLatencyHistograms(const sharedLatencyHistograms &) = delete;
+    sharedLatencyHistograms &
+    operator=(const sharedLatencyHistograms &) = delete;
+
+    // Writer side, calls must be serialized. Returns nullptr if all slots are taken.
+    nixlTelemetryHistSlot *
+    addSlot(const std::string &backend, const std::string &remote_agent, nixl_xfer_op_t op) {
+        const size_t used = header_->used.load(std::memory_order_relaxed);
+        if (used == header_->capacity) {
+            return nullptr;
+        }
+
+        nixlTelemetryHistSlot &slot = slots_[used];
+        strncpy(slot.backend_, backend.c_str(), MAX_EVENT_NAME_LEN - 1);
+        strncpy(slot.remoteAgent_, remote_agent.c_str(), MAX_HIST_AGENT_NAME_LEN - 1);
+        slot.op_ = op;
+        // Readers only look at published slots
+        header_->used.store(used + 1, std::memory_order_release);
+        return &slot;
+    }
+
+    size_t
+    size() const {
+        return header_->used.load(std::memory_order_acquire);
+    }
+
+    size_t
+    capacity() const {
+        return header_->capacity;
+    }
+
+    const nixlTelemetryHistSlot &
+    operator[](size_t index) const {
+        return slots_[index];
+    }
+
+private:
+    struct tableHeader {
+        std::atomic<int> version;
+        size_t capacity;
+        std::atomic<size_t> used;
+    };
+
+    static_assert(std::is_standard_layout<nixlTelemetryHistSlot>::value,
+                  "Histogram slots must have a fixed layout for shared memory");
+
+    tableHeader *header_ = nullptr;
+    nixlTelemetryHistSlot *slots_ = nullptr;
+    size_t mapSize_ = 0;
+};
+
+#endif // _NIXL_TELEMETRY_HISTOGRAM_H
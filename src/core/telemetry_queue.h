@@ -0,0 +1,255 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _NIXL_TELEMETRY_QUEUE_H
+#define _NIXL_TELEMETRY_QUEUE_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "telemetry_event.h"
+
+/**
+ * @class nixlTelemetryQueue
+ * @brief Telemetry events and counters recorded from any thread without locking.
+ *        Each thread records into its own bounded single producer buffer, registered on
+ *        its first record. A single consumer drains all of them periodically, in place.
+ */
+class nixlTelemetryQueue {
+    struct threadBuffer;
+
+public:
+    static constexpr size_t max_counters = 8;
+    using counters_t = std::array<uint64_t, max_counters>;
+
+    /**
+     * @param thread_capacity  Events buffered per thread between drains, rounded up to a
+     *                         power of 2. Events recorded into a full buffer are dropped.
+     */
+    explicit nixlTelemetryQueue(size_t thread_capacity) : threadCapacity_(1) {
+        while (threadCapacity_ < thread_capacity) {
+            threadCapacity_ <<= 1;
+        }
+    }
+
+    ~nixlTelemetryQueue() {
+        std::lock_guard<std::mutex> lock(buffersLock_);
+        for (const auto &buffer : buffers_) {
+            buffer->orphaned.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    nixlTelemetryQueue(const nixlTelemetryQueue &) = delete;
+    nixlTelemetryQueue &
+    operator=(const nixlTelemetryQueue &) = delete;
+
+    // Returns false if the event was dropped because the buffer of this thread is full
+    bool
+    push(const nixlTelemetryEvent &event) {
+        threadBuffer &buffer = localBuffer();
+        const size_t head = buffer.head.load(std::memory_order_relaxed);
+        if (head - buffer.tail.load(std::memory_order_acquire) > buffer.mask) {
+            return false;
+        }
+        buffer.at(head) = event;
+        buffer.head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Only the calling thread writes its counters, so no atomic read-modify-write is needed
+    void
+    add(size_t counter, uint64_t value) {
+        auto &total = localBuffer().counters[counter];
+        total.store(total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    // Unconsumed events of one thread buffer, as collected by collect()
+    struct cursor {
+        threadBuffer *buffer;
+        size_t pos;
+        size_t head;
+    };
+    using cursors_t = std::vector<cursor>;
+
+    /**
+     * Adds a cursor per thread buffer holding events to cursors, to be consumed by merge().
+     * Buffers of exited threads are released once consumed. Single consumer only.
+     */
+    void
+    collect(cursors_t &cursors) {
+        std::lock_guard<std::mutex> lock(buffersLock_);
+        for (auto it = buffers_.begin(); it != buffers_.end();) {
+            threadBuffer &buffer = **it;
+            const size_t tail = buffer.tail.load(std::memory_order_relaxed);
+
+            // Producer thread exited, keep its counters and release the buffer
+            if (buffer.detached.load(std::memory_order_acquire) &&
+                (buffer.head.load(std::memory_order_acquire) == tail)) {
+                for (size_t i = 0; i < max_counters; ++i) {
+                    retiredCounters_[i] += buffer.counters[i].load(std::memory_order_relaxed);
+                }
+                it = buffers_.erase(it);
+                continue;
+            }
+
+            const size_t head = buffer.head.load(std::memory_order_acquire);
+            if (head != tail) {
+                cursors.push_back({&buffer, tail, head});
+            }
+            ++it;
+        }
+    }
+
+    /**
+     * Consumes the collected events of any number of queues in timestamp order, by merging
+     * the thread buffers in place. consume(nixlTelemetryEvent *events, size_t count) is called
+     * with runs of consecutive events of a buffer, which it may modify but not keep. Their
+     * space is handed back to the producer after the call. Clears cursors.
+     */
+    template<typename F>
+    static void
+    merge(cursors_t &cursors, F &&consume) {
+        while (true) {
+            cursor *first = nullptr;
+            uint64_t first_ts = 0;
+            // Timestamp of the earliest event in another buffer
+            uint64_t next_ts = UINT64_MAX;
+            for (auto &c : cursors) {
+                if (c.pos == c.head) {
+                    continue;
+                }
+                const uint64_t ts = c.buffer->at(c.pos).timestampUs_;
+                if (!first || (ts < first_ts)) {
+                    if (first) {
+                        next_ts = first_ts;
+                    }
+                    first = &c;
+                    first_ts = ts;
+                } else {
+                    next_ts = std::min(next_ts, ts);
+                }
+            }
+            if (!first) {
+                break;
+            }
+
+            // The run stops before a later event than next_ts, or where the buffer wraps
+            threadBuffer &buffer = *first->buffer;
+            const size_t wrap = (first->pos | buffer.mask) + 1;
+            size_t end = first->pos + 1;
+            while ((end != first->head) && (end != wrap) &&
+                   (buffer.at(end).timestampUs_ <= next_ts)) {
+                ++end;
+            }
+
+            consume(&buffer.at(first->pos), end - first->pos);
+            first->pos = end;
+            buffer.tail.store(end, std::memory_order_release);
+        }
+        cursors.clear();
+    }
+
+    // Appends the recorded events, in timestamp order. Single consumer only.
+    void
+    drain(std::vector<nixlTelemetryEvent> &events) {
+        cursors_t cursors;
+        collect(cursors);
+        merge(cursors, [&events](const nixlTelemetryEvent *first, size_t count) {
+            events.insert(events.end(), first, first + count);
+        });
+    }
+
+    // Totals of each counter since the queue was created, over all threads
+    counters_t
+    counters() const {
+        std::lock_guard<std::mutex> lock(buffersLock_);
+        counters_t totals = retiredCounters_;
+        for (const auto &buffer : buffers_) {
+            for (size_t i = 0; i < max_counters; ++i) {
+                totals[i] += buffer->counters[i].load(std::memory_order_relaxed);
+            }
+        }
+        return totals;
+    }
+
+private:
+    struct threadBuffer {
+        std::unique_ptr<nixlTelemetryEvent[]> events;
+        const size_t mask;
+        alignas(64) std::atomic<size_t> head{0};
+        std::array<std::atomic<uint64_t>, max_counters> counters{};
+        alignas(64) std::atomic<size_t> tail{0};
+        // Set when the queue is destroyed, or when the producer thread exits
+        std::atomic<bool> orphaned{false};
+        std::atomic<bool> detached{false};
+
+        explicit threadBuffer(size_t capacity)
+            : events(new nixlTelemetryEvent[capacity]),
+              mask(capacity - 1) {}
+
+        nixlTelemetryEvent &
+        at(size_t pos) {
+            return events[pos & mask];
+        }
+    };
+
+    // Buffers of the calling thread, one per queue it recorded into
+    struct threadBuffers {
+        std::vector<std::pair<const nixlTelemetryQueue *, std::shared_ptr<threadBuffer>>> list;
+
+        ~threadBuffers() {
+            for (const auto &entry : list) {
+                entry.second->detached.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    threadBuffer &
+    localBuffer() {
+        thread_local threadBuffers local;
+        // A queue at the address of a destroyed one finds its buffers orphaned
+        for (const auto &[queue, buffer] : local.list) {
+            if ((queue == this) && !buffer->orphaned.load(std::memory_order_relaxed)) {
+                return *buffer;
+            }
+        }
+
+        auto &list = local.list;
+        for (auto it = list.begin(); it != list.end();) {
+            it = it->second->orphaned.load(std::memory_order_relaxed) ? list.erase(it) : it + 1;
+        }
+
+        auto buffer = std::make_shared<threadBuffer>(threadCapacity_);
+        {
+            std::lock_guard<std::mutex> lock(buffersLock_);
+            buffers_.push_back(buffer);
+        }
+        list.emplace_back(this, buffer);
+        return *buffer;
+    }
+
+    size_t threadCapacity_;
+    mutable std::mutex buffersLock_;
+    std::vector<std::shared_ptr<threadBuffer>> buffers_;
+    counters_t retiredCounters_{};
+};
+
+#endif // _NIXL_TELEMETRY_QUEUE_H
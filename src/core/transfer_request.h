@@ -20,6 +20,8 @@
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "nixl_types.h"
 #include "backend_engine.h"
@@ -42,13 +44,21 @@ class nixlXferReqH {
         nixl_meta_dlist_t* targetDescs    = nullptr;
 
         std::string        remoteAgent;
+        uint64_t           remoteEpoch    = 0;
         nixl_blob_t        notifMsg;
         bool               hasNotif       = false;
+        bool               descsMerged    = false;
 
         nixl_xfer_op_t     backendOp;
         nixl_status_t      status;
 
         nixl_xfer_telem_t telemetry;
+        // Histogram slot of the engine, remote agent and op it was looked up for, kept when
+        // the handle is recycled so a pooled handle reusing that key skips the lookup
+        nixlTelemetryHistSlot* latencyHist = nullptr;
+        nixlBackendEngine*     latencyHistEngine = nullptr;
+        std::string            latencyHistAgent;
+        nixl_xfer_op_t         latencyHistOp;
 
     public:
         inline nixlXferReqH() { }
@@ -61,11 +71,76 @@ class nixlXferReqH {
                 engine->releaseReqH(backendHandle);
         }
 
+        // Merges descriptor pairs that continue the previous one on both sides, in place
+        void
+        mergeDescs();
+
         void
         updateRequestStats(std::unique_ptr<nixlTelemetry> &telemetry,
                            nixl_telemetry_stat_status_t stat_status);
 
         friend class nixlAgent;
+        friend class nixlAgentData;
+        friend class nixlXferReqPool;
+};
+
+// Agent owned free list of transfer request handles. Released handles keep their descriptor
+// lists (and their capacity), so a warm pool creates requests without touching the allocator.
+class nixlXferReqPool {
+    private:
+        static constexpr size_t maxCached = 4096;
+
+        std::mutex                 lock;
+        std::vector<nixlXferReqH*> cached;
+
+    public:
+        // Hands a used handle back to its pool when going out of scope
+        struct recycler {
+            nixlXferReqPool *pool;
+
+            void operator()(nixlXferReqH *req) const {
+                pool->put(req);
+            }
+        };
+        using handle_ptr_t = std::unique_ptr<nixlXferReqH, recycler>;
+
+        inline nixlXferReqPool() {
+            cached.reserve(maxCached);
+        }
+
+        inline ~nixlXferReqPool() {
+            for (auto *req : cached)
+                delete req;
+        }
+
+        // Fresh handle with empty descriptor lists of the given memory types
+        handle_ptr_t
+        get(const nixl_mem_t &initiator_type, const nixl_mem_t &target_type);
+
+        // Releases the backend handle, and caches the request or frees it if the pool is full
+        void
+        put(nixlXferReqH *req);
+};
+
+// Pairs of prepared descriptors selected and validated once, copied out of the descriptor
+// list handles so transfer requests are made from it without per index checks
+class nixlXferTemplateH {
+    private:
+        nixlBackendEngine* engine      = nullptr;
+
+        nixl_meta_dlist_t  initiatorDescs;
+        nixl_meta_dlist_t  targetDescs;
+        size_t             totalBytes  = 0;
+
+        std::string        remoteAgent;
+        uint64_t           remoteEpoch = 0;
+
+    public:
+        inline nixlXferTemplateH(const nixl_mem_t &initiator_type,
+                                 const nixl_mem_t &target_type)
+            : initiatorDescs(initiator_type), targetDescs(target_type) { }
+
+        friend class nixlAgent;
 };
 
 class nixlDlistH {
@@ -73,6 +148,8 @@ class nixlDlistH {
         std::unordered_map<nixlBackendEngine*, nixl_meta_dlist_t*> descs;
 
         std::string        remoteAgent;
+        // remoteEpoch when the remote descriptors were populated
+        uint64_t           remoteEpoch = 0;
         bool               isLocal;
 
     public:
@@ -84,6 +161,7 @@ class nixlDlistH {
         }
 
     friend class nixlAgent;
+    friend class nixlAgentData;
 };
 
 #endif
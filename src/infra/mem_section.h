@@ -18,6 +18,9 @@
 #define __MEM_SECTION_H
 
 #include <vector>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
 #include <unordered_map>
 #include <map>
 #include <array>
@@ -59,6 +62,47 @@ public:
 };
 
 class nixlSecDescList : public nixlDescList<nixlSectionDesc> {
+private:
+    struct searchKey {
+        uint64_t devId;
+        uintptr_t addr;
+        size_t len;
+    };
+
+    // Search index over the sorted elements, in Eytzinger (BFS) layout and padded
+    // to a complete tree. Built on the first lookup after a change, as lookups can
+    // run concurrently under a shared lock while changes are exclusive.
+    mutable std::vector<searchKey> searchTree;
+    mutable std::vector<int> searchPos;
+    mutable size_t searchDepth = 0;
+    mutable std::atomic<bool> searchValid{false};
+    mutable std::mutex searchLock;
+
+    static searchKey
+    makeKey(const nixlBasicDesc &desc) {
+        return {desc.devId, desc.addr, desc.len};
+    }
+
+    // Same order as nixlBasicDesc, without branches so the search does not stall on
+    // mispredictions
+    static bool
+    keyLess(const searchKey &lhs, const searchKey &rhs) {
+        return (lhs.devId < rhs.devId) |
+               ((lhs.devId == rhs.devId) &
+                ((lhs.addr < rhs.addr) | ((lhs.addr == rhs.addr) & (lhs.len < rhs.len))));
+    }
+
+    void
+    invalidateSearch() {
+        searchValid.store(false, std::memory_order_relaxed);
+    }
+
+    void
+    prepareSearch() const;
+
+    int
+    coveringFromBound(const nixlBasicDesc &query, size_t node) const;
+
 public:
     explicit nixlSecDescList(const nixl_mem_t &type) : nixlDescList<nixlSectionDesc>(type, 0) {}
 
@@ -67,29 +111,67 @@ public:
     void
     addDesc(const nixlSectionDesc &desc) override;
 
+    // Bulk insertion, new elements are sorted once and merged with existing ones
+    void
+    addDescs(std::vector<nixlSectionDesc> &&new_descs);
+
+    void
+    remDesc(const int &index);
+
+    // Bulk removal of the elements at the given indices, in a single pass
+    void
+    remDescs(std::vector<int> &&indices);
+
+    void
+    clear();
+
     bool
     verifySorted() const;
 
     nixlSectionDesc &
     operator[](unsigned int index) override;
 
+    // Metadata is not part of the search key, setting it keeps the search index
+    void
+    setMetadata(int index, nixlBackendMD *metadata) {
+        descs[index].metadataP = metadata;
+    }
+
     int
     getIndex(const nixlBasicDesc &query) const override;
 
     int
     getCoveringIndex(const nixlBasicDesc &query) const;
 
+    // Batched getCoveringIndex for all elements of query, -1 for the uncovered ones.
+    // Consecutive elements hitting the same or next entry skip the search.
+    void
+    getCoveringIndices(const nixlDescList<nixlBasicDesc> &query,
+                       std::vector<int> &indices) const;
+
     void
     resize(const size_t &count) override;
 
+    // Delta/varint encoded descriptors with deduplicated metadata blobs,
+    // deserialized as a nixl_reg_dlist_t like serialize()
+    nixl_status_t
+    serializeCompact(nixlSerDes *serializer) const;
+
     // Disable parent's convenience constructors that allow pre-sizing
-    nixlSecDescList(const nixlSecDescList &) = default;
+    nixlSecDescList(const nixlSecDescList &other) : nixlDescList<nixlSectionDesc>(other) {}
+
     nixlSecDescList &
-    operator=(const nixlSecDescList &) = default;
+    operator=(const nixlSecDescList &other) {
+        nixlDescList<nixlSectionDesc>::operator=(other);
+        invalidateSearch();
+        return *this;
+    }
 };
 
 using nixl_sec_dlist_t = nixlSecDescList;
 using section_map_t = std::map<section_key_t, nixl_sec_dlist_t*>;
+// Changed descriptors per section, as given at registration
+using section_delta_t = std::map<section_key_t, std::vector<nixlBasicDesc>>;
 
 class nixlMemSection {
     protected:
@@ -101,9 +183,9 @@ class nixlMemSection {
 
         backend_set_t* queryBackends (const nixl_mem_t &mem);
 
-        nixl_status_t populate (const nixl_xfer_dlist_t &query,
-                                nixlBackendEngine* backend,
-                                nixl_meta_dlist_t &resp) const;
+        virtual nixl_status_t populate (const nixl_xfer_dlist_t &query,
+                                        nixlBackendEngine* backend,
+                                        nixl_meta_dlist_t &resp) const;
 
 
         virtual ~nixlMemSection () = 0; // Making the class abstract
@@ -120,11 +202,20 @@ class nixlLocalSection : public nixlMemSection {
         nixl_status_t remDescList (const nixl_reg_dlist_t &mem_elms,
                                    nixlBackendEngine* backend);
 
-        nixl_status_t serialize(nixlSerDes* serializer) const;
+        nixl_status_t serialize(nixlSerDes* serializer,
+                                bool compact = false) const;
 
         nixl_status_t serializePartial(nixlSerDes* serializer,
                                        const backend_set_t &backends,
-                                       const nixl_reg_dlist_t &mem_elms) const;
+                                       const nixl_reg_dlist_t &mem_elms,
+                                       bool compact = false) const;
+
+        // Descriptors to remove, then the current entries of the changed ones
+        // that are still registered, loaded by nixlRemoteSection::loadRemoteDelta
+        nixl_status_t serializeDelta(nixlSerDes* serializer,
+                                     const section_delta_t &removed,
+                                     const section_delta_t &changed,
+                                     bool compact = false) const;
 
         ~nixlLocalSection();
 };
@@ -134,18 +225,42 @@ class nixlRemoteSection : public nixlMemSection {
     private:
         std::string agentName;
 
+        // In lazy mode loaded entries keep their blob only, and are unpacked by the
+        // backend on the first populate hit. Unpacking runs under the shared agent
+        // lock, so it is serialized by lazyLock while any entry is still packed.
+        const bool                  lazy;
+        mutable std::atomic<size_t> packedCount{0};
+        mutable std::mutex          lazyLock;
+
         nixl_status_t addDescList (
                            const nixl_reg_dlist_t &mem_elms,
                            nixlBackendEngine *backend);
+
+        // Entries not loaded are skipped, as the delta can follow a partial load
+        nixl_status_t remDescList (
+                           const nixl_reg_dlist_t &mem_elms,
+                           nixlBackendEngine *backend);
     public:
-        nixlRemoteSection (const std::string &agent_name);
+        nixlRemoteSection (const std::string &agent_name, bool lazy = false);
+
+        nixl_status_t populate (const nixl_xfer_dlist_t &query,
+                                nixlBackendEngine* backend,
+                                nixl_meta_dlist_t &resp) const override;
 
         nixl_status_t loadRemoteData (nixlSerDes* deserializer,
                                       backend_map_t &backendToEngineMap);
 
+        // Removals and additions from nixlLocalSection::serializeDelta, applied
+        // in place to the sorted lists
+        nixl_status_t loadRemoteDelta (nixlSerDes* deserializer,
+                                       backend_map_t &backendToEngineMap);
+
         // When adding self as a remote agent for local operations
         nixl_status_t loadLocalData (const nixl_sec_dlist_t& mem_elms,
                                      nixlBackendEngine* backend);
+
+        // Loaded entries in the layout of nixlLocalSection::serialize, for snapshots
+        nixl_status_t serialize(nixlSerDes* serializer) const;
         ~nixlRemoteSection();
 };
 
@@ -15,9 +15,13 @@
  * limitations under the License.
  */
 #include <algorithm>
+#include <cstring>
 #include <functional>
 #include <stdexcept>
 #include <iostream>
+#include <iterator>
+#include <unordered_map>
+#include <string_view>
 #include "nixl.h"
 #include "nixl_descriptors.h"
 #include "mem_section.h"
@@ -141,6 +145,87 @@ void nixlBlobDesc::print(const std::string &suffix) const {
     nixlBasicDesc::print(", Metadata: " + metaInfo + suffix);
 }
 
+/*** Compact descriptor list encoding ***/
+
+// Used by nixlSecDescList::serializeCompact, for each descriptor in list order:
+//   varint  devId delta from the previous descriptor
+//   varint  zigzag addr delta from the end of the previous descriptor
+//   varint  zigzag len delta from the previous descriptor
+//   varint  metadata blob reference, 0 for a new blob followed by its varint
+//           size and bytes, otherwise 1 + index of a previously seen blob
+// Sorted, contiguous and equally sized regions take 4 bytes plus their blob.
+namespace {
+void
+putVarint(std::string &out, uint64_t val) {
+    while (val >= 0x80) {
+        out.push_back(static_cast<char>((val & 0x7f) | 0x80));
+        val >>= 7;
+    }
+    out.push_back(static_cast<char>(val));
+}
+
+bool
+getVarint(std::string_view &in, uint64_t &val) {
+    val = 0;
+    for (unsigned shift = 0; shift < 64 && !in.empty(); shift += 7) {
+        const uint8_t byte = static_cast<uint8_t>(in.front());
+        in.remove_prefix(1);
+        val |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Small negative deltas (overlapping regions) stay small
+inline uint64_t
+zigzag(uint64_t delta) {
+    const int64_t val = static_cast<int64_t>(delta);
+    return (static_cast<uint64_t>(val) << 1) ^ static_cast<uint64_t>(val >> 63);
+}
+
+inline uint64_t
+unzigzag(uint64_t val) {
+    return (val >> 1) ^ (~(val & 1) + 1);
+}
+
+bool
+decodeCompactDescs(std::string_view in, size_t n_desc, std::vector<nixlBlobDesc> &descs) {
+    std::vector<std::string_view> blobs;
+    uint64_t dev_id = 0, next_addr = 0, len = 0, val;
+
+    // Each descriptor takes at least one byte per varint, n_desc comes from the buffer
+    if (n_desc > in.size() / 4) return false;
+    descs.reserve(n_desc);
+    for (size_t i = 0; i < n_desc; ++i) {
+        if (!getVarint(in, val)) return false;
+        dev_id += val;
+        if (!getVarint(in, val)) return false;
+        const uint64_t addr = next_addr + unzigzag(val);
+        if (!getVarint(in, val)) return false;
+        len += unzigzag(val);
+
+        std::string_view meta;
+        if (!getVarint(in, val)) return false;
+        if (val == 0) {
+            uint64_t size;
+            if (!getVarint(in, size) || size > in.size()) return false;
+            meta = in.substr(0, size);
+            in.remove_prefix(size);
+            blobs.push_back(meta);
+        } else if (val <= blobs.size()) {
+            meta = blobs[val - 1];
+        } else {
+            return false;
+        }
+
+        nixlBlobDesc &desc = descs.emplace_back(addr, len, dev_id);
+        desc.metaInfo.assign(meta);
+        next_addr = addr + len;
+    }
+    return in.empty();
+}
+} // namespace
+
 /*** Class nixlDescList implementation ***/
 
 // The template is used to select from nixlBasicDesc/nixlMetaDesc/nixlBlobDesc
@@ -155,11 +240,12 @@ template<class T> nixlDescList<T>::nixlDescList(const nixl_mem_t &type, const in
 template <class T>
 nixlDescList<T>::nixlDescList(nixlSerDes* deserializer) {
     size_t n_desc;
-    std::string str;
+    std::string_view str;
 
     descs.clear();
 
-    str = deserializer->getStr("nixlDList"); // Object type
+    // Views point into the deserializer buffer, so each payload is copied once
+    str = deserializer->getStrView("nixlDList"); // Object type
     if (str.size()==0)
         return;
 
@@ -177,48 +263,47 @@ nixlDescList<T>::nixlDescList(nixlSerDes* deserializer) {
         // Contiguous in memory, so no need for per elm deserialization
         if (str!="nixlBDList")
             return;
-        str = deserializer->getStr("");
+        str = deserializer->getStrView("");
         if (str.size()!= n_desc * sizeof(nixlBasicDesc))
             return;
         // If size is proper, deserializer cannot fail
         descs.resize(n_desc);
-        str.copy(reinterpret_cast<char*>(descs.data()), str.size());
+        memcpy(reinterpret_cast<char*>(descs.data()), str.data(), str.size());
 
     } else if (std::is_same<nixlBlobDesc, T>::value) {
+        if (str=="nixlCDList") {
+            if constexpr (std::is_same<nixlBlobDesc, T>::value) {
+                if ((n_desc > 0) &&
+                    !decodeCompactDescs(deserializer->getStrView(""), n_desc, descs))
+                    descs.clear();
+            }
+            return;
+        }
         if (str!="nixlSDList")
             return;
+        // n_desc comes from the buffer, each descriptor takes at least a field there
+        descs.reserve(std::min(n_desc,
+                               deserializer->remaining() /
+                                   nixlSerDes::fieldSize("", sizeof(nixlBasicDesc))));
         for (size_t i=0; i<n_desc; ++i) {
-            str = deserializer->getStr("");
+            str = deserializer->getStrView("");
             // If size is proper, deserializer cannot fail
             // Allowing empty strings, might change later
             if (str.size() < sizeof(nixlBasicDesc)) {
                 descs.clear();
                 return;
             }
-            T elm(str);
-            descs.push_back(elm);
+            // Same layout as the nixlBlobDesc(const nixl_blob_t&) constructor
+            T &elm = descs.emplace_back();
+            memcpy(static_cast<nixlBasicDesc *>(&elm), str.data(), sizeof(nixlBasicDesc));
+            if constexpr (std::is_same<nixlBlobDesc, T>::value)
+                elm.metaInfo.assign(str.substr(sizeof(nixlBasicDesc)));
         }
     } else {
         return; // Unknown type, error
     }
 }
 
-// Getter
-template <class T>
-inline const T& nixlDescList<T>::operator[](unsigned int index) const {
-    // To be added only in debug mode
-    // if (index >= descs.size())
-    //     throw std::out_of_range("Index is out of range");
-    return descs[index];
-}
-
-// Setter
-template <class T>
-inline T& nixlDescList<T>::operator[](unsigned int index) {
-    assert(index < descs.size());
-    return descs[index];
-}
-
 template <class T>
 void nixlDescList<T>::addDesc (const T &desc) {
     descs.push_back(desc);
@@ -263,6 +348,24 @@ int nixlDescList<T>::getIndex(const nixlBasicDesc &query) const {
     return itr - descs.begin();
 }
 
+namespace {
+// Size of the metadata part of a serialized descriptor
+inline size_t
+descMetaSize(const nixlBasicDesc &) {
+    return 0;
+}
+
+inline size_t
+descMetaSize(const nixlBlobDesc &desc) {
+    return desc.metaInfo.size();
+}
+
+inline size_t
+descMetaSize(const nixlSectionDesc &desc) {
+    return desc.metaBlob.size();
+}
+} // namespace
+
 template <class T>
 nixl_status_t nixlDescList<T>::serialize(nixlSerDes* serializer) const {
 
@@ -297,11 +400,17 @@ nixl_status_t nixlDescList<T>::serialize(nixlSerDes* serializer) const {
     // Optimization for nixlBasicDesc,
     // contiguous in memory, so no need for per elm serialization
     if (std::is_same<nixlBasicDesc, T>::value) {
-        ret = serializer->addStr("", std::string(
+        ret = serializer->addStr("", std::string_view(
                                  reinterpret_cast<const char*>(descs.data()),
                                  n_desc * sizeof(nixlBasicDesc)));
         if (ret) return ret;
     } else { // already checked it can be only nixlBlobDesc or nixlSectionDesc
+        // Pre-size the output for the whole list, as lists can be very large
+        size_t total_size = 0;
+        for (auto & elm : descs)
+            total_size += nixlSerDes::fieldSize("", sizeof(nixlBasicDesc) + descMetaSize(elm));
+        serializer->reserve(total_size);
+
         for (auto & elm : descs) {
             ret = serializer->addStr("", elm.serialize());
             if (ret) return ret;
@@ -353,6 +462,60 @@ nixlSecDescList::addDesc(const nixlSectionDesc &desc) {
         vec.push_back(desc);
     else
         vec.insert(itr, desc);
+    invalidateSearch();
+}
+
+void
+nixlSecDescList::addDescs(std::vector<nixlSectionDesc> &&new_descs) {
+    auto &vec = this->descs;
+    invalidateSearch();
+    // Stable, so equal elements keep the same order as with repeated addDesc
+    if (!std::is_sorted(new_descs.begin(), new_descs.end()))
+        std::stable_sort(new_descs.begin(), new_descs.end());
+
+    if (vec.empty()) {
+        vec = std::move(new_descs);
+        return;
+    }
+
+    const auto mid = vec.size();
+    vec.reserve(mid + new_descs.size());
+    std::move(new_descs.begin(), new_descs.end(), std::back_inserter(vec));
+    std::inplace_merge(vec.begin(), vec.begin() + mid, vec.end());
+}
+
+void
+nixlSecDescList::remDesc(const int &index) {
+    nixlDescList<nixlSectionDesc>::remDesc(index);
+    invalidateSearch();
+}
+
+void
+nixlSecDescList::remDescs(std::vector<int> &&indices) {
+    auto &vec = this->descs;
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    if (indices.empty()) return;
+    if ((indices.front() < 0) || ((size_t)indices.back() >= vec.size()))
+        throw std::out_of_range("Index is out of range");
+
+    auto rem = indices.begin();
+    size_t out = *rem;
+    for (size_t in = out; in < vec.size(); ++in) {
+        if ((rem != indices.end()) && ((size_t)*rem == in)) {
+            ++rem;
+            continue;
+        }
+        vec[out++] = std::move(vec[in]);
+    }
+    vec.erase(vec.begin() + out, vec.end());
+    invalidateSearch();
+}
+
+void
+nixlSecDescList::clear() {
+    nixlDescList<nixlSectionDesc>::clear();
+    invalidateSearch();
 }
 
 bool
@@ -370,6 +533,8 @@ nixlSectionDesc &
 nixlSecDescList::operator[](unsigned int index) {
     nixlSectionDesc &ref = this->descs[index];
     assert(verifySorted());
+    // The caller can modify the element
+    invalidateSearch();
     return ref;
 }
 
@@ -382,8 +547,68 @@ nixlSecDescList::getIndex(const nixlBasicDesc &query) const {
     return NIXL_ERR_NOT_FOUND;
 }
 
+namespace {
+// In-order walk of the complete tree, so node keys follow the sorted element order
+template<class F>
+void
+fillInOrder(size_t node, size_t tree_size, size_t &next, const F &fill) {
+    if (node > tree_size) return;
+    fillInOrder(2 * node, tree_size, next, fill);
+    fill(node, next++);
+    fillInOrder(2 * node + 1, tree_size, next, fill);
+}
+
+// Node where the search ends, 0 if the searched key is past all elements
+inline size_t
+boundNode(size_t node) {
+    return node >> __builtin_ffsll(~(unsigned long long)node);
+}
+} // namespace
+
+void
+nixlSecDescList::prepareSearch() const {
+    if (searchValid.load(std::memory_order_acquire)) return;
+
+    std::lock_guard<std::mutex> guard(searchLock);
+    if (searchValid.load(std::memory_order_relaxed)) return;
+
+    const auto &vec = this->descs;
+    const size_t size = vec.size();
+    size_t depth = 0;
+    while (((size_t)1 << depth) - 1 < size)
+        ++depth;
+    const size_t tree_size = ((size_t)1 << depth) - 1;
+
+    // Padding nodes hold the largest key, so they are never less than a query
+    const searchKey pad = {UINT64_MAX, UINTPTR_MAX, SIZE_MAX};
+    searchTree.assign(tree_size + 1, pad); // Node 0 is unused
+    searchPos.assign(tree_size + 1, (int)size);
+
+    size_t next = 0;
+    fillInOrder(1, tree_size, next, [&](size_t node, size_t index) {
+        if (index < size) {
+            searchTree[node] = makeKey(vec[index]);
+            searchPos[node] = (int)index;
+        }
+    });
+    searchDepth = depth;
+    searchValid.store(true, std::memory_order_release);
+}
+
+int
+nixlSecDescList::coveringFromBound(const nixlBasicDesc &query, size_t node) const {
+    // Same as lower_bound, first element not less than the query
+    const int index = searchPos[boundNode(node)];
+    if (index < (int)this->descs.size() && this->descs[index].covers(query)) return index;
+    // If query and element don't have the same start address, try previous entry
+    if (index > 0 && this->descs[index - 1].covers(query)) return index - 1;
+    return -1;
+}
+
 int
 nixlSecDescList::getCoveringIndex(const nixlBasicDesc &query) const {
+    // A single search is latency bound, where the branch predictor of a plain
+    // binary search does better than the branchless walk of the search index.
     auto itr = std::lower_bound(this->descs.begin(), this->descs.end(), query);
     if (itr != this->descs.end() && itr->covers(query))
         return static_cast<int>(itr - this->descs.begin());
@@ -395,10 +620,106 @@ nixlSecDescList::getCoveringIndex(const nixlBasicDesc &query) const {
     return -1;
 }
 
+void
+nixlSecDescList::getCoveringIndices(const nixlDescList<nixlBasicDesc> &query,
+                                    std::vector<int> &indices) const {
+    // Misses are searched in groups, walking the tree levels in lockstep so the
+    // memory accesses of independent searches overlap.
+    static constexpr size_t group_size = 8;
+    size_t pending[group_size];
+    size_t nodes[group_size];
+    searchKey keys[group_size];
+    size_t count = 0;
+    int last = -1;
+
+    prepareSearch();
+    const int size = (int)this->descs.size();
+    indices.resize(query.descCount());
+
+    auto search_group = [&]() {
+        for (size_t level = 0; level < searchDepth; ++level)
+            for (size_t j = 0; j < count; ++j)
+                nodes[j] = 2 * nodes[j] + keyLess(searchTree[nodes[j]], keys[j]);
+        for (size_t j = 0; j < count; ++j) {
+            const int index = coveringFromBound(query[pending[j]], nodes[j]);
+            indices[pending[j]] = index;
+            if (index >= 0) last = index;
+        }
+        count = 0;
+    };
+
+    for (int i = 0; i < query.descCount(); ++i) {
+        const nixlBasicDesc &desc = query[i];
+        // Consecutive descriptors are often within the same or the next entry
+        if (last >= 0) {
+            if (this->descs[last].covers(desc)) {
+                indices[i] = last;
+                continue;
+            }
+            if (last + 1 < size && this->descs[last + 1].covers(desc)) {
+                indices[i] = ++last;
+                continue;
+            }
+        }
+
+        pending[count] = i;
+        nodes[count] = 1;
+        keys[count] = makeKey(desc);
+        if (++count == group_size) search_group();
+    }
+    if (count > 0) search_group();
+}
+
 void
 nixlSecDescList::resize(const size_t &count) {
     if (count > this->descs.size())
         throw std::logic_error(
             "nixlSecDescList: to keep list sorted, resize growth is not allowed.");
     this->descs.resize(count);
+    invalidateSearch();
+}
+
+nixl_status_t
+nixlSecDescList::serializeCompact(nixlSerDes *serializer) const {
+    nixl_status_t ret;
+    size_t n_desc = descs.size();
+
+    ret = serializer->addStr("nixlDList", "nixlCDList");
+    if (ret) return ret;
+
+    ret = serializer->addBuf("t", &type, sizeof(type));
+    if (ret) return ret;
+
+    ret = serializer->addBuf("n", &(n_desc), sizeof(n_desc));
+    if (ret) return ret;
+
+    if (n_desc==0)
+        return NIXL_SUCCESS;
+
+    std::string payload;
+    std::unordered_map<std::string_view, uint64_t> blobs;
+    uint64_t dev_id = 0, next_addr = 0, len = 0;
+
+    payload.reserve(n_desc * 4);
+    for (const auto &elm : descs) {
+        putVarint(payload, elm.devId - dev_id);
+        putVarint(payload, zigzag(elm.addr - next_addr));
+        putVarint(payload, zigzag(elm.len - len));
+
+        // Views into the list elements, which outlive the map
+        auto [itr, added] = blobs.try_emplace(elm.metaBlob, blobs.size() + 1);
+        if (added) {
+            putVarint(payload, 0);
+            putVarint(payload, elm.metaBlob.size());
+            payload.append(elm.metaBlob);
+        } else {
+            putVarint(payload, itr->second);
+        }
+
+        dev_id = elm.devId;
+        len = elm.len;
+        next_addr = elm.addr + elm.len;
+    }
+
+    return serializer->addStr("", payload);
 }
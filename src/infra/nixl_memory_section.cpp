@@ -48,41 +48,18 @@ nixl_status_t nixlMemSection::populate (const nixl_xfer_dlist_t &query,
     if (it==sectionMap.end())
         return NIXL_ERR_NOT_FOUND;
 
-    nixl_sec_dlist_t* base = it->second;
-    resp.resize(query.descCount());
-
-    int size = base->descCount();
-    int s_index = 0;
+    const nixl_sec_dlist_t &base = *it->second;
+    std::vector<int> indices;
+    base.getCoveringIndices(query, indices);
 
-    // Use logN search for the first element, instead of linear search
-    s_index = base->getCoveringIndex(query[0]);
-    if (s_index < 0) {
-        resp.clear();
-        return NIXL_ERR_UNKNOWN;
-    }
-    static_cast<nixlBasicDesc &>(resp[0]) = query[0];
-    resp[0].metadataP = (*base)[s_index].metadataP;
-
-    // Walk forward for non-decreasing elements; logN search on temporal disorder
-    for (int i = 1; i < query.descCount(); ++i) {
-        if (query[i] < query[i - 1]) {
-            // Disorder in the list, resolve this element using logN search
-            s_index = base->getCoveringIndex(query[i]);
-            if (s_index < 0) {
-                resp.clear();
-                return NIXL_ERR_UNKNOWN;
-            }
-        } else {
-            while (s_index < size && !(*base)[s_index].covers(query[i]))
-                ++s_index;
-            if (s_index == size) {
-                resp.clear();
-                return NIXL_ERR_UNKNOWN;
-            }
+    resp.resize(query.descCount());
+    for (int i = 0; i < query.descCount(); ++i) {
+        if (indices[i] < 0) {
+            resp.clear();
+            return NIXL_ERR_UNKNOWN;
         }
-
         static_cast<nixlBasicDesc &>(resp[i]) = query[i];
-        resp[i].metadataP = (*base)[s_index].metadataP;
+        resp[i].metadataP = base[indices[i]].metadataP;
     }
     return NIXL_SUCCESS;
 }
@@ -107,14 +84,19 @@ nixl_status_t nixlLocalSection::addDescList (const nixl_reg_dlist_t &mem_elms,
     }
     nixl_sec_dlist_t *target = sectionMap[sec_key];
 
-    // Add entries to the target list
+    // Entries are collected first and inserted into the sorted lists at once,
+    // per element sorted insertion is quadratic for large registrations.
+    std::vector<nixlSectionDesc> local_descs, self_descs;
     nixlSectionDesc local_sec, self_sec;
     nixlBasicDesc *lp = &local_sec;
     nixlBasicDesc *rp = &self_sec;
-    nixl_status_t ret;
+    nixl_status_t ret = NIXL_SUCCESS;
+
+    local_descs.reserve(mem_elms.descCount());
+    if (backend->supportsLocal())
+        self_descs.reserve(mem_elms.descCount());
 
-    int i;
-    for (i = 0; i < mem_elms.descCount(); ++i) {
+    for (int i = 0; i < mem_elms.descCount(); ++i) {
         // TODO: For now trusting the user, but there can be a more checks mode
         //       where we find overlaps and split the memories or warn the user
         ret = backend->registerMem(mem_elms[i], nixl_mem, local_sec.metadataP);
@@ -145,31 +127,30 @@ nixl_status_t nixlLocalSection::addDescList (const nixl_reg_dlist_t &mem_elms,
              (nixl_mem == FILE_SEG)) && (lp->len==0))
             lp->len = SIZE_MAX; // File has no range limit
 
-        target->addDesc(local_sec);
+        local_descs.push_back(local_sec);
 
         if (backend->supportsLocal()) {
             *rp = *lp;
-            remote_self.addDesc(self_sec);
+            self_descs.push_back(self_sec);
         }
     }
 
-    // Abort in case of error
+    // Abort in case of error, nothing was added to the lists yet
     if (ret != NIXL_SUCCESS) {
-        for (int j = 0; j < i; ++j) {
-            int index = target->getIndex(mem_elms[j]);
-
-            if (backend->supportsLocal()) {
-                int self_index = remote_self.getIndex(mem_elms[j]);
-                // Should never be negative, as we just added it in previous loop
-                if (self_index >= 0 && remote_self[self_index].metadataP != (*target)[index].metadataP)
-                    backend->unloadMD(remote_self[self_index].metadataP);
-            }
-            backend->deregisterMem((*target)[index].metadataP);
-            target->remDesc(index);
+        for (size_t j = 0; j < local_descs.size(); ++j) {
+            if (backend->supportsLocal() &&
+                self_descs[j].metadataP != local_descs[j].metadataP)
+                backend->unloadMD(self_descs[j].metadataP);
+            backend->deregisterMem(local_descs[j].metadataP);
         }
         remote_self.clear();
+        return ret;
     }
-    return ret;
+
+    target->addDescs(std::move(local_descs));
+    if (backend->supportsLocal())
+        remote_self.addDescs(std::move(self_descs));
+    return NIXL_SUCCESS;
 }
 
 nixl_status_t nixlLocalSection::remDescList (const nixl_reg_dlist_t &mem_elms,
@@ -185,18 +166,21 @@ nixl_status_t nixlLocalSection::remDescList (const nixl_reg_dlist_t &mem_elms,
 
     // First check if the mem_elms are present in the list,
     // don't deregister anything in case any is missing.
+    const nixl_sec_dlist_t &existing = *target;
+    std::vector<int> indices;
+    indices.reserve(mem_elms.descCount());
     for (auto & elm : mem_elms) {
-        int index = target->getIndex(elm);
+        int index = existing.getIndex(elm);
         if (index < 0)
             return NIXL_ERR_NOT_FOUND;
+        indices.push_back(index);
     }
 
-    for (auto & elm : mem_elms) {
-        int index = target->getIndex(elm);
-        // Already checked, elm should always be found. Can add a check in debug mode.
-        backend->deregisterMem((*target)[index].metadataP);
-        target->remDesc(index);
-    }
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    for (int index : indices)
+        backend->deregisterMem(existing[index].metadataP);
+    target->remDescs(std::move(indices));
 
     if (target->descCount()==0) {
         delete target;
@@ -209,7 +193,8 @@ nixl_status_t nixlLocalSection::remDescList (const nixl_reg_dlist_t &mem_elms,
 
 namespace {
 nixl_status_t serializeSections(nixlSerDes* serializer,
-                                const section_map_t &sections) {
+                                const section_map_t &sections,
+                                bool compact) {
   size_t seg_count =
       std::count_if(sections.begin(), sections.end(), [](const auto &pair) {
         section_key_t sec_key = pair.first;
@@ -228,7 +213,7 @@ nixl_status_t serializeSections(nixlSerDes* serializer,
     ret = serializer->addStr("bknd", eng->getType());
     if (ret)
       return ret;
-    ret = dlist->serialize(serializer);
+    ret = compact ? dlist->serializeCompact(serializer) : dlist->serialize(serializer);
     if (ret)
       return ret;
     }
@@ -237,20 +222,22 @@ nixl_status_t serializeSections(nixlSerDes* serializer,
 }
 };
 
-nixl_status_t nixlLocalSection::serialize(nixlSerDes* serializer) const {
-    return serializeSections(serializer, sectionMap);
+nixl_status_t nixlLocalSection::serialize(nixlSerDes* serializer,
+                                          bool compact) const {
+    return serializeSections(serializer, sectionMap, compact);
 }
 
 nixl_status_t nixlLocalSection::serializePartial(nixlSerDes* serializer,
                                                  const backend_set_t &backends,
-                                                 const nixl_reg_dlist_t &mem_elms) const {
+                                                 const nixl_reg_dlist_t &mem_elms,
+                                                 bool compact) const {
     nixl_mem_t nixl_mem = mem_elms.getType();
     nixl_status_t ret = NIXL_SUCCESS;
     section_map_t mem_elms_to_serialize;
 
     // If there are no descriptors to serialize, just serialize empty list of sections
     if (mem_elms.descCount() == 0)
-        return serializeSections(serializer, mem_elms_to_serialize);
+        return serializeSections(serializer, mem_elms_to_serialize, compact);
 
     // TODO: consider concatenating 2 serializers instead of using mem_elms_to_serialize
     for (const auto &backend : backends) {
@@ -277,13 +264,60 @@ nixl_status_t nixlLocalSection::serializePartial(nixlSerDes* serializer,
     }
 
     if (ret == NIXL_SUCCESS)
-        ret = serializeSections(serializer, mem_elms_to_serialize);
+        ret = serializeSections(serializer, mem_elms_to_serialize, compact);
 
     for (auto &[sec_key, m_desc] : mem_elms_to_serialize)
         delete m_desc;
     return ret;
 }
 
+nixl_status_t nixlLocalSection::serializeDelta(nixlSerDes* serializer,
+                                               const section_delta_t &removed,
+                                               const section_delta_t &changed,
+                                               bool compact) const {
+    section_map_t rem_sections, add_sections;
+
+    for (const auto &[sec_key, descs] : removed) {
+        if (descs.empty())
+            continue;
+        std::vector<nixlSectionDesc> elms(descs.size());
+        for (size_t i = 0; i < descs.size(); ++i)
+            static_cast<nixlBasicDesc &>(elms[i]) = descs[i];
+        nixl_sec_dlist_t *resp = new nixl_sec_dlist_t(sec_key.first);
+        resp->addDescs(std::move(elms));
+        rem_sections.emplace(sec_key, resp);
+    }
+
+    // Changed descriptors deregistered since are covered by the removals
+    for (const auto &[sec_key, descs] : changed) {
+        auto it = sectionMap.find(sec_key);
+        if (it == sectionMap.end())
+            continue;
+        const nixl_sec_dlist_t &base = *it->second;
+        std::vector<nixlSectionDesc> elms;
+        elms.reserve(descs.size());
+        for (const auto &desc : descs) {
+            int index = base.getIndex(desc);
+            if (index >= 0)
+                elms.push_back(base[index]);
+        }
+        if (elms.empty())
+            continue;
+        nixl_sec_dlist_t *resp = new nixl_sec_dlist_t(sec_key.first);
+        resp->addDescs(std::move(elms));
+        add_sections.emplace(sec_key, resp);
+    }
+
+    nixl_status_t ret = serializeSections(serializer, rem_sections, compact);
+    if (ret == NIXL_SUCCESS)
+        ret = serializeSections(serializer, add_sections, compact);
+
+    for (auto *sections : {&rem_sections, &add_sections})
+        for (auto &[sec_key, m_desc] : *sections)
+            delete m_desc;
+    return ret;
+}
+
 nixlLocalSection::~nixlLocalSection() {
     for (auto &[sec_key, dlist] : sectionMap) {
         nixlBackendEngine* eng = sec_key.second;
@@ -296,10 +330,57 @@ nixlLocalSection::~nixlLocalSection() {
 
 /*** Class nixlRemoteSection implementation ***/
 
-nixlRemoteSection::nixlRemoteSection (const std::string &agent_name) {
+nixlRemoteSection::nixlRemoteSection (const std::string &agent_name, bool lazy)
+    : lazy(lazy) {
     this->agentName = agent_name;
 }
 
+nixl_status_t nixlRemoteSection::populate (const nixl_xfer_dlist_t &query,
+                                           nixlBackendEngine* backend,
+                                           nixl_meta_dlist_t &resp) const {
+
+    // Once everything is unpacked, the lookup is the same as the eager mode
+    if (packedCount.load(std::memory_order_acquire) == 0)
+        return nixlMemSection::populate(query, backend, resp);
+
+    if ((query.getType() != resp.getType()) || (query.descCount() == 0))
+        return NIXL_ERR_INVALID_PARAM;
+
+    section_key_t sec_key = std::make_pair(query.getType(), backend);
+    auto it = sectionMap.find(sec_key);
+    if (it==sectionMap.end())
+        return NIXL_ERR_NOT_FOUND;
+
+    const std::lock_guard<std::mutex> guard(lazyLock);
+    nixl_sec_dlist_t &target = *it->second;
+    const nixl_sec_dlist_t &base = target;
+    std::vector<int> indices;
+    base.getCoveringIndices(query, indices);
+
+    resp.resize(query.descCount());
+    for (int i = 0; i < query.descCount(); ++i) {
+        if (indices[i] < 0) {
+            resp.clear();
+            return NIXL_ERR_UNKNOWN;
+        }
+        const nixlSectionDesc &entry = base[indices[i]];
+        if (!entry.metadataP) {
+            nixlBackendMD *metadata = nullptr;
+            nixl_status_t ret = backend->loadRemoteMD(nixlBlobDesc(entry, entry.metaBlob),
+                                                      query.getType(), agentName, metadata);
+            if (ret<0) {
+                resp.clear();
+                return ret;
+            }
+            target.setMetadata(indices[i], metadata);
+            packedCount.fetch_sub(1, std::memory_order_release);
+        }
+        static_cast<nixlBasicDesc &>(resp[i]) = query[i];
+        resp[i].metadataP = entry.metadataP;
+    }
+    return NIXL_SUCCESS;
+}
+
 nixl_status_t nixlRemoteSection::addDescList (
                                  const nixl_reg_dlist_t& mem_elms,
                                  nixlBackendEngine* backend) {
@@ -318,29 +399,67 @@ nixl_status_t nixlRemoteSection::addDescList (
     nixl_sec_dlist_t *target = sectionMap[sec_key];
 
 
-    // Add entries to the target list.
-    nixlSectionDesc out;
-    nixlBasicDesc *p = &out;
-    nixl_status_t ret;
+    // Find the entries not loaded yet, and load them in sorted order so they
+    // can be merged into the target list in one pass.
+    const nixl_sec_dlist_t &existing = *target;
+    std::vector<int> new_elms;
     for (int i=0; i<mem_elms.descCount(); ++i) {
         // TODO: Can add overlap checks (erroneous)
-        int idx = target->getIndex(mem_elms[i]);
+        int idx = existing.getIndex(mem_elms[i]);
         if (idx < 0) {
-            ret = backend->loadRemoteMD(mem_elms[i], nixl_mem, agentName, out.metadataP);
-            // In case of errors, no need to remove the previous entries
-            // Agent will delete the full object.
-            if (ret<0)
-                return ret;
-            *p = mem_elms[i]; // Copy the basic desc part
-            out.metaBlob = mem_elms[i].metaInfo;
-            target->addDesc(out);
-        } else {
-            const nixl_blob_t &prev_meta_info = (*target)[idx].metaBlob;
+            new_elms.push_back(i);
+        } else if (existing[idx].metaBlob != mem_elms[i].metaInfo) {
             // TODO: Support metadata updates
-            if (prev_meta_info != mem_elms[i].metaInfo)
-                return NIXL_ERR_NOT_ALLOWED;
+            return NIXL_ERR_NOT_ALLOWED;
+        }
+    }
+    std::stable_sort(new_elms.begin(), new_elms.end(),
+                     [&mem_elms](int a, int b) { return mem_elms[a] < mem_elms[b]; });
+
+    std::vector<nixlSectionDesc> loaded;
+    loaded.reserve(new_elms.size());
+    nixlSectionDesc out;
+    nixlBasicDesc *p = &out;
+    nixl_status_t ret = NIXL_SUCCESS;
+    for (size_t k=0; k<new_elms.size(); ++k) {
+        const nixlBlobDesc &elm = mem_elms[new_elms[k]];
+        if (k > 0) {
+            // Same descriptor repeated within this list
+            const nixlBlobDesc &prev = mem_elms[new_elms[k - 1]];
+            if (static_cast<const nixlBasicDesc &>(elm) ==
+                static_cast<const nixlBasicDesc &>(prev)) {
+                if (elm.metaInfo != prev.metaInfo) {
+                    ret = NIXL_ERR_NOT_ALLOWED;
+                    break;
+                }
+                continue;
+            }
+        }
+
+        if (lazy) {
+            out.metadataP = nullptr;
+        } else {
+            ret = backend->loadRemoteMD(elm, nixl_mem, agentName, out.metadataP);
+            if (ret<0)
+                break;
         }
+        *p = elm; // Copy the basic desc part
+        out.metaBlob = elm.metaInfo;
+        loaded.push_back(out);
     }
+
+    // Previous entries are deleted by the agent with the full object, but the
+    // ones loaded here are not in the target list yet.
+    if (ret<0) {
+        for (auto &elm : loaded)
+            if (elm.metadataP)
+                backend->unloadMD(elm.metadataP);
+        return ret;
+    }
+
+    if (lazy)
+        packedCount.fetch_add(loaded.size(), std::memory_order_release);
+    target->addDescs(std::move(loaded));
     return NIXL_SUCCESS;
 }
 
@@ -370,6 +489,76 @@ nixl_status_t nixlRemoteSection::loadRemoteData (nixlSerDes* deserializer,
     return NIXL_SUCCESS;
 }
 
+nixl_status_t nixlRemoteSection::remDescList (
+                                 const nixl_reg_dlist_t& mem_elms,
+                                 nixlBackendEngine* backend) {
+    nixl_mem_t nixl_mem   = mem_elms.getType();
+    section_key_t sec_key = std::make_pair(nixl_mem, backend);
+    auto it = sectionMap.find(sec_key);
+    if (it == sectionMap.end())
+        return NIXL_SUCCESS;
+    nixl_sec_dlist_t *target = it->second;
+
+    const nixl_sec_dlist_t &existing = *target;
+    std::vector<int> indices;
+    indices.reserve(mem_elms.descCount());
+    for (auto & elm : mem_elms) {
+        int index = existing.getIndex(elm);
+        if (index >= 0)
+            indices.push_back(index);
+    }
+
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+    // Called with the agent lock held exclusively, so no transfer is being posted or
+    // checked with this metadata, and requests created before are stale by then
+    size_t packed = 0;
+    for (int index : indices) {
+        if (existing[index].metadataP)
+            backend->unloadMD(existing[index].metadataP);
+        else
+            packed++;
+    }
+    if (packed)
+        packedCount.fetch_sub(packed, std::memory_order_release);
+    target->remDescs(std::move(indices));
+
+    if (target->descCount()==0) {
+        delete target;
+        sectionMap.erase(sec_key);
+        memToBackend[nixl_mem].erase(backend);
+    }
+
+    return NIXL_SUCCESS;
+}
+
+nixl_status_t nixlRemoteSection::loadRemoteDelta (nixlSerDes* deserializer,
+                                                  backend_map_t &backendToEngineMap) {
+    nixl_status_t ret;
+    size_t seg_count;
+    nixl_backend_t nixl_backend;
+
+    ret = deserializer->getBuf("nixlSecElms", &seg_count, sizeof(seg_count));
+    if (ret) return ret;
+
+    for (size_t i=0; i<seg_count; ++i) {
+        // In case of errors, agent will delete the full object
+        nixl_backend = deserializer->getStr("bknd");
+        if (nixl_backend.size()==0)
+            return NIXL_ERR_INVALID_PARAM;
+        nixl_reg_dlist_t s_desc(deserializer);
+        if (s_desc.descCount()==0)
+            return NIXL_ERR_NOT_FOUND;
+        if (backendToEngineMap.count(nixl_backend) != 0) {
+            ret = remDescList(s_desc, backendToEngineMap[nixl_backend]);
+            if (ret) return ret;
+        }
+    }
+
+    // Additions are laid out as in the full metadata
+    return loadRemoteData(deserializer, backendToEngineMap);
+}
+
 nixl_status_t nixlRemoteSection::loadLocalData (
                                  const nixl_sec_dlist_t& mem_elms,
                                  nixlBackendEngine* backend) {
@@ -386,17 +575,22 @@ nixl_status_t nixlRemoteSection::loadLocalData (
     memToBackend[nixl_mem].insert(backend); // Fine to overwrite, it's a set
     nixl_sec_dlist_t *target = sectionMap[sec_key];
 
-    for (auto & elm: mem_elms)
-        target->addDesc(elm);
+    // mem_elms is already sorted, so this is a single merge
+    target->addDescs(std::vector<nixlSectionDesc>(mem_elms.begin(), mem_elms.end()));
 
     return NIXL_SUCCESS;
 }
 
+nixl_status_t nixlRemoteSection::serialize(nixlSerDes* serializer) const {
+    return serializeSections(serializer, sectionMap, false);
+}
+
 nixlRemoteSection::~nixlRemoteSection() {
     for (auto &[sec_key, dlist] : sectionMap) {
         nixlBackendEngine* eng = sec_key.second;
         for (auto & elm : *dlist)
-            eng->unloadMD(elm.metadataP);
+            if (elm.metadataP)
+                eng->unloadMD(elm.metadataP);
         delete dlist;
     }
     // nixlMemSection destructor will clean up the rest
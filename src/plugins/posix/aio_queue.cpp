@@ -53,7 +53,7 @@ aioQueue::~aioQueue() {
 }
 
 nixl_status_t
-aioQueue::submit (const nixl_meta_dlist_t &, const nixl_meta_dlist_t &) {
+aioQueue::submit() {
     num_submitted = 0;
     // Submit all I/Os at once
     for (auto& aiocb : aiocbs) {
@@ -123,26 +123,31 @@ nixl_status_t aioQueue::checkCompleted() {
     return (num_completed == num_submitted) ? NIXL_SUCCESS : NIXL_IN_PROG;
 }
 
-nixl_status_t aioQueue::prepIO(int fd, void* buf, size_t len, off_t offset) {
+nixl_status_t aioQueue::prepIO(const nixlPosixIo &io) {
     // Find an unused control block
     for (auto& aiocb : aiocbs) {
         if (aiocb.aio_fildes == 0) {
             // Check if file descriptor is valid
-            if (fd < 0) {
+            if (io.fd < 0) {
                 NIXL_ERROR << "Invalid file descriptor provided to prepareIO";
                 return NIXL_ERR_BACKEND;
             }
 
             // Check buffer and length
-            if (!buf || len == 0) {
+            if (!io.buf || io.len == 0) {
                 NIXL_ERROR << "Invalid buffer or length provided to prepareIO";
                 return NIXL_ERR_BACKEND;
             }
 
-            aiocb.aio_fildes = fd;
-            aiocb.aio_buf = buf;
-            aiocb.aio_nbytes = len;
-            aiocb.aio_offset = offset;
+            if (!io.iov.empty()) {
+                NIXL_ERROR << "Vectored I/O is not supported by POSIX AIO";
+                return NIXL_ERR_NOT_SUPPORTED;
+            }
+
+            aiocb.aio_fildes = io.fd;
+            aiocb.aio_buf = io.buf;
+            aiocb.aio_nbytes = io.len;
+            aiocb.aio_offset = io.offset;
             return NIXL_SUCCESS;
         }
     }
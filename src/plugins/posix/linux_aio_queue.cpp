@@ -28,6 +28,7 @@ linuxAioQueue::linuxAioQueue(int num_entries, nixl_xfer_op_t operation)
       ios(num_entries),
       num_entries(num_entries),
       num_ios_to_submit(0),
+      iovecs(num_entries),
       completed(num_entries),
       num_completed(0),
       operation(operation) {
@@ -53,7 +54,7 @@ linuxAioQueue::~linuxAioQueue() {
 }
 
 nixl_status_t
-linuxAioQueue::submit(const nixl_meta_dlist_t &, const nixl_meta_dlist_t &) {
+linuxAioQueue::submit() {
     if (!num_ios_to_submit) {
         return NIXL_IN_PROG;
     }
@@ -108,35 +109,42 @@ linuxAioQueue::checkCompleted() {
 }
 
 nixl_status_t
-linuxAioQueue::prepIO(int fd, void *buf, size_t len, off_t offset) {
+linuxAioQueue::prepIO(const nixlPosixIo &io) {
     if (num_ios_to_submit == num_entries) {
         NIXL_ERROR << "No available IOs";
         return NIXL_ERR_BACKEND;
     }
 
     // Check if file descriptor is valid
-    if (fd < 0) {
+    if (io.fd < 0) {
         NIXL_ERROR << "Invalid file descriptor provided to prepareIO";
         return NIXL_ERR_BACKEND;
     }
 
     // Check buffer and length
-    if (!buf || len == 0) {
+    if (!io.buf || io.len == 0) {
         NIXL_ERROR << "Invalid buffer or length provided to prepareIO";
         return NIXL_ERR_BACKEND;
     }
 
     int idx = num_ios_to_submit;
-    auto io = &ios[idx];
+    auto iocb = &ios[idx];
 
-    if (operation == NIXL_READ) {
-        io_prep_pread(io, fd, buf, len, offset);
+    if (!io.iov.empty()) {
+        iovecs[idx] = io.iov;
+        if (operation == NIXL_READ) {
+            io_prep_preadv(iocb, io.fd, iovecs[idx].data(), iovecs[idx].size(), io.offset);
+        } else {
+            io_prep_pwritev(iocb, io.fd, iovecs[idx].data(), iovecs[idx].size(), io.offset);
+        }
+    } else if (operation == NIXL_READ) {
+        io_prep_pread(iocb, io.fd, io.buf, io.len, io.offset);
     } else {
-        io_prep_pwrite(io, fd, buf, len, offset);
+        io_prep_pwrite(iocb, io.fd, io.buf, io.len, io.offset);
     }
 
-    ios_to_submit[idx] = io;
-    io->data = (void *)(uintptr_t)idx;
+    ios_to_submit[idx] = iocb;
+    iocb->data = (void *)(uintptr_t)idx;
     num_ios_to_submit++;
 
     return NIXL_SUCCESS;
@@ -32,6 +32,7 @@ private:
     int num_entries; // Total number of entries expected
     std::vector<struct iocb *> ios_to_submit; // Array of I/Os to submit
     int num_ios_to_submit; // Total number of entries to submit
+    std::vector<std::vector<struct iovec>> iovecs; // Segments of vectored I/Os, live until completion
     std::vector<bool> completed; // Track completed I/Os
     int num_completed; // Number of completed operations
     nixl_xfer_op_t operation; // Whether this is a read operation
@@ -48,11 +49,11 @@ public:
     linuxAioQueue(int num_entries, nixl_xfer_op_t operation);
     ~linuxAioQueue();
     nixl_status_t
-    submit(const nixl_meta_dlist_t &, const nixl_meta_dlist_t &) override;
+    submit() override;
     nixl_status_t
     checkCompleted() override;
     nixl_status_t
-    prepIO(int fd, void *buf, size_t len, off_t offset) override;
+    prepIO(const nixlPosixIo &io) override;
 };
 
 #endif // LINUXAIO_QUEUE_H
@@ -18,16 +18,79 @@
 #include <iostream>
 #include <cmath>
 #include <errno.h>
+#include <limits.h>
 #include <stdexcept>
 #include "posix_backend.h"
 #include <absl/log/log.h>
+#include <absl/strings/numbers.h>
 #include <absl/strings/str_format.h>
 #include "common/nixl_log.h"
 #include "queue_factory_impl.h"
 #include "nixl_types.h"
 #include "file/file_utils.h"
 
+#ifdef HAVE_LIBURING
+#include "uring_queue.h"
+#endif
+
 namespace {
+    constexpr unsigned default_uring_ring_entries = 1024;
+    constexpr unsigned default_uring_window = 256;
+    constexpr unsigned default_uring_fixed_buffers = 1024;
+    constexpr unsigned default_uring_fixed_files = 1024;
+    constexpr unsigned default_uring_sqpoll_idle_ms = 1000;
+
+    // I/O planning limits. Split points stay page aligned so O_DIRECT transfers remain valid,
+    // and no single I/O gets close to the kernel's MAX_RW_COUNT, which would cause short I/O.
+    constexpr size_t io_split_align = 4096;
+    constexpr size_t default_io_split_size = 16 * 1024 * 1024;
+    constexpr size_t min_io_split_size = 1024 * 1024;
+    constexpr size_t max_io_size = 1024 * 1024 * 1024;
+
+    bool getBoolParam(const nixl_b_params_t *custom_params, const std::string &key) {
+        if (!custom_params) {
+            return false;
+        }
+
+        auto it = custom_params->find(key);
+        return it != custom_params->end() && (it->second == "true" || it->second == "1");
+    }
+
+    template<typename T>
+    T getParamOr(const nixl_b_params_t *custom_params, const std::string &key, T default_value) {
+        if (!custom_params) {
+            return default_value;
+        }
+
+        auto it = custom_params->find(key);
+        if (it == custom_params->end()) {
+            return default_value;
+        }
+
+        T result;
+        if (!absl::SimpleAtoi(it->second, &result)) {
+            NIXL_WARN << absl::StrFormat("Invalid value '%s' for POSIX parameter %s, using %d",
+                                         it->second, key, default_value);
+            return default_value;
+        }
+        return result;
+    }
+
+    nixlPosixPlanParams getPlanParams(const nixl_b_params_t *custom_params) {
+        nixlPosixPlanParams plan;
+        plan.merge = !custom_params || !custom_params->count("io_merge") ||
+            getBoolParam(custom_params, "io_merge");
+        plan.vectored = !custom_params || !custom_params->count("io_vectored") ||
+            getBoolParam(custom_params, "io_vectored");
+
+        size_t split_size = getParamOr(custom_params, "io_split_size", default_io_split_size);
+        split_size = std::min(split_size, max_io_size);
+        plan.split_size = std::max(split_size - split_size % io_split_align, io_split_align);
+
+        plan.target_depth = getParamOr(custom_params, "io_target_depth", 0);
+        return plan;
+    }
+
     bool isValidPrepXferParams(const nixl_xfer_op_t &operation,
                                const nixl_meta_dlist_t &local,
                                const nixl_meta_dlist_t &remote,
@@ -134,13 +197,17 @@ nixlPosixBackendReqH::nixlPosixBackendReqH(const nixl_xfer_op_t &op,
                                            const nixl_meta_dlist_t &loc,
                                            const nixl_meta_dlist_t &rem,
                                            const nixl_opt_b_args_t* args,
-                                           const nixl_b_params_t* params)
+                                           const nixl_b_params_t* params,
+                                           const nixlPosixPlanParams &plan_params,
+                                           const std::shared_ptr<UringRingPool> &uring_pool)
     : operation(op)
     , local(loc)
     , remote(rem)
     , opt_args(args)
     , custom_params_(params)
-    , queue_depth_(loc.descCount())
+    , plan_params_(plan_params)
+    , queue_depth_(0)
+    , uring_pool_(uring_pool)
     , queue_type_(getQueueType(params)) {
     if (queue_type_ == nixlPosixQueue::queue_t::UNSUPPORTED) {
         throw exception(absl::StrFormat("Unsupported queue type"), NIXL_ERR_NOT_SUPPORTED);
@@ -152,11 +219,7 @@ nixlPosixBackendReqH::nixlPosixBackendReqH(const nixl_xfer_op_t &op,
             NIXL_ERR_INVALID_PARAM);
     }
 
-    nixl_status_t status = initQueues();
-    if (status != NIXL_SUCCESS) {
-        throw exception(absl::StrFormat("Failed to initialize queues: %s", to_string(queue_type_)),
-                        status);
-    }
+    // The queue is sized by the I/O plan, it is created in prepXfer
 }
 
 
@@ -167,7 +230,7 @@ nixl_status_t nixlPosixBackendReqH::initQueues() {
                 queue = QueueFactory::createLinuxAioQueue(queue_depth_, operation);
                 break;
             case nixlPosixQueue::queue_t::URING:
-                queue = QueueFactory::createUringQueue(queue_depth_, operation);
+                queue = QueueFactory::createUringQueue(queue_depth_, operation, uring_pool_);
                 break;
             case nixlPosixQueue::queue_t::POSIXAIO:
                 queue = QueueFactory::createPosixAioQueue(queue_depth_, operation);
@@ -186,17 +249,101 @@ nixl_status_t nixlPosixBackendReqH::initQueues() {
     }
 }
 
-nixl_status_t nixlPosixBackendReqH::prepXfer() {
+void nixlPosixBackendReqH::planIOs(std::vector<nixlPosixIo> &ios, bool vectored) const {
+    // Merge descriptor pairs that continue the previous one both in memory and in the file
+    std::vector<nixlPosixIo> runs;
+    runs.reserve(local.descCount());
+    size_t total_len = 0;
     for (auto [local_it, remote_it] = std::make_pair(local.begin(), remote.begin());
          local_it != local.end() && remote_it != remote.end();
          ++local_it, ++remote_it) {
-        nixl_status_t status = queue->prepIO(
-            remote_it->devId,
-            reinterpret_cast<void*>(local_it->addr),
-            remote_it->len,
-            remote_it->addr
-        );
+        auto *buf_md = static_cast<const nixlPosixMetadata*>(local_it->metadataP);
+        auto *file_md = static_cast<const nixlPosixMetadata*>(remote_it->metadataP);
+        nixlPosixIo io{static_cast<int>(remote_it->devId),
+                       reinterpret_cast<void*>(local_it->addr),
+                       remote_it->len,
+                       static_cast<off_t>(remote_it->addr),
+                       buf_md ? buf_md->uring_slot : -1,
+                       file_md ? file_md->uring_slot : -1};
+        total_len += io.len;
+
+        if (plan_params_.merge && !runs.empty()) {
+            auto &prev = runs.back();
+            if (prev.fd == io.fd &&
+                static_cast<char*>(prev.buf) + prev.len == io.buf &&
+                prev.offset + static_cast<off_t>(prev.len) == io.offset) {
+                // A merged range spanning two registrations cannot use a fixed buffer
+                if (prev.buf_slot != io.buf_slot) {
+                    prev.buf_slot = -1;
+                }
+                prev.len += io.len;
+                continue;
+            }
+        }
+        runs.push_back(io);
+    }
 
+    // Split long runs, below split_size if needed to reach the target queue depth
+    size_t split_size = plan_params_.split_size;
+    if (plan_params_.target_depth > 0 &&
+        runs.size() < static_cast<size_t>(plan_params_.target_depth)) {
+        size_t spread = total_len / plan_params_.target_depth;
+        spread = std::max(spread - spread % io_split_align, min_io_split_size);
+        split_size = std::min(split_size, spread);
+    }
+
+    // Gather I/Os that continue the previous one in the file but not in memory into one
+    // vectored I/O, as long as it stays within split_size and the kernel's iovec limit
+    auto append = [&](nixlPosixIo &&io) {
+        if (vectored && !ios.empty()) {
+            auto &prev = ios.back();
+            size_t nr_segs = prev.iov.empty() ? 1 : prev.iov.size();
+            if (prev.fd == io.fd &&
+                prev.offset + static_cast<off_t>(prev.len) == io.offset &&
+                prev.len + io.len <= split_size &&
+                nr_segs < IOV_MAX) {
+                if (prev.iov.empty()) {
+                    prev.iov.push_back({prev.buf, prev.len});
+                    prev.buf_slot = -1;
+                }
+                prev.iov.push_back({io.buf, io.len});
+                prev.len += io.len;
+                return;
+            }
+        }
+        ios.push_back(std::move(io));
+    };
+
+    ios.reserve(runs.size() + total_len / split_size);
+    for (const auto &run : runs) {
+        for (size_t done = 0; done < run.len; done += split_size) {
+            nixlPosixIo io = run;
+            io.buf = static_cast<char*>(run.buf) + done;
+            io.len = std::min(split_size, run.len - done);
+            io.offset = run.offset + done;
+            append(std::move(io));
+        }
+    }
+}
+
+nixl_status_t nixlPosixBackendReqH::prepXfer() {
+    std::vector<nixlPosixIo> ios;
+    // POSIX AIO has no vectored operation
+    planIOs(ios, plan_params_.vectored && queue_type_ != nixlPosixQueue::queue_t::POSIXAIO);
+    if (ios.size() != static_cast<size_t>(local.descCount())) {
+        NIXL_DEBUG << absl::StrFormat("Planned %zu I/Os for %d descriptors",
+                                      ios.size(), local.descCount());
+    }
+
+    queue_depth_ = ios.size();
+    nixl_status_t status = initQueues();
+    if (status != NIXL_SUCCESS) {
+        NIXL_ERROR << absl::StrFormat("Failed to initialize queues: %s", to_string(queue_type_));
+        return status;
+    }
+
+    for (const auto &io : ios) {
+        status = queue->prepIO(io);
         if (status != NIXL_SUCCESS) {
             NIXL_ERROR << "Error preparing I/O operation";
             return status;
@@ -211,7 +358,7 @@ nixl_status_t nixlPosixBackendReqH::checkXfer() {
 }
 
 nixl_status_t nixlPosixBackendReqH::postXfer() {
-    return queue->submit (local, remote);
+    return queue->submit();
 }
 
 // -----------------------------------------------------------------------------
@@ -220,7 +367,8 @@ nixl_status_t nixlPosixBackendReqH::postXfer() {
 
 nixlPosixEngine::nixlPosixEngine(const nixlBackendInitParams* init_params)
     : nixlBackendEngine(init_params)
-    , queue_type_(getQueueType(init_params->customParams)) {
+    , queue_type_(getQueueType(init_params->customParams))
+    , plan_params_(getPlanParams(init_params->customParams)) {
     if (queue_type_ == nixlPosixQueue::queue_t::UNSUPPORTED) {
         initErr = true;
         NIXL_ERROR << absl::StrFormat(
@@ -228,6 +376,33 @@ nixlPosixEngine::nixlPosixEngine(const nixlBackendInitParams* init_params)
             to_string(queue_type_));
         return;
     }
+
+    if (queue_type_ == nixlPosixQueue::queue_t::URING) {
+        try {
+            const nixl_b_params_t *params = init_params->customParams;
+            uringConfig config;
+            config.ring_entries = getParamOr(params, "uring_ring_entries", default_uring_ring_entries);
+            config.window = getParamOr(params, "uring_window", default_uring_window);
+            config.fixed_buffers = getParamOr(params, "uring_fixed_buffers", default_uring_fixed_buffers);
+            config.fixed_files = getParamOr(params, "uring_fixed_files", default_uring_fixed_files);
+            config.sqpoll = getBoolParam(params, "uring_sqpoll");
+            config.sqpoll_cpu = getParamOr(params, "uring_sqpoll_cpu", -1);
+            config.sqpoll_idle_ms =
+                getParamOr(params, "uring_sqpoll_idle_ms", default_uring_sqpoll_idle_ms);
+            config.iopoll = getBoolParam(params, "uring_iopoll");
+            config.ring_per_request = getBoolParam(params, "uring_ring_per_request");
+            uring_pool_ = QueueFactory::createUringRingPool(config);
+            NIXL_INFO << absl::StrFormat("io_uring completion mode: %s%s",
+                                         config.iopoll ? "IOPOLL" : "interrupt",
+                                         config.sqpoll ? ", SQPOLL submission" : "");
+        }
+        catch (const std::exception &e) {
+            initErr = true;
+            NIXL_ERROR << absl::StrFormat("Failed to create io_uring ring pool: %s", e.what());
+            return;
+        }
+    }
+
     NIXL_INFO << absl::StrFormat("POSIX backend initialized using queue type: %s",
                                  to_string(queue_type_));
 }
@@ -236,13 +411,41 @@ nixl_status_t nixlPosixEngine::registerMem(const nixlBlobDesc &mem,
                                            const nixl_mem_t &nixl_mem,
                                            nixlBackendMD* &out) {
     auto supported_mems = getSupportedMems();
-    if (std::find(supported_mems.begin(), supported_mems.end(), nixl_mem) != supported_mems.end())
-        return NIXL_SUCCESS;
-
-    return NIXL_ERR_NOT_SUPPORTED;
+    if (std::find(supported_mems.begin(), supported_mems.end(), nixl_mem) == supported_mems.end())
+        return NIXL_ERR_NOT_SUPPORTED;
+
+    auto md = std::make_unique<nixlPosixMetadata>(nixl_mem);
+#ifdef HAVE_LIBURING
+    // Pin buffers and files once here so io_uring can use fixed-buffer/fixed-file opcodes.
+    // Running out of slots is not an error, such regions simply use the regular opcodes.
+    if (uring_pool_) {
+        if (nixl_mem == DRAM_SEG) {
+            md->uring_slot = uring_pool_->registerBuffer(reinterpret_cast<void*>(mem.addr), mem.len);
+        } else {
+            md->uring_slot = uring_pool_->registerFile(mem.devId);
+        }
+    }
+#endif
+    out = md.release();
+    return NIXL_SUCCESS;
 }
 
-nixl_status_t nixlPosixEngine::deregisterMem(nixlBackendMD *) {
+nixl_status_t nixlPosixEngine::deregisterMem(nixlBackendMD *meta) {
+    auto *md = static_cast<nixlPosixMetadata*>(meta);
+    if (!md) {
+        return NIXL_SUCCESS;
+    }
+
+#ifdef HAVE_LIBURING
+    if (uring_pool_ && md->uring_slot >= 0) {
+        if (md->type == DRAM_SEG) {
+            uring_pool_->unregisterBuffer(md->uring_slot);
+        } else {
+            uring_pool_->unregisterFile(md->uring_slot);
+        }
+    }
+#endif
+    delete md;
     return NIXL_SUCCESS;
 }
 
@@ -274,7 +477,8 @@ nixl_status_t nixlPosixEngine::prepXfer(const nixl_xfer_op_t &operation,
                 return NIXL_ERR_INVALID_PARAM;
         }
 
-        auto posix_handle = std::make_unique<nixlPosixBackendReqH>(operation, local, remote, opt_args, &params);
+        auto posix_handle = std::make_unique<nixlPosixBackendReqH>(
+            operation, local, remote, opt_args, &params, plan_params_, uring_pool_);
         nixl_status_t status = posix_handle->prepXfer();
         if (status != NIXL_SUCCESS) {
             return status;
@@ -25,6 +25,25 @@
 #include "backend/backend_engine.h"
 #include "posix_queue.h"
 
+class UringRingPool;
+
+class nixlPosixMetadata : public nixlBackendMD {
+    public:
+        nixl_mem_t type;
+        int        uring_slot;  // io_uring fixed buffer/file slot, -1 if not registered
+
+        nixlPosixMetadata(nixl_mem_t type) : nixlBackendMD(true), type(type), uring_slot(-1) { }
+        ~nixlPosixMetadata() { }
+};
+
+// How descriptor pairs of a transfer are turned into I/Os
+struct nixlPosixPlanParams {
+    bool   merge;        // Merge pairs contiguous both in memory and in the file
+    bool   vectored;     // Gather pairs contiguous only in the file into readv/writev
+    size_t split_size;   // Largest I/O issued, longer ranges are split
+    int    target_depth; // Split further until a transfer has this many I/Os, 0 to disable
+};
+
 class nixlPosixBackendReqH : public nixlBackendReqH {
 private:
     const nixl_xfer_op_t            &operation;      // The transfer operation (read/write)
@@ -32,18 +51,23 @@ private:
     const nixl_meta_dlist_t         &remote;         // Remote memory descriptor list
     const nixl_opt_b_args_t         *opt_args;       // Optional backend-specific arguments
     const nixl_b_params_t           *custom_params_; // Custom backend parameters
-    const int                       queue_depth_;    // Queue depth for async I/O
+    const nixlPosixPlanParams       plan_params_;    // Merge/split limits for the I/O plan
+    int                             queue_depth_;    // Queue depth for async I/O
+    const std::shared_ptr<UringRingPool> uring_pool_; // Engine rings borrowed by io_uring queues
     std::unique_ptr<nixlPosixQueue> queue;           // Async I/O queue instance
     const nixlPosixQueue::queue_t   queue_type_;     // Type of queue used
 
     nixl_status_t initQueues();                      // Initialize async I/O queue
+    void planIOs(std::vector<nixlPosixIo> &ios, bool vectored) const; // Turn descriptor pairs into I/Os
 
 public:
     nixlPosixBackendReqH(const nixl_xfer_op_t &operation,
                          const nixl_meta_dlist_t &local,
                          const nixl_meta_dlist_t &remote,
                          const nixl_opt_b_args_t* opt_args,
-                         const nixl_b_params_t* custom_params);
+                         const nixl_b_params_t* custom_params,
+                         const nixlPosixPlanParams &plan_params,
+                         const std::shared_ptr<UringRingPool> &uring_pool = nullptr);
     ~nixlPosixBackendReqH() {};
 
     nixl_status_t postXfer();
@@ -64,6 +88,9 @@ public:
 class nixlPosixEngine : public nixlBackendEngine {
 private:
     const nixlPosixQueue::queue_t queue_type_;
+    const nixlPosixPlanParams plan_params_;
+    // Long-lived io_uring rings shared by all requests, set only for the URING queue type
+    std::shared_ptr<UringRingPool> uring_pool_;
 
 public:
     nixlPosixEngine(const nixlBackendInitParams* init_params);
@@ -21,15 +21,28 @@
 #include "nixl_types.h"
 #include "backend/backend_aux.h"
 #include <sys/types.h>
+#include <sys/uio.h>
+#include <vector>
+
+// A single I/O planned from one or more descriptor pairs.
+// A vectored I/O covers a contiguous file range backed by the segments in iov, buf is the first one.
+struct nixlPosixIo {
+    int    fd;         // File descriptor of the FILE_SEG side
+    void   *buf;       // Start of the DRAM side
+    size_t len;        // Length of both sides
+    off_t  offset;     // Offset in the file
+    int    buf_slot;   // io_uring fixed buffer slot of the DRAM region, -1 if none
+    int    file_slot;  // io_uring fixed file slot of the file, -1 if none
+    std::vector<struct iovec> iov; // DRAM segments of a vectored I/O, empty for a single buffer
+};
 
 // Abstract base class for async I/O operations
 class nixlPosixQueue {
     public:
         virtual ~nixlPosixQueue() = default;
-        virtual nixl_status_t
-        submit (const nixl_meta_dlist_t &local, const nixl_meta_dlist_t &remote) = 0;
+        virtual nixl_status_t submit() = 0;
         virtual nixl_status_t checkCompleted() = 0;
-        virtual nixl_status_t prepIO(int fd, void* buf, size_t len, off_t offset) = 0;
+        virtual nixl_status_t prepIO(const nixlPosixIo &io) = 0;
 
         enum class queue_t {
             AIO,
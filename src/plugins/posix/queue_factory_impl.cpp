@@ -45,12 +45,15 @@ namespace {
 
     template <typename Mode>
     struct funcImpl<Mode, std::enable_if_t<std::is_same<Mode, uringEnabled>::value>> {
-        static std::unique_ptr<nixlPosixQueue> createUringQueue(int num_entries, nixl_xfer_op_t operation) {
-            // Initialize io_uring parameters with basic configuration
-            // Start with basic parameters, no special flags
-            // We can add optimizations like SQPOLL later
-            struct io_uring_params params = {};
-            return std::make_unique<class UringQueue>(num_entries, params, operation);
+        static std::unique_ptr<nixlPosixQueue>
+        createUringQueue(int num_entries,
+                         nixl_xfer_op_t operation,
+                         const std::shared_ptr<UringRingPool> &pool) {
+            return std::make_unique<class UringQueue>(num_entries, pool, operation);
+        }
+
+        static std::shared_ptr<UringRingPool> createUringRingPool(const uringConfig &config) {
+            return std::make_shared<UringRingPool>(config);
         }
 
         static bool isUringAvailable() {
@@ -60,13 +63,23 @@ namespace {
 
     template <typename Mode>
     struct funcImpl<Mode, std::enable_if_t<std::is_same<Mode, uringDisabled>::value>> {
-        static std::unique_ptr<nixlPosixQueue> createUringQueue(int num_entries, nixl_xfer_op_t operation) {
+        static std::unique_ptr<nixlPosixQueue>
+        createUringQueue(int num_entries,
+                         nixl_xfer_op_t operation,
+                         const std::shared_ptr<UringRingPool> &pool) {
             (void)num_entries;
             (void)operation;
+            (void)pool;
             throw nixlPosixBackendReqH::exception("Attempting to create io_uring queue when support is not compiled in",
                                                   NIXL_ERR_NOT_SUPPORTED);
         }
 
+        static std::shared_ptr<UringRingPool> createUringRingPool(const uringConfig &config) {
+            (void)config;
+            throw nixlPosixBackendReqH::exception("Attempting to create io_uring rings when support is not compiled in",
+                                                  NIXL_ERR_NOT_SUPPORTED);
+        }
+
         static bool isUringAvailable() {
             return false;
         }
@@ -79,8 +92,16 @@ QueueFactory::createPosixAioQueue(int num_entries, nixl_xfer_op_t operation) {
     return std::make_unique<aioQueue>(num_entries, operation);
 }
 
-std::unique_ptr<nixlPosixQueue> QueueFactory::createUringQueue(int num_entries, nixl_xfer_op_t operation) {
-    return funcImpl<uringMode>::createUringQueue(num_entries, operation);
+std::unique_ptr<nixlPosixQueue>
+QueueFactory::createUringQueue(int num_entries,
+                               nixl_xfer_op_t operation,
+                               const std::shared_ptr<UringRingPool> &pool) {
+    return funcImpl<uringMode>::createUringQueue(num_entries, operation, pool);
+}
+
+std::shared_ptr<UringRingPool>
+QueueFactory::createUringRingPool(const uringConfig &config) {
+    return funcImpl<uringMode>::createUringRingPool(config);
 }
 
 std::unique_ptr<nixlPosixQueue>
@@ -18,14 +18,36 @@
 #ifndef QUEUE_FACTORY_IMPL_H
 #define QUEUE_FACTORY_IMPL_H
 
+#include <memory>
 #include "posix_queue.h"
 
+// Only defined when io_uring support is compiled in
+class UringRingPool;
+
+// io_uring setup options, taken from the backend parameters
+struct uringConfig {
+    unsigned ring_entries;   // SQ entries of every ring
+    unsigned window;         // I/Os a single request keeps in flight, refilled as they complete
+    unsigned fixed_buffers;  // Fixed buffer slots of every ring
+    unsigned fixed_files;    // Fixed file slots of every ring
+    bool sqpoll;             // Kernel thread polls the SQ, submission needs no syscall
+    int sqpoll_cpu;          // CPU of the SQ polling thread, -1 to leave it unpinned
+    unsigned sqpoll_idle_ms; // Idle time before the SQ polling thread goes to sleep
+    bool iopoll;             // Busy-poll completions, requires O_DIRECT files
+    bool ring_per_request;   // Every request sets up its own ring instead, for comparison
+};
+
 namespace QueueFactory {
 std::unique_ptr<nixlPosixQueue>
 createPosixAioQueue(int num_entries, nixl_xfer_op_t operation);
 
 std::unique_ptr<nixlPosixQueue>
-createUringQueue(int num_entries, nixl_xfer_op_t operation);
+createUringQueue(int num_entries,
+                 nixl_xfer_op_t operation,
+                 const std::shared_ptr<UringRingPool> &pool);
+
+std::shared_ptr<UringRingPool>
+createUringRingPool(const uringConfig &config);
 
 std::unique_ptr<nixlPosixQueue>
 createLinuxAioQueue(int num_entries, nixl_xfer_op_t operation);
@@ -21,6 +21,7 @@
 #include <vector>
 #include <cstring>
 #include <stdexcept>
+#include <unordered_map>
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "common/nixl_log.h"
@@ -62,97 +63,496 @@ namespace {
     }
 }
 
-nixl_status_t UringQueue::init(int entries, const io_uring_params& params) {
+// -----------------------------------------------------------------------------
+// Shared ring
+// -----------------------------------------------------------------------------
+
+UringRing::UringRing(unsigned entries,
+                     const io_uring_params& params,
+                     unsigned nr_fixed_buffers,
+                     unsigned nr_fixed_files)
+    : iopoll(params.flags & IORING_SETUP_IOPOLL)
+    , in_flight(0)
+{
     // Initialize with basic setup - need a mutable copy since the API modifies the params
     io_uring_params mutable_params = params;
     if (io_uring_queue_init_params(entries, &uring, &mutable_params) < 0) {
         throw std::runtime_error(absl::StrFormat("Failed to initialize io_uring instance: %s", nixl_strerror(errno)));
     }
+    cq_entries = mutable_params.cq_entries;
 
     // Log the features supported by this io_uring instance
     NIXL_INFO << absl::StrFormat("io_uring features: %s", stringifyUringFeatures(mutable_params.features));
 
+    // Sparse fixed tables are filled in as memory gets registered. Without kernel support the
+    // tables stay empty and every I/O uses the regular opcodes.
+#ifdef HAVE_URING_SPARSE_REGISTER
+    if (nr_fixed_buffers) {
+        int ret = io_uring_register_buffers_sparse(&uring, nr_fixed_buffers);
+        if (ret < 0) {
+            NIXL_INFO << absl::StrFormat("io_uring fixed buffers unavailable: %s", nixl_strerror(-ret));
+        } else {
+            fixed_buffers.assign(nr_fixed_buffers, false);
+        }
+    }
+
+    if (nr_fixed_files) {
+        int ret = io_uring_register_files_sparse(&uring, nr_fixed_files);
+        if (ret < 0) {
+            NIXL_INFO << absl::StrFormat("io_uring fixed files unavailable: %s", nixl_strerror(-ret));
+        } else {
+            fixed_files.assign(nr_fixed_files, false);
+        }
+    }
+#else
+    (void)nr_fixed_buffers;
+    (void)nr_fixed_files;
+#endif
+}
+
+UringRing::~UringRing() {
+    io_uring_queue_exit(&uring);
+}
+
+struct io_uring_sqe* UringRing::getSqe() {
+    // Never have more I/Os outstanding than the CQ can hold, so no completion is dropped
+    if (in_flight >= cq_entries) {
+        return nullptr;
+    }
+
+    struct io_uring_sqe *sqe = io_uring_get_sqe(&uring);
+    if (!sqe && flush() == NIXL_SUCCESS) {
+        sqe = io_uring_get_sqe(&uring);
+    }
+    if (sqe) {
+        // Counted here rather than at submit time, with SQPOLL the kernel consumes SQEs on its own
+        in_flight++;
+    }
+    return sqe;
+}
+
+nixl_status_t UringRing::flush() {
+    // Polled rings need to enter the kernel even with an empty SQ to make completions progress
+    if (!io_uring_sq_ready(&uring) && !(iopoll && in_flight)) {
+        return NIXL_SUCCESS;
+    }
+
+    int ret = io_uring_submit(&uring);
+    if (ret < 0) {
+        NIXL_ERROR << absl::StrFormat("io_uring submit failed: %s", nixl_strerror(-ret));
+        return NIXL_ERR_BACKEND;
+    }
+    return NIXL_SUCCESS;
+}
+
+nixl_status_t UringRing::reap(bool wait) {
+    struct io_uring_cqe* cqe;
+    unsigned head;
+    unsigned count = 0;
+
+    if (flush() != NIXL_SUCCESS) {
+        return NIXL_ERR_BACKEND;
+    }
+
+    if (wait && in_flight) {
+        int ret = io_uring_wait_cqe(&uring, &cqe);
+        if (ret < 0) {
+            NIXL_ERROR << absl::StrFormat("io_uring wait failed: %s", nixl_strerror(-ret));
+            return NIXL_ERR_BACKEND;
+        }
+    }
+
+    // Get completion events and hand them over to the queue that issued them
+    io_uring_for_each_cqe(&uring, head, cqe) {
+        static_cast<UringQueue*>(io_uring_cqe_get_data(cqe))->complete(cqe->res);
+        count++;
+    }
+
+    // Mark all seen
+    io_uring_cq_advance(&uring, count);
+    in_flight -= count;
     return NIXL_SUCCESS;
 }
 
-UringQueue::UringQueue(int num_entries, const io_uring_params& params, nixl_xfer_op_t operation)
-    : num_entries(num_entries)
+void UringRing::updateBuffer(unsigned slot, const struct iovec& iov) {
+    if (slot >= fixed_buffers.size()) {
+        return;
+    }
+
+#ifdef HAVE_URING_SPARSE_REGISTER
+    // A region the kernel refuses (e.g. over RLIMIT_MEMLOCK) is just left out of the table
+    int ret = io_uring_register_buffers_update_tag(&uring, slot, &iov, nullptr, 1);
+    if (ret < 0) {
+        NIXL_DEBUG << absl::StrFormat("io_uring fixed buffer slot %u not updated: %s",
+                                      slot, nixl_strerror(-ret));
+    }
+    fixed_buffers[slot] = (ret >= 0) && iov.iov_base;
+#endif
+}
+
+void UringRing::updateFile(unsigned slot, int fd) {
+    if (slot >= fixed_files.size()) {
+        return;
+    }
+
+#ifdef HAVE_URING_SPARSE_REGISTER
+    int ret = io_uring_register_files_update(&uring, slot, &fd, 1);
+    if (ret < 0) {
+        NIXL_DEBUG << absl::StrFormat("io_uring fixed file slot %u not updated: %s",
+                                      slot, nixl_strerror(-ret));
+    }
+    fixed_files[slot] = (ret >= 0) && fd >= 0;
+#endif
+}
+
+namespace {
+    io_uring_params makeRingParams(const uringConfig& config) {
+        struct io_uring_params params = {};
+        if (config.sqpoll) {
+            params.flags |= IORING_SETUP_SQPOLL;
+            params.sq_thread_idle = config.sqpoll_idle_ms;
+            if (config.sqpoll_cpu >= 0) {
+                params.flags |= IORING_SETUP_SQ_AFF;
+                params.sq_thread_cpu = config.sqpoll_cpu;
+            }
+        }
+        if (config.iopoll) {
+            params.flags |= IORING_SETUP_IOPOLL;
+        }
+        return params;
+    }
+}
+
+UringRingPool::UringRingPool(const uringConfig& config)
+    : entries(config.ring_entries)
+    , window(config.window ? config.window : config.ring_entries)
+    , ring_per_request(config.ring_per_request)
+    , params(makeRingParams(config))
+    , sqpoll_fd(-1)
+    , buffers(config.fixed_buffers, iovec{nullptr, 0})
+    , files(config.fixed_files, -1)
+{
+    if (entries == 0) {
+        throw std::invalid_argument("Invalid number of entries for UringRingPool");
+    }
+
+    // Hand out low slots first
+    for (unsigned slot = config.fixed_buffers; slot > 0; --slot) {
+        free_buffers.push_back(slot - 1);
+    }
+    for (unsigned slot = config.fixed_files; slot > 0; --slot) {
+        free_files.push_back(slot - 1);
+    }
+}
+
+struct io_uring_params UringRingPool::ringParams() const {
+    struct io_uring_params ring_params = params;
+    if ((params.flags & IORING_SETUP_SQPOLL) && sqpoll_fd >= 0) {
+        // Share the SQ polling thread of the first ring instead of spawning one per ring
+        ring_params.flags |= IORING_SETUP_ATTACH_WQ;
+        ring_params.wq_fd = sqpoll_fd;
+    }
+    return ring_params;
+}
+
+UringRing& UringRingPool::getRing() {
+    // Rings taken by the calling thread, handed back to their pools when it exits
+    struct threadRings {
+        struct entry {
+            const UringRingPool* pool;
+            std::weak_ptr<UringRingPool> owner;
+            UringRing* ring;
+        };
+        std::vector<entry> list;
+
+        ~threadRings() {
+            for (const auto &e : list) {
+                if (auto pool = e.owner.lock()) {
+                    pool->releaseRing(e.ring);
+                }
+            }
+        }
+    };
+    thread_local threadRings local;
+
+    // A pool at the address of a destroyed one finds the old entry expired
+    for (const auto &e : local.list) {
+        if (e.pool == this && !e.owner.expired()) {
+            return *e.ring;
+        }
+    }
+    auto &list = local.list;
+    for (auto it = list.begin(); it != list.end();) {
+        it = it->owner.expired() ? list.erase(it) : it + 1;
+    }
+
+    UringRing* ring;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!idle_rings.empty()) {
+            // In-flight I/Os of the previous owner complete through the ring lock as before
+            ring = idle_rings.back();
+            idle_rings.pop_back();
+        } else {
+            rings.push_back(std::make_unique<UringRing>(entries, ringParams(),
+                                                        buffers.size(), files.size()));
+            ring = rings.back().get();
+            if (sqpoll_fd < 0) {
+                sqpoll_fd = ring->getFd();
+            }
+
+            // Bring the new ring up to date with everything registered so far
+            for (size_t slot = 0; slot < buffers.size(); ++slot) {
+                if (buffers[slot].iov_base) {
+                    ring->updateBuffer(slot, buffers[slot]);
+                }
+            }
+            for (size_t slot = 0; slot < files.size(); ++slot) {
+                if (files[slot] >= 0) {
+                    ring->updateFile(slot, files[slot]);
+                }
+            }
+        }
+    }
+
+    list.push_back({this, weak_from_this(), ring});
+    return *ring;
+}
+
+void UringRingPool::releaseRing(UringRing* ring) {
+    std::lock_guard<std::mutex> guard(lock);
+    idle_rings.push_back(ring);
+}
+
+std::unique_ptr<UringRing> UringRingPool::createRequestRing() {
+    std::lock_guard<std::mutex> guard(lock);
+    // Registrations are not mirrored into private rings, so they get no fixed tables
+    return std::make_unique<UringRing>(entries, ringParams(), 0, 0);
+}
+
+int UringRingPool::registerBuffer(void* addr, size_t len) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (free_buffers.empty() || !addr || !len) {
+        return -1;
+    }
+
+    int slot = free_buffers.back();
+    free_buffers.pop_back();
+    buffers[slot] = iovec{addr, len};
+    for (auto &ring : rings) {
+        std::lock_guard<std::mutex> ring_guard(ring->getLock());
+        ring->updateBuffer(slot, buffers[slot]);
+    }
+    return slot;
+}
+
+int UringRingPool::registerFile(int fd) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (free_files.empty() || fd < 0) {
+        return -1;
+    }
+
+    int slot = free_files.back();
+    free_files.pop_back();
+    files[slot] = fd;
+    for (auto &ring : rings) {
+        std::lock_guard<std::mutex> ring_guard(ring->getLock());
+        ring->updateFile(slot, fd);
+    }
+    return slot;
+}
+
+void UringRingPool::unregisterBuffer(int slot) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (slot < 0 || static_cast<size_t>(slot) >= buffers.size() || !buffers[slot].iov_base) {
+        return;
+    }
+
+    buffers[slot] = iovec{nullptr, 0};
+    for (auto &ring : rings) {
+        std::lock_guard<std::mutex> ring_guard(ring->getLock());
+        ring->updateBuffer(slot, buffers[slot]);
+    }
+    free_buffers.push_back(slot);
+}
+
+void UringRingPool::unregisterFile(int slot) {
+    std::lock_guard<std::mutex> guard(lock);
+    if (slot < 0 || static_cast<size_t>(slot) >= files.size() || files[slot] < 0) {
+        return;
+    }
+
+    files[slot] = -1;
+    for (auto &ring : rings) {
+        std::lock_guard<std::mutex> ring_guard(ring->getLock());
+        ring->updateFile(slot, -1);
+    }
+    free_files.push_back(slot);
+}
+
+// -----------------------------------------------------------------------------
+// Per-request queue
+// -----------------------------------------------------------------------------
+
+UringQueue::UringQueue(int num_entries,
+                       std::shared_ptr<UringRingPool> pool,
+                       nixl_xfer_op_t operation)
+    : pool(std::move(pool))
+    , ring(nullptr)
+    , num_entries(num_entries)
+    , window(static_cast<int>(this->pool ? this->pool->getWindow() : 0))
+    , num_submitted(0)
     , num_completed(0)
+    , io_status(NIXL_SUCCESS)
     , prep_op(operation == NIXL_READ ?
         reinterpret_cast<io_uring_prep_func_t>(io_uring_prep_read) :
         reinterpret_cast<io_uring_prep_func_t>(io_uring_prep_write))
+    , prep_fixed_op(operation == NIXL_READ ?
+        reinterpret_cast<io_uring_prep_fixed_func_t>(io_uring_prep_read_fixed) :
+        reinterpret_cast<io_uring_prep_fixed_func_t>(io_uring_prep_write_fixed))
+    , prep_vec_op(operation == NIXL_READ ?
+        reinterpret_cast<io_uring_prep_vec_func_t>(io_uring_prep_readv) :
+        reinterpret_cast<io_uring_prep_vec_func_t>(io_uring_prep_writev))
 {
     if (num_entries <= 0) {
         throw std::invalid_argument("Invalid number of entries for UringQueue");
     }
-
-    init(num_entries, params);
+    if (!this->pool) {
+        throw std::invalid_argument("UringQueue requires a ring pool");
+    }
+    if (this->pool->ringPerRequest()) {
+        own_ring = this->pool->createRequestRing();
+    }
+    ios.reserve(num_entries);
 }
 
 UringQueue::~UringQueue() {
-    io_uring_queue_exit(&uring);
-}
+    if (!ring) {
+        return;
+    }
 
-nixl_status_t
-UringQueue::submit (const nixl_meta_dlist_t &local, const nixl_meta_dlist_t &remote) {
-    for (auto [local_it, remote_it] = std::make_pair (local.begin(), remote.begin());
-         local_it != local.end() && remote_it != remote.end();
-         ++local_it, ++remote_it) {
-        int fd = remote_it->devId;
-        void *buf = reinterpret_cast<void *> (local_it->addr);
-        size_t len = local_it->len;
-        off_t offset = remote_it->addr;
+    // The ring outlives this queue, wait for our SQEs so no completion points to freed memory
+    std::lock_guard<std::mutex> guard(ring->getLock());
+    if (drain() != NIXL_SUCCESS) {
+        NIXL_ERROR << "Programming error: Destroying UringQueue with in-flight I/Os";
+    }
+}
 
-        struct io_uring_sqe *sqe = io_uring_get_sqe (&uring);
-        if (!sqe) {
-            NIXL_ERROR << "Failed to get io_uring submission queue entry";
+nixl_status_t UringQueue::drain() {
+    if (ring->flush() != NIXL_SUCCESS) {
+        return NIXL_ERR_BACKEND;
+    }
+    while (num_completed < num_submitted) {
+        if (ring->reap(true) != NIXL_SUCCESS) {
             return NIXL_ERR_BACKEND;
         }
-        prep_op (sqe, fd, buf, len, offset);
     }
+    return NIXL_SUCCESS;
+}
 
-    int ret = io_uring_submit(&uring);
-    if (ret != num_entries) {
-        if (ret < 0) {
-            NIXL_ERROR << absl::StrFormat("io_uring submit failed: %s", nixl_strerror(-ret));
+nixl_status_t UringQueue::refill() {
+    // Stop feeding the ring once an I/O has failed, the transfer is reported as failed anyway
+    while (num_submitted < num_entries &&
+           num_submitted - num_completed < window &&
+           io_status == NIXL_SUCCESS) {
+        // A full ring is not an error, other requests' completions will make room
+        struct io_uring_sqe *sqe = ring->getSqe();
+        if (!sqe) {
+            break;
+        }
+
+        const auto &io = ios[num_submitted];
+        bool fixed_file = ring->hasFixedFile(io.file_slot);
+        int fd = fixed_file ? io.file_slot : io.fd;
+
+        if (!io.iov.empty()) {
+            prep_vec_op (sqe, fd, io.iov.data(), io.iov.size(), io.offset);
+        } else if (ring->hasFixedBuffer(io.buf_slot)) {
+            prep_fixed_op (sqe, fd, io.buf, io.len, io.offset, io.buf_slot);
         } else {
-            NIXL_ERROR << absl::StrFormat("io_uring submit failed. Partial submission: %d/%d", num_entries, ret);
+            prep_op (sqe, fd, io.buf, io.len, io.offset);
+        }
+
+        if (fixed_file) {
+            io_uring_sqe_set_flags(sqe, IOSQE_FIXED_FILE);
+        }
+        io_uring_sqe_set_data(sqe, this);
+        num_submitted++;
+    }
+
+    return ring->flush();
+}
+
+nixl_status_t UringQueue::submit() {
+    // Completions of a previous post are counted on the ring it went to, so they have to be
+    // in before the counters are reset or the queue moves to the ring of this thread
+    if (ring) {
+        std::lock_guard<std::mutex> guard(ring->getLock());
+        if (drain() != NIXL_SUCCESS) {
+            NIXL_ERROR << "Failed to wait for the I/Os of the previous post";
+            return NIXL_ERR_BACKEND;
         }
-        return NIXL_ERR_BACKEND;
     }
+
+    ring = own_ring ? own_ring.get() : &pool->getRing();
+    std::lock_guard<std::mutex> guard(ring->getLock());
+
+    num_submitted = 0;
     num_completed = 0;
+    io_status = NIXL_SUCCESS;
+
+    if (refill() != NIXL_SUCCESS) {
+        return NIXL_ERR_BACKEND;
+    }
     return NIXL_IN_PROG;
 }
 
 nixl_status_t UringQueue::checkCompleted() {
-    if (num_completed == num_entries) {
-        return NIXL_SUCCESS;
+    if (!ring) {
+        return NIXL_IN_PROG;
     }
 
-    // Process all available completions
-    struct io_uring_cqe* cqe;
-    unsigned head;
-    unsigned count = 0;
+    // Completions of this queue may be reaped by any thread sharing the ring
+    std::lock_guard<std::mutex> guard(ring->getLock());
+    if (num_completed != num_entries) {
+        if (ring->reap(false) != NIXL_SUCCESS) {
+            return NIXL_ERR_BACKEND;
+        }
+        logOnPercentStep(num_completed, num_entries);
 
-    // Get completion events
-    io_uring_for_each_cqe(&uring, head, cqe) {
-        int res = cqe->res;
-        if (res < 0) {
-            NIXL_ERROR << absl::StrFormat("IO operation failed: %s", nixl_strerror(-res));
+        // Slide the window over the I/Os that did not fit so far
+        if (refill() != NIXL_SUCCESS) {
             return NIXL_ERR_BACKEND;
         }
-        count++;
     }
 
-    // Mark all seen
-    io_uring_cq_advance(&uring, count);
-    num_completed += count;
-
-    logOnPercentStep(num_completed, num_entries);
-
+    // A failure is only reported once no I/O of the queue is in flight, so the request can be
+    // reposted or released right away
+    if (io_status != NIXL_SUCCESS) {
+        return (num_completed == num_submitted) ? io_status : NIXL_IN_PROG;
+    }
     return (num_completed == num_entries) ? NIXL_SUCCESS : NIXL_IN_PROG;
 }
 
-nixl_status_t UringQueue::prepIO(int fd, void* buf, size_t len, off_t offset) {
+void UringQueue::complete(int res) {
+    if (res < 0) {
+        NIXL_ERROR << absl::StrFormat("IO operation failed: %s", nixl_strerror(-res));
+        io_status = NIXL_ERR_BACKEND;
+    }
+    num_completed++;
+}
+
+nixl_status_t UringQueue::prepIO(const nixlPosixIo &io) {
+    if (ios.size() == static_cast<size_t>(num_entries)) {
+        NIXL_ERROR << "No available IOs";
+        return NIXL_ERR_BACKEND;
+    }
+
+    if (io.fd < 0 || !io.buf || io.len == 0) {
+        NIXL_ERROR << "Invalid I/O provided to prepareIO";
+        return NIXL_ERR_BACKEND;
+    }
+
+    ios.push_back(io);
     return NIXL_SUCCESS;
 }
@@ -19,38 +19,149 @@
 #define URING_QUEUE_H
 
 #include <liburing.h>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "posix_queue.h"
+#include "queue_factory_impl.h"
 #include <absl/strings/str_format.h>
 
 // Forward declare Error class
 class nixlPosixBackendReqH;
+class UringQueue;
 
 // Type definition for io_uring prep functions
 typedef void (*io_uring_prep_func_t)(struct io_uring_sqe*, int, const void*, unsigned int, __u64);
+typedef void (*io_uring_prep_fixed_func_t)(struct io_uring_sqe*, int, const void*, unsigned int, __u64, int);
+typedef void (*io_uring_prep_vec_func_t)(struct io_uring_sqe*, int, const struct iovec*, unsigned int, __u64);
 
-class UringQueue : public nixlPosixQueue {
+// Long-lived io_uring instance shared by all queues submitting from the same thread.
+// Every SQE carries its owning UringQueue as user_data, so completions reaped by any
+// poller are dispatched back to the request they belong to.
+class UringRing {
     private:
         struct io_uring uring;         // The io_uring instance for async I/O operations
-        const int num_entries;         // Total number of entries expected in this ring
+        const bool iopoll;             // Completions are polled instead of interrupt driven
+        unsigned cq_entries;           // Completion queue capacity of the ring
+        unsigned in_flight;            // SQEs handed out and not reaped yet
+        std::mutex lock;               // Serializes SQ/CQ access between submitters and pollers
+        std::vector<bool> fixed_buffers; // Fixed buffer slots usable on this ring
+        std::vector<bool> fixed_files;   // Fixed file slots usable on this ring
+
+        // Delete copy and move operations to prevent accidental copying of kernel resources
+        UringRing(const UringRing&) = delete;
+        UringRing& operator=(const UringRing&) = delete;
+        UringRing(UringRing&&) = delete;
+        UringRing& operator=(UringRing&&) = delete;
+
+    public:
+        UringRing(unsigned entries,
+                  const struct io_uring_params& params,
+                  unsigned nr_fixed_buffers,
+                  unsigned nr_fixed_files);
+        ~UringRing();
+
+        std::mutex& getLock() { return lock; }
+        int getFd() const { return uring.ring_fd; }
+
+        // All methods below must be called with the ring lock held
+        struct io_uring_sqe* getSqe();   // Next free SQE, nullptr while the ring is full
+        nixl_status_t flush();           // Hand all queued SQEs to the kernel
+        nixl_status_t reap(bool wait);   // Dispatch available completions to their owners
+
+        // Install (or clear, with a null iov_base / fd -1) a fixed buffer or file slot
+        void updateBuffer(unsigned slot, const struct iovec& iov);
+        void updateFile(unsigned slot, int fd);
+
+        bool hasFixedBuffer(int slot) const {
+            return slot >= 0 && static_cast<size_t>(slot) < fixed_buffers.size() && fixed_buffers[slot];
+        }
+
+        bool hasFixedFile(int slot) const {
+            return slot >= 0 && static_cast<size_t>(slot) < fixed_files.size() && fixed_files[slot];
+        }
+};
+
+// Pool of rings owned by the POSIX engine, one per submitting thread.
+// Registered memory and files are mirrored into the fixed tables of every ring.
+// A thread keeps its ring until it exits, the ring then goes to the next thread needing one.
+class UringRingPool : public std::enable_shared_from_this<UringRingPool> {
+    private:
+        const unsigned entries;                    // Number of SQ entries of every ring
+        const unsigned window;                     // In-flight I/O limit of every request
+        const bool ring_per_request;               // Requests set up private rings instead
+        const struct io_uring_params params;       // Setup parameters of every ring
+        std::mutex lock;                           // Protects rings and the slot tables
+        std::vector<std::unique_ptr<UringRing>> rings; // All pooled rings, in use or idle
+        std::vector<UringRing*> idle_rings;        // Rings released by exited threads
+        int sqpoll_fd;                             // First ring, its SQPOLL thread is shared
+        std::vector<struct iovec> buffers;         // Registered buffer per fixed buffer slot
+        std::vector<int> files;                    // Registered fd per fixed file slot
+        std::vector<int> free_buffers;             // Unused fixed buffer slots
+        std::vector<int> free_files;               // Unused fixed file slots
+
+        // Setup parameters of a new ring, sharing the SQPOLL thread. Lock must be held.
+        struct io_uring_params ringParams() const;
+        // Hands the ring of an exiting thread to the next thread asking for one
+        void releaseRing(UringRing* ring);
+
+    public:
+        // Must be owned by a std::shared_ptr, threads hold weak references to it
+        explicit UringRingPool(const uringConfig& config);
+
+        // Ring of the calling thread, taken from the idle rings or created on first use
+        UringRing& getRing();
+
+        // Ring owned by a single request, without fixed buffers or files
+        std::unique_ptr<UringRing> createRequestRing();
+
+        unsigned getWindow() const { return window; }
+        bool ringPerRequest() const { return ring_per_request; }
+
+        // Return the assigned slot, or -1 if all slots are taken
+        int registerBuffer(void* addr, size_t len);
+        int registerFile(int fd);
+        void unregisterBuffer(int slot);
+        void unregisterFile(int slot);
+};
+
+class UringQueue : public nixlPosixQueue {
+    private:
+        const std::shared_ptr<UringRingPool> pool;  // Engine pool the ring is borrowed from
+        std::unique_ptr<UringRing> own_ring;         // Private ring in ring_per_request mode
+        UringRing* ring;               // Ring borrowed at submit time, or own_ring
+        const int num_entries;         // Total number of entries expected in this queue
+        std::vector<nixlPosixIo> ios;  // I/Os prepared for this queue
+        const int window;              // Maximum number of I/Os in flight at once
+        int num_submitted;             // Number of operations queued on the ring
         int num_completed;             // Number of completed operations so far
+        nixl_status_t io_status;       // First error reported by a completion, if any
         io_uring_prep_func_t prep_op;  // Pointer to prep function
+        io_uring_prep_fixed_func_t prep_fixed_op; // Pointer to fixed-buffer prep function
+        io_uring_prep_vec_func_t prep_vec_op;     // Pointer to vectored prep function
 
-        // Initialize the queue with the given parameters
-        nixl_status_t init(int num_entries, const struct io_uring_params& params);
-
-        // Delete copy and move operations to prevent accidental copying of kernel resources
+        // Delete copy and move operations, in-flight SQEs point to this object
         UringQueue(const UringQueue&) = delete;
         UringQueue& operator=(const UringQueue&) = delete;
         UringQueue(UringQueue&&) = delete;
         UringQueue& operator=(UringQueue&&) = delete;
 
+        // Queue the next I/Os on the ring, up to the window. Ring lock must be held.
+        nixl_status_t refill();
+        // Wait until all submitted I/Os completed. Ring lock must be held.
+        nixl_status_t drain();
+
     public:
-        UringQueue(int num_entries, const struct io_uring_params& params, nixl_xfer_op_t operation);
+        UringQueue(int num_entries,
+                   std::shared_ptr<UringRingPool> pool,
+                   nixl_xfer_op_t operation);
         ~UringQueue();
-        nixl_status_t
-        submit (const nixl_meta_dlist_t &local, const nixl_meta_dlist_t &remote) override;
+        nixl_status_t submit() override;
         nixl_status_t checkCompleted() override;
-        nixl_status_t prepIO(int fd, void* buf, size_t len, off_t offset) override;
+        nixl_status_t prepIO(const nixlPosixIo &io) override;
+
+        // Called by the ring, with its lock held, for every completion of this queue
+        void complete(int res);
 };
 
 #endif // URING_QUEUE_H
@@ -1480,19 +1480,20 @@ nixlUcxEngine::sendXferRange(const nixl_xfer_op_t &operation,
     intHandle->reserve(end_idx - start_idx + 2);
 
     for (size_t i = start_idx; i < end_idx; i++) {
-        void *laddr = (void*) local[i].addr;
-        size_t lsize = local[i].len;
-        uint64_t raddr = (uint64_t)remote[i].addr;
-        size_t rsize = remote[i].len;
-
-        lmd = (nixlUcxPrivateMetadata*) local[i].metadataP;
-        rmd = (nixlUcxPublicMetadata*) remote[i].metadataP;
-        auto &ep = rmd->conn->getEp(workerId);
+        const nixlMetaDesc &ldesc = local[i];
+        const nixlMetaDesc &rdesc = remote[i];
+        void *laddr = (void*) ldesc.addr;
+        size_t lsize = ldesc.len;
+        uint64_t raddr = (uint64_t)rdesc.addr;
 
-        if (lsize != rsize) {
+        if (lsize != rdesc.len) {
             return NIXL_ERR_INVALID_PARAM;
         }
 
+        lmd = (nixlUcxPrivateMetadata*) ldesc.metadataP;
+        rmd = (nixlUcxPublicMetadata*) rdesc.metadataP;
+        auto &ep = rmd->conn->getEp(workerId);
+
         switch (operation) {
         case NIXL_READ:
             ret = ep->read(raddr, rmd->getRkey(workerId), laddr, lmd->mem, lsize, req);
@@ -36,6 +36,9 @@ public:
 
     bool
     push(const T &item);
+    // Pushes as many of the items as fit with a single position update, returns how many
+    size_t
+    push_n(const T *items, size_t count);
     bool
     pop(T &item);
     size_t
@@ -17,6 +17,8 @@
 
 #include "cyclic_buffer.h"
 
+#include <algorithm>
+
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <fcntl.h>
@@ -61,6 +63,23 @@ sharedRingBuffer<T>::push(const T &item) {
     return true;
 }
 
+template<typename T>
+size_t
+sharedRingBuffer<T>::push_n(const T *items, size_t count) {
+    size_t write_pos = header_->write_pos.load(std::memory_order_relaxed);
+    size_t free = (header_->read_pos.load(std::memory_order_acquire) - write_pos - 1) &
+        header_->mask;
+    count = std::min(count, free);
+
+    // The range wraps at most once
+    size_t first = std::min(count, header_->capacity - write_pos);
+    std::copy(items, items + first, data_ + write_pos);
+    std::copy(items + first, items + count, data_);
+
+    header_->write_pos.store((write_pos + count) & header_->mask, std::memory_order_release);
+    return count;
+}
+
 template<typename T>
 bool
 sharedRingBuffer<T>::pop(T &item) {
@@ -0,0 +1,115 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _NIXL_LATENCY_HISTOGRAM_H
+#define _NIXL_LATENCY_HISTOGRAM_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class nixlLatencyHistogram
+ * @brief Log bucketed histogram of 64 bit values, in the style of HDR histograms.
+ *        Values below 32 have a bucket each, above that every power of 2 range is split
+ *        in 16 buckets, so a bucket spans at most 1/16 of its values. It only holds
+ *        atomics, so it can be placed in shared memory and read while it is recorded into.
+ */
+class nixlLatencyHistogram {
+public:
+    static constexpr unsigned sub_bucket_bits = 4;
+    static constexpr size_t sub_buckets = size_t(1) << sub_bucket_bits;
+    static constexpr size_t bucket_count = sub_buckets * (64 - sub_bucket_bits + 1);
+
+    static size_t
+    bucketOf(uint64_t value) {
+        if (value < 2 * sub_buckets) {
+            return value;
+        }
+        const unsigned shift = (63 - __builtin_clzll(value)) - sub_bucket_bits;
+        return sub_buckets * shift + (value >> shift);
+    }
+
+    // Highest value that falls in the bucket
+    static uint64_t
+    bucketMax(size_t bucket) {
+        if (bucket < 2 * sub_buckets) {
+            return bucket;
+        }
+        const unsigned shift = bucket / sub_buckets - 1;
+        const uint64_t sub_bucket = bucket - sub_buckets * shift;
+        return ((sub_bucket + 1) << shift) - 1;
+    }
+
+    void
+    record(uint64_t value) {
+        buckets_[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t max = max_.load(std::memory_order_relaxed);
+        while ((value > max) &&
+               !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t
+    count() const {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t
+    sum() const {
+        return sum_.load(std::memory_order_relaxed);
+    }
+
+    uint64_t
+    max() const {
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    // Value at or below which a fraction q of the recorded values fall, within 1/16
+    uint64_t
+    percentile(double q) const {
+        uint64_t total = 0;
+        for (const auto &bucket : buckets_) {
+            total += bucket.load(std::memory_order_relaxed);
+        }
+        if (total == 0) {
+            return 0;
+        }
+
+        const uint64_t rank = std::max<uint64_t>(1, std::ceil(q * total));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < bucket_count; ++i) {
+            seen += buckets_[i].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                return std::min(bucketMax(i), max());
+            }
+        }
+        return max();
+    }
+
+private:
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+    std::atomic<uint64_t> buckets_[bucket_count] = {};
+};
+
+#endif // _NIXL_LATENCY_HISTOGRAM_H
@@ -14,12 +14,19 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
+
 #include "serdes.h"
 #include "common/nixl_log.h"
 
+namespace {
+const std::string_view serdes_header = "nixlSerDes|";
+} // namespace
+
 nixlSerDes::nixlSerDes() {
-    workingStr = "nixlSerDes|";
-    des_offset = 11;
+    workingStr = std::string(serdes_header);
+    imported = false;
+    des_offset = serdes_header.size();
 
     mode = SERIALIZE;
 }
@@ -33,37 +40,52 @@ void nixlSerDes::_stringToBytes(void* fill_buf, const std::string &s, ssize_t si
     s.copy(reinterpret_cast<char*>(fill_buf), size);
 }
 
+bool nixlSerDes::matchTag(std::string_view tag, ssize_t offset) const {
+    std::string_view buf = readBuf();
+    return ((size_t)offset <= buf.size()) && (buf.substr(offset, tag.size()) == tag);
+}
+
+bool nixlSerDes::readLen(ssize_t offset, ssize_t &len) const {
+    std::string_view buf = readBuf();
+    if ((size_t)offset + sizeof(ssize_t) > buf.size())
+        return false;
+    memcpy(&len, buf.data() + offset, sizeof(ssize_t));
+    // Payload and the | delimiter have to be within the buffer
+    return (len >= 0) &&
+           ((size_t)len < buf.size() - offset - sizeof(ssize_t));
+}
+
 // Strings serialization
-nixl_status_t nixlSerDes::addStr(const std::string &tag, const std::string &str){
+nixl_status_t nixlSerDes::addStr(std::string_view tag, std::string_view str){
 
     size_t len = str.size();
 
     workingStr.append(tag);
-    workingStr.append(_bytesToString(&len, sizeof(size_t)));
+    workingStr.append(reinterpret_cast<const char*>(&len), sizeof(size_t));
     workingStr.append(str);
-    workingStr.append("|");
+    workingStr.push_back('|');
 
     return NIXL_SUCCESS;
 }
 
-std::string nixlSerDes::getStr(const std::string &tag){
+std::string nixlSerDes::getStr(std::string_view tag){
+    return std::string(getStrView(tag));
+}
+
+std::string_view nixlSerDes::getStrView(std::string_view tag){
 
-    if(workingStr.compare(des_offset, tag.size(), tag) != 0){
-        NIXL_ERROR << "Deserialization of tag " << tag << " failed";
-        return "";
-    }
     ssize_t len;
 
-    //skip tag
-    des_offset += tag.size();
+    if (!matchTag(tag, des_offset) || !readLen(des_offset + tag.size(), len)) {
+        NIXL_ERROR << "Deserialization of tag " << tag << " failed";
+        return {};
+    }
 
-    //get len
-    //_stringToBytes(&len, workingStr.data() + des_offset, sizeof(ssize_t));
-    _stringToBytes(&len, workingStr.substr(des_offset, sizeof(ssize_t)), sizeof(ssize_t));
-    des_offset += sizeof(ssize_t);
+    //skip tag and len
+    des_offset += tag.size() + sizeof(ssize_t);
 
-    //get string
-    std::string ret = workingStr.substr(des_offset, len);
+    //get string, pointing into the deserialized buffer
+    std::string_view ret = readBuf().substr(des_offset, len);
 
     //move past string plus | delimiter
     des_offset += len + 1;
@@ -74,66 +96,106 @@ std::string nixlSerDes::getStr(const std::string &tag){
 }
 
 // Byte buffers serialization
-nixl_status_t nixlSerDes::addBuf(const std::string &tag, const void* buf, ssize_t len){
+nixl_status_t nixlSerDes::addBuf(std::string_view tag, const void* buf, ssize_t len){
 
     workingStr.append(tag);
-    workingStr.append(_bytesToString(&len, sizeof(ssize_t)));
-    workingStr.append(_bytesToString(buf, len));
-    workingStr.append("|");
+    workingStr.append(reinterpret_cast<const char*>(&len), sizeof(ssize_t));
+    workingStr.append(reinterpret_cast<const char*>(buf), len);
+    workingStr.push_back('|');
 
     return NIXL_SUCCESS;
 }
 
-ssize_t nixlSerDes::getBufLen(const std::string &tag) const{
-    if(workingStr.compare(des_offset, tag.size(), tag) != 0){
+ssize_t nixlSerDes::getBufLen(std::string_view tag) const{
+    ssize_t len;
+
+    if (!matchTag(tag, des_offset) || !readLen(des_offset + tag.size(), len)) {
         NIXL_ERROR << "Deserialization of tag " << tag << " failed";
         return -1;
     }
 
-    ssize_t len;
-
-    //get len
-    //_stringToBytes(&len, workingStr.data() + des_offset + tag.size(), sizeof(ssize_t));
-    _stringToBytes(&len, workingStr.substr(des_offset + tag.size(), sizeof(ssize_t)), sizeof(ssize_t));
-
     if (len == 0) NIXL_WARN << "In deserialization of tag " << tag << " the buffer length ios 0";
 
     return len;
 }
 
-nixl_status_t nixlSerDes::getBuf(const std::string &tag, void *buf, ssize_t len){
-    if(workingStr.compare(des_offset, tag.size(), tag) != 0){
+nixl_status_t nixlSerDes::getBuf(std::string_view tag, void *buf, ssize_t len){
+    ssize_t stored_len;
+
+    if (!matchTag(tag, des_offset) || !readLen(des_offset + tag.size(), stored_len)) {
         NIXL_ERROR << "Deserialization of tag " << tag << " failed";
         return NIXL_ERR_MISMATCH;
     }
 
+    if (stored_len != len) {
+        NIXL_ERROR << "Deserialization of tag " << tag << " failed, expected " << len
+                   << " bytes but " << stored_len << " are stored";
+        return NIXL_ERR_MISMATCH;
+    }
+
     //skip over tag and size, which we assume has been read previously
     des_offset += tag.size() + sizeof(ssize_t);
 
-    //_stringToBytes(buf, workingStr.data() + des_offset, len);
-    _stringToBytes(buf, workingStr.substr(des_offset, len), len);
+    memcpy(buf, readBuf().data() + des_offset, len);
 
-    //bytes in string form are twice as long, skip those plus | delimiter
-    des_offset += len + 1;
+    //skip the buffer plus | delimiter
+    des_offset += stored_len + 1;
 
     return NIXL_SUCCESS;
 }
 
+bool nixlSerDes::hasTag(std::string_view tag) const {
+    ssize_t len;
+    return matchTag(tag, des_offset) && readLen(des_offset + tag.size(), len);
+}
+
+size_t nixlSerDes::remaining() const {
+    return readBuf().size() - std::min<size_t>(des_offset, readBuf().size());
+}
+
 // Buffer management serialization
-std::string nixlSerDes::exportStr() const {
+size_t nixlSerDes::fieldSize(std::string_view tag, size_t len) {
+    return tag.size() + sizeof(size_t) + len + 1;
+}
+
+void nixlSerDes::reserve(size_t len) {
+    workingStr.reserve(workingStr.size() + len);
+}
+
+std::string nixlSerDes::exportStr() const & {
     return workingStr;
 }
 
+std::string nixlSerDes::exportStr() && {
+    return std::move(workingStr);
+}
+
 nixl_status_t nixlSerDes::importStr(const std::string &sdbuf) {
 
-    if(sdbuf.compare(0, 11, "nixlSerDes|") != 0){
+    if(sdbuf.compare(0, serdes_header.size(), serdes_header) != 0){
         NIXL_ERROR << "Deserialization failed, missing nixlSerDes tag";
         return NIXL_ERR_MISMATCH;
     }
 
     workingStr = sdbuf;
+    imported = false;
+    mode = DESERIALIZE;
+    des_offset = serdes_header.size();
+
+    return NIXL_SUCCESS;
+}
+
+nixl_status_t nixlSerDes::importView(std::string_view sdbuf) {
+
+    if(sdbuf.substr(0, serdes_header.size()) != serdes_header){
+        NIXL_ERROR << "Deserialization failed, missing nixlSerDes tag";
+        return NIXL_ERR_MISMATCH;
+    }
+
+    importedStr = sdbuf;
+    imported = true;
     mode = DESERIALIZE;
-    des_offset = 11;
+    des_offset = serdes_header.size();
 
     return NIXL_SUCCESS;
 }
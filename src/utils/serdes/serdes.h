@@ -19,33 +19,58 @@
 
 #include <cstring>
 #include <string>
+#include <string_view>
 #include <cstdint>
 
 #include "nixl_types.h"
 
+/*
+ * Each field is written as: tag | length (size_t) | payload | '|', after the
+ * "nixlSerDes|" header that identifies the format version.
+ */
 class nixlSerDes {
 private:
     typedef enum { SERIALIZE, DESERIALIZE } ser_mode_t;
 
     std::string workingStr;
+    std::string_view importedStr; // Buffer given to importView, not owned
+    bool imported;
     ssize_t des_offset;
     ser_mode_t mode;
 
+    std::string_view readBuf() const {
+        return imported ? importedStr : std::string_view(workingStr);
+    }
+    bool matchTag(std::string_view tag, ssize_t offset) const;
+    bool readLen(ssize_t offset, ssize_t &len) const;
+
 public:
     nixlSerDes();
 
     /* Ser/Des for Strings */
-    nixl_status_t addStr(const std::string &tag, const std::string &str);
-    std::string getStr(const std::string &tag);
+    nixl_status_t addStr(std::string_view tag, std::string_view str);
+    std::string getStr(std::string_view tag);
+    // Same as getStr without a copy, valid as long as the deserialized buffer
+    std::string_view getStrView(std::string_view tag);
 
     /* Ser/Des for Byte buffers */
-    nixl_status_t addBuf(const std::string &tag, const void* buf, ssize_t len);
-    ssize_t getBufLen(const std::string &tag) const;
-    nixl_status_t getBuf(const std::string &tag, void *buf, ssize_t len);
+    nixl_status_t addBuf(std::string_view tag, const void* buf, ssize_t len);
+    ssize_t getBufLen(std::string_view tag) const;
+    nixl_status_t getBuf(std::string_view tag, void *buf, ssize_t len);
+
+    // Whether the next field has the given tag, for optional fields
+    bool hasTag(std::string_view tag) const;
+    // Bytes left to deserialize, bounds counts read from the buffer
+    size_t remaining() const;
 
     /* Ser/Des buffer management */
-    std::string exportStr() const;
+    static size_t fieldSize(std::string_view tag, size_t len);
+    void reserve(size_t len); // Room for len more bytes, see fieldSize
+    std::string exportStr() const &;
+    std::string exportStr() &&;
     nixl_status_t importStr(const std::string &sdbuf);
+    // Deserializes in place, sdbuf has to outlive the use of this object
+    nixl_status_t importView(std::string_view sdbuf);
 
     static std::string _bytesToString(const void *buf, ssize_t size);
     static void _stringToBytes(void* fill_buf, const std::string &s, ssize_t size);
@@ -61,6 +61,7 @@ class nixlMDStreamListener: public nixlMetadataStream {
 
         int         acceptClient();
         void        setupListener();
+        int         getListenerFd() const { return socketFd; }
         void        startListenerForClients();
         void        startListenerForClient();
         std::string recvFromClient();
@@ -32,6 +32,11 @@ GetMockBackendName() {
     return "MOCK_BACKEND";
 }
 
+constexpr const char *
+GetSecondMockBackendName() {
+    return "MOCK_BACKEND_2";
+}
+
 class Logger {
 public:
     Logger(const std::string &title = "INFO");
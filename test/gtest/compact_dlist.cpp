@@ -0,0 +1,212 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mem_section.h"
+#include "serdes/serdes.h"
+
+namespace gtest {
+namespace compact_dlist {
+
+    // Round trips of nixlSecDescList::serializeCompact through the nixlDescList
+    // deserializer, as remote agents load compact metadata
+    class compactDlistTest : public testing::Test {
+    protected:
+        static constexpr uintptr_t base_addr = 0x7f0000000000;
+        static constexpr size_t region_len = 65536;
+
+        nixlSecDescList sections_{VRAM_SEG};
+
+        void
+        add(uintptr_t addr, size_t len, uint64_t dev_id, const nixl_blob_t &blob) {
+            nixlSectionDesc desc(addr, len, dev_id);
+            desc.metaBlob = blob;
+            descs_.push_back(std::move(desc));
+        }
+
+        void
+        commit() {
+            sections_.addDescs(std::move(descs_));
+            descs_.clear();
+        }
+
+        // Serializes the whole list compactly and returns the exported buffer
+        std::string
+        exportCompact() const {
+            nixlSerDes ser;
+            EXPECT_EQ(sections_.serializeCompact(&ser), NIXL_SUCCESS);
+            return ser.exportStr();
+        }
+
+        std::string
+        exportDefault() const {
+            nixlSerDes ser;
+            EXPECT_EQ(sections_.serialize(&ser), NIXL_SUCCESS);
+            return ser.exportStr();
+        }
+
+        void
+        expectRoundTrip() const {
+            nixlSerDes des;
+            ASSERT_EQ(des.importStr(exportCompact()), NIXL_SUCCESS);
+            const nixl_reg_dlist_t loaded(&des);
+
+            ASSERT_EQ(loaded.getType(), sections_.getType());
+            ASSERT_EQ(loaded.descCount(), sections_.descCount());
+            for (int i = 0; i < sections_.descCount(); ++i) {
+                EXPECT_EQ(loaded[i].addr, sections_[i].addr) << "index " << i;
+                EXPECT_EQ(loaded[i].len, sections_[i].len) << "index " << i;
+                EXPECT_EQ(loaded[i].devId, sections_[i].devId) << "index " << i;
+                EXPECT_EQ(loaded[i].metaInfo, sections_[i].metaBlob) << "index " << i;
+            }
+        }
+
+        // Deserializes a compact list made of the given count and payload
+        static int
+        loadPayload(size_t n_desc, const std::string &payload) {
+            nixlSerDes ser;
+            const nixl_mem_t type = VRAM_SEG;
+            EXPECT_EQ(ser.addStr("nixlDList", "nixlCDList"), NIXL_SUCCESS);
+            EXPECT_EQ(ser.addBuf("t", &type, sizeof(type)), NIXL_SUCCESS);
+            EXPECT_EQ(ser.addBuf("n", &n_desc, sizeof(n_desc)), NIXL_SUCCESS);
+            EXPECT_EQ(ser.addStr("", payload), NIXL_SUCCESS);
+
+            nixlSerDes des;
+            EXPECT_EQ(des.importStr(ser.exportStr()), NIXL_SUCCESS);
+            return nixl_reg_dlist_t(&des).descCount();
+        }
+
+    private:
+        std::vector<nixlSectionDesc> descs_;
+    };
+
+    TEST_F(compactDlistTest, Empty) {
+        expectRoundTrip();
+    }
+
+    TEST_F(compactDlistTest, StridedRegions) {
+        // Back to back, equally sized regions sharing a blob, as registered KV blocks
+        constexpr size_t count = 4096;
+        for (size_t i = 0; i < count; ++i)
+            add(base_addr + i * region_len, region_len, 0, "rkey");
+        commit();
+        expectRoundTrip();
+
+        // All but the first one take 4 bytes, against a full descriptor and blob each
+        const std::string compact = exportCompact();
+        EXPECT_LT(compact.size(), count * 8);
+        EXPECT_LT(compact.size() * 4, exportDefault().size());
+    }
+
+    TEST_F(compactDlistTest, GapsAndVaryingLengths) {
+        // Gaps, shrinking and growing lengths, and regions overlapping the previous one,
+        // so addr and len deltas go both ways and span several varint bytes
+        std::mt19937_64 rng(0);
+        uintptr_t addr = base_addr;
+        for (size_t i = 0; i < 2000; ++i) {
+            const size_t len = 1 + rng() % (1 << 24);
+            add(addr, len, 0, "blob" + std::to_string(i % 3));
+            switch (rng() % 3) {
+            case 0:
+                addr += len;
+                break;
+            case 1:
+                addr += len + rng() % (1ULL << 40);
+                break;
+            default:
+                addr += len / 2;
+                break;
+            }
+        }
+        // Extreme values of the varint and zigzag ranges
+        add(0, 1, 0, "low");
+        add(UINTPTR_MAX - 1, 1, 0, "high");
+        commit();
+        expectRoundTrip();
+    }
+
+    TEST_F(compactDlistTest, DeduplicatedBlobs) {
+        // Blobs repeat out of order, including empty and binary ones
+        const std::vector<nixl_blob_t> blobs = {
+            "", std::string("\0\x80\xff", 3), std::string(300, 'x'), "rkey"};
+        for (size_t i = 0; i < 1000; ++i)
+            add(base_addr + i * region_len, region_len, 0, blobs[(i * 7) % blobs.size()]);
+        commit();
+        expectRoundTrip();
+
+        // Each blob is sent once, the other descriptors refer to it
+        EXPECT_LT(exportCompact().size(), 1000 * 8 + 300 + 16);
+    }
+
+    TEST_F(compactDlistTest, MultipleDevices) {
+        // Same addresses on several GPUs, and device ids needing multi byte varints
+        for (uint64_t dev_id : {0ULL, 1ULL, 7ULL, 200ULL, 1ULL << 40})
+            for (size_t i = 0; i < 64; ++i)
+                add(base_addr + i * region_len,
+                    region_len,
+                    dev_id,
+                    "dev" + std::to_string(dev_id));
+        commit();
+        expectRoundTrip();
+    }
+
+    TEST_F(compactDlistTest, MalformedInput) {
+        // A valid single descriptor: devId 0, addr delta, len delta, new 4 byte blob
+        std::string valid;
+        valid += '\0';
+        valid += "\x80\x80\x02"; // zigzag 0x8000 -> addr 0x4000
+        valid += "\x80\x40"; // zigzag 0x2000 -> len 0x1000
+        valid += '\0';
+        valid += '\x04';
+        valid += "rkey";
+        EXPECT_EQ(loadPayload(1, valid), 1);
+
+        // Truncated anywhere, including inside a varint and inside the blob
+        for (size_t len = 0; len < valid.size(); ++len)
+            EXPECT_EQ(loadPayload(1, valid.substr(0, len)), 0) << "length " << len;
+
+        // Trailing bytes, or fewer descriptors than announced
+        EXPECT_EQ(loadPayload(1, valid + '\0'), 0);
+        EXPECT_EQ(loadPayload(2, valid), 0);
+
+        // Reference to a blob that was not sent yet
+        std::string bad_ref = valid;
+        bad_ref += std::string("\0\0\0\x02", 4);
+        EXPECT_EQ(loadPayload(2, bad_ref), 0);
+        bad_ref = valid;
+        bad_ref += std::string("\0\0\0\x01", 4);
+        EXPECT_EQ(loadPayload(2, bad_ref), 2);
+
+        // Blob size beyond the payload
+        std::string bad_size = valid;
+        bad_size[7] = '\x05';
+        EXPECT_EQ(loadPayload(1, bad_size), 0);
+
+        // Varint longer than 64 bits
+        EXPECT_EQ(loadPayload(1, std::string(11, '\xff') + valid.substr(1)), 0);
+
+        // More descriptors than the payload can hold, rejected before reserving them
+        EXPECT_EQ(loadPayload(SIZE_MAX, valid), 0);
+        EXPECT_EQ(loadPayload(valid.size() / 4 + 1, valid), 0);
+    }
+
+} // namespace compact_dlist
+} // namespace gtest
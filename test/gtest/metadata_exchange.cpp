@@ -15,6 +15,10 @@
  * limitations under the License.
  */
 #include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
 #include <thread>
 #include <random>
 #include "nixl.h"
@@ -147,6 +151,28 @@ protected:
         }
     }
 
+    // Plain socket connected to the listener of an agent, -1 on failure
+    static int
+    connectRaw(const AgentContext &agent) {
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(agent.port);
+        inet_pton(AF_INET, agent.ip.c_str(), &addr.sin_addr);
+        const int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if ((fd != -1) && (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    // Message as the comm thread frames it, its size followed by its bytes
+    static std::string
+    commMessage(const std::string &body) {
+        const size_t size = body.size();
+        return std::string(reinterpret_cast<const char *>(&size), sizeof(size)) + body;
+    }
+
     static constexpr int AGENT_COUNT_ = 2;
 
     std::vector<AgentContext> agents_;
@@ -467,6 +493,80 @@ TEST_F(MetadataExchangeTestFixture, SocketSendLocalPartialWithErrors) {
     ASSERT_NE(dst.agent->checkRemoteMD(src.name, {DRAM_SEG}), NIXL_SUCCESS);
 }
 
+TEST_F(MetadataExchangeTestFixture, SocketPartialMessage) {
+    initAgentsDefault();
+
+    auto &src = agents_[0];
+    auto &dst = agents_[1];
+
+    auto sleep_time = std::chrono::milliseconds(500);
+    nixl_blob_t md;
+    ASSERT_EQ(src.agent->getLocalMD(md), NIXL_SUCCESS);
+
+    // Connect as a plain socket, to split the message where the agent does not
+    const int fd = connectRaw(dst);
+    ASSERT_NE(fd, -1);
+    const std::string msg = commMessage("NIXLCOMM:LOAD" + md);
+
+    // The first half of the message is kept until the rest arrives
+    const size_t half = msg.size() / 2;
+    ASSERT_EQ(send(fd, msg.data(), half, 0), static_cast<ssize_t>(half));
+    std::this_thread::sleep_for(sleep_time);
+    EXPECT_EQ(dst.agent->checkRemoteMD(src.name, {DRAM_SEG}), NIXL_ERR_NOT_FOUND);
+
+    ASSERT_EQ(send(fd, msg.data() + half, msg.size() - half, 0),
+              static_cast<ssize_t>(msg.size() - half));
+    std::this_thread::sleep_for(sleep_time);
+    EXPECT_EQ(dst.agent->checkRemoteMD(src.name, {DRAM_SEG}), NIXL_SUCCESS);
+
+    // A peer hanging up in the middle of a message is dropped, the agent keeps serving others
+    ASSERT_EQ(send(fd, msg.data(), half, 0), static_cast<ssize_t>(half));
+    close(fd);
+    std::this_thread::sleep_for(sleep_time);
+
+    nixl_opt_args_t send_args;
+    send_args.ipAddr = src.ip;
+    send_args.port = src.port;
+    ASSERT_EQ(dst.agent->sendLocalMD(&send_args), NIXL_SUCCESS);
+    std::this_thread::sleep_for(sleep_time);
+    EXPECT_EQ(src.agent->checkRemoteMD(dst.name, {DRAM_SEG}), NIXL_SUCCESS);
+}
+
+TEST_F(MetadataExchangeTestFixture, SocketIdleWithPartialMessage) {
+    initAgentsDefault();
+
+    auto &src = agents_[0];
+    auto &dst = agents_[1];
+
+    nixl_blob_t md;
+    ASSERT_EQ(src.agent->getLocalMD(md), NIXL_SUCCESS);
+
+    const int fd = connectRaw(dst);
+    ASSERT_NE(fd, -1);
+    const std::string msg = commMessage("NIXLCOMM:LOAD" + md);
+    const size_t half = msg.size() / 2;
+    ASSERT_EQ(send(fd, msg.data(), half, 0), static_cast<ssize_t>(half));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    // The comm threads wait in epoll for the rest, instead of polling the socket for it
+    auto cpu_time = []() {
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        return std::chrono::seconds(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+            std::chrono::microseconds(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+    };
+    const auto idle_time = std::chrono::seconds(1);
+    const auto cpu_start = cpu_time();
+    std::this_thread::sleep_for(idle_time);
+    EXPECT_LT(cpu_time() - cpu_start, idle_time / 10);
+
+    ASSERT_EQ(send(fd, msg.data() + half, msg.size() - half, 0),
+              static_cast<ssize_t>(msg.size() - half));
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    EXPECT_EQ(dst.agent->checkRemoteMD(src.name, {DRAM_SEG}), NIXL_SUCCESS);
+    close(fd);
+}
+
 TEST_F(MetadataExchangeTestFixture, LocalNonLocalMDExchange) {
     auto &src = agents_[0];
     auto &dst = agents_[1];
@@ -496,6 +596,195 @@ TEST_F(MetadataExchangeTestFixture, LocalNonLocalMDExchange) {
     ASSERT_EQ("agent_0", remote_name);
 }
 
+// Many agents on loopback, each sending its metadata to all the others at once
+class MetadataFanoutTest : public testing::Test {
+protected:
+    static constexpr size_t agent_count = 32;
+    static constexpr size_t buff_size = 1024;
+
+    struct fanoutAgent {
+        std::unique_ptr<nixlAgent> agent;
+        std::string name;
+        int port;
+        MemBuffer buffer{buff_size};
+    };
+
+    void
+    SetUp() override {
+        for (size_t i = 0; i < agent_count; i++) {
+            const auto port = PortAllocator::next_tcp_port();
+            std::string name = "agent_" + std::to_string(i);
+            nixlAgentConfig cfg(false, true, port, nixl_thread_sync_t::NIXL_THREAD_SYNC_STRICT);
+
+            agents_.push_back({std::make_unique<nixlAgent>(name, cfg), std::move(name), port});
+
+            nixlBackendH *backend;
+            ASSERT_EQ(agents_.back().agent->createBackend("UCX", {}, backend), NIXL_SUCCESS);
+            nixl_reg_dlist_t dlist(DRAM_SEG);
+            dlist.addDesc(agents_.back().buffer.getBlobDesc());
+            ASSERT_EQ(agents_.back().agent->registerMem(dlist), NIXL_SUCCESS);
+        }
+    }
+
+    void
+    TearDown() override {
+        agents_.clear();
+    }
+
+    bool
+    allLoaded() const {
+        for (const auto &dst : agents_) {
+            for (const auto &src : agents_) {
+                if ((&src != &dst) &&
+                    (dst.agent->checkRemoteMD(src.name, {DRAM_SEG}) != NIXL_SUCCESS)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Time until every agent has loaded the metadata of every other agent
+    std::chrono::steady_clock::duration
+    bootstrap(unsigned int fanout_degree) {
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto &src : agents_) {
+            nixl_opt_args_t send_args;
+            send_args.fanoutDegree = fanout_degree;
+            for (const auto &dst : agents_) {
+                if (&src != &dst) {
+                    send_args.peers.emplace_back("127.0.0.1", dst.port);
+                }
+            }
+            EXPECT_EQ(src.agent->sendLocalMD(&send_args), NIXL_SUCCESS);
+        }
+
+        const auto deadline = start + std::chrono::seconds(30);
+        while (!allLoaded() && (std::chrono::steady_clock::now() < deadline)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return std::chrono::steady_clock::now() - start;
+    }
+
+    void
+    logBootstrap(const std::string &what, std::chrono::steady_clock::duration elapsed) {
+        Logger("PERF") << agent_count << " agents, " << what << ": "
+                       << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+                       << " ms to bootstrap";
+    }
+
+    // Plain socket standing for a fan-out peer, to see what the sender connects to and sends
+    class rawPeer {
+    public:
+        explicit rawPeer(bool listening) : port_(PortAllocator::next_tcp_port()) {
+            if (!listening) {
+                return;
+            }
+
+            sockaddr_in addr = {};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(port_);
+            inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+            fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+            const int one = 1;
+            setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            EXPECT_EQ(bind(fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)), 0);
+            EXPECT_EQ(listen(fd_, 8), 0);
+        }
+
+        ~rawPeer() {
+            for (const int conn : conns_) {
+                close(conn);
+            }
+            if (fd_ != -1) {
+                close(fd_);
+            }
+        }
+
+        // Number of connections accepted so far
+        size_t
+        accepted() {
+            int conn;
+            while ((fd_ != -1) && ((conn = accept(fd_, nullptr, nullptr)) != -1)) {
+                const timeval timeout = {5, 0};
+                setsockopt(conn, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+                conns_.push_back(conn);
+            }
+            return conns_.size();
+        }
+
+        // First message sent on the first accepted connection
+        std::string
+        receive() const {
+            size_t size = 0;
+            if (conns_.empty() ||
+                (recv(conns_[0], &size, sizeof(size), MSG_WAITALL) != sizeof(size))) {
+                return {};
+            }
+            std::string msg(size, '\0');
+            if (recv(conns_[0], msg.data(), size, MSG_WAITALL) != static_cast<ssize_t>(size)) {
+                return {};
+            }
+            return msg;
+        }
+
+        std::string
+        address() const {
+            return "127.0.0.1:" + std::to_string(port_);
+        }
+
+        int
+        port() const {
+            return port_;
+        }
+
+    private:
+        int port_;
+        int fd_ = -1;
+        std::vector<int> conns_;
+    };
+
+    std::vector<fanoutAgent> agents_;
+};
+
+TEST_F(MetadataFanoutTest, DirectBootstrap) {
+    logBootstrap("direct", bootstrap(0));
+    EXPECT_TRUE(allLoaded());
+}
+
+TEST_F(MetadataFanoutTest, TreeBootstrap) {
+    logBootstrap("tree of degree 2", bootstrap(2));
+    EXPECT_TRUE(allLoaded());
+
+    // The sender only connects to the head of each group and forwards it the rest of the
+    // group. The first head is not listening, so its group goes to the next peer.
+    std::vector<std::unique_ptr<rawPeer>> peers;
+    nixl_opt_args_t send_args;
+    send_args.fanoutDegree = 2;
+    for (size_t i = 0; i < 8; i++) {
+        peers.push_back(std::make_unique<rawPeer>(i != 0));
+        send_args.peers.emplace_back("127.0.0.1", peers.back()->port());
+    }
+    ASSERT_EQ(agents_[0].agent->sendLocalMD(&send_args), NIXL_SUCCESS);
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (((peers[1]->accepted() == 0) || (peers[4]->accepted() == 0)) &&
+           (std::chrono::steady_clock::now() < deadline)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    for (size_t i = 0; i < peers.size(); i++) {
+        EXPECT_EQ(peers[i]->accepted(), ((i == 1) || (i == 4)) ? 1 : 0) << "peer " << i;
+    }
+
+    const std::string forward_1 =
+        "NIXLCOMM:FWRD2|" + peers[2]->address() + "," + peers[3]->address() + "|";
+    const std::string forward_4 = "NIXLCOMM:FWRD2|" + peers[5]->address() + "," +
+        peers[6]->address() + "," + peers[7]->address() + "|";
+    EXPECT_EQ(peers[1]->receive().rfind(forward_1, 0), 0);
+    EXPECT_EQ(peers[4]->receive().rfind(forward_4, 0), 0);
+}
+
 TEST_F(MetadataExchangeTestFixture, EtcdSendLocalAndFetchRemote) {
     VERIFY_ETCD_MODE();
     initAgentsDefault();
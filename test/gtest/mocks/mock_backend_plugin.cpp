@@ -32,7 +32,11 @@ namespace backend_plugin {
 
     static const char *
     get_plugin_name() {
+#ifdef MOCK_BACKEND_SECOND
+        return gtest::GetSecondMockBackendName();
+#else
         return gtest::GetMockBackendName();
+#endif
     }
 
     static const char *
@@ -0,0 +1,102 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+
+#include "nixl.h"
+#include "common.h"
+#include "mocks/gmock_engine.h"
+
+namespace gtest {
+namespace registration_perf {
+
+    // Measures the agent cost per descriptor of a large registration, and of loading the
+    // resulting metadata in a remote agent. Descriptors are added in descending address
+    // order, which is the worst case for per element sorted insertion. The measurement is
+    // disabled by default, the unit suite runs the same steps on a few descriptors.
+    class registrationPerfTest : public testing::Test {
+    protected:
+        static constexpr size_t len = 4096;
+        static constexpr uintptr_t base_addr = 0x100000;
+
+        testing::NiceMock<mocks::GMockBackendEngine> gmock_engine_;
+
+        static void
+        logPerDesc(const std::string &what,
+                   size_t desc_count,
+                   std::chrono::steady_clock::duration elapsed) {
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            Logger("PERF") << what << ": " << desc_count << " descriptors, " << ns / desc_count
+                           << " ns per descriptor";
+        }
+
+        void
+        registerAndLoadRemote(size_t desc_count) {
+            nixlAgent local_agent("RegPerfLocal", nixlAgentConfig(false));
+            nixlAgent remote_agent("RegPerfRemote", nixlAgentConfig(false));
+
+            nixl_b_params_t params;
+            gmock_engine_.SetToParams(params);
+            nixlBackendH *local_backend = nullptr, *remote_backend = nullptr;
+            ASSERT_EQ(local_agent.createBackend(GetMockBackendName(), params, local_backend),
+                      NIXL_SUCCESS);
+            ASSERT_EQ(remote_agent.createBackend(GetMockBackendName(), params, remote_backend),
+                      NIXL_SUCCESS);
+
+            nixl_reg_dlist_t reg_list(DRAM_SEG);
+            for (size_t i = desc_count; i > 0; --i)
+                reg_list.addDesc(nixlBlobDesc(base_addr + (i - 1) * len, len, 0, ""));
+
+            nixl_opt_args_t extra_params;
+            extra_params.backends = {local_backend};
+
+            auto start = std::chrono::steady_clock::now();
+            ASSERT_EQ(local_agent.registerMem(reg_list, &extra_params), NIXL_SUCCESS);
+            logPerDesc("registerMem", desc_count, std::chrono::steady_clock::now() - start);
+
+            nixl_blob_t md;
+            ASSERT_EQ(local_agent.getLocalMD(md), NIXL_SUCCESS);
+
+            std::string loaded_name;
+            start = std::chrono::steady_clock::now();
+            ASSERT_EQ(remote_agent.loadRemoteMD(md, loaded_name), NIXL_SUCCESS);
+            logPerDesc("loadRemoteMD", desc_count, std::chrono::steady_clock::now() - start);
+            EXPECT_EQ(loaded_name, "RegPerfLocal");
+
+            // Every descriptor, registered out of order, is found in the remote metadata
+            nixl_xfer_dlist_t xfer_list(DRAM_SEG);
+            for (size_t i = 0; i < desc_count; ++i)
+                xfer_list.addDesc(nixlBasicDesc(base_addr + i * len, len, 0));
+            EXPECT_EQ(remote_agent.checkRemoteMD(loaded_name, xfer_list), NIXL_SUCCESS);
+
+            EXPECT_EQ(remote_agent.invalidateRemoteMD(loaded_name), NIXL_SUCCESS);
+            EXPECT_EQ(local_agent.deregisterMem(reg_list, &extra_params), NIXL_SUCCESS);
+        }
+    };
+
+    TEST_F(registrationPerfTest, RegisterAndLoadRemote) {
+        registerAndLoadRemote(1000);
+    }
+
+    TEST_F(registrationPerfTest, DISABLED_RegisterAndLoadRemoteLarge) {
+        registerAndLoadRemote(1000000);
+    }
+
+} // namespace registration_perf
+} // namespace gtest
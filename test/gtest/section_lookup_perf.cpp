@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common.h"
+#include "mem_section.h"
+
+namespace gtest {
+namespace section_lookup_perf {
+
+    // Measures the covering lookup used by nixlMemSection::populate, with a large section
+    // list (one entry per registered KV block) and transfers made of blocks in random
+    // order, as produced by paged attention block tables. The measurement is disabled by
+    // default, the unit suite checks the same lookups on a small section list.
+    class sectionLookupPerfTest : public testing::Test {
+    protected:
+        static constexpr size_t region_len = 65536;
+        static constexpr size_t block_len = 4096;
+        static constexpr uintptr_t base_addr = 0x100000;
+
+        nixlSecDescList sections_{DRAM_SEG};
+        nixl_xfer_dlist_t random_blocks_{DRAM_SEG};
+        nixl_xfer_dlist_t sequential_blocks_{DRAM_SEG};
+
+        void
+        addSections(size_t section_count, size_t block_count) {
+            std::vector<nixlSectionDesc> descs(section_count);
+            for (size_t i = 0; i < section_count; ++i)
+                static_cast<nixlBasicDesc &>(descs[i]) =
+                    nixlBasicDesc(base_addr + i * region_len, region_len, 0);
+            sections_.addDescs(std::move(descs));
+
+            std::mt19937_64 rng(0);
+            for (size_t i = 0; i < block_count; ++i) {
+                const size_t region = rng() % section_count;
+                const size_t offset = (rng() % (region_len / block_len)) * block_len;
+                random_blocks_.addDesc(
+                    nixlBasicDesc(base_addr + region * region_len + offset, block_len, 0));
+                sequential_blocks_.addDesc(nixlBasicDesc(base_addr + i * block_len, block_len, 0));
+            }
+        }
+
+        void
+        logPerDesc(const std::string &what, std::chrono::steady_clock::duration elapsed) const {
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            Logger("PERF") << what << ": " << ns / random_blocks_.descCount()
+                           << " ns per descriptor";
+        }
+
+        void
+        coveringLookup(size_t section_count, size_t block_count) {
+            addSections(section_count, block_count);
+
+            std::vector<int> indices;
+            // First lookup builds the search index
+            sections_.getCoveringIndices(random_blocks_, indices);
+
+            size_t mismatches = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < block_count; ++i)
+                mismatches += sections_.getCoveringIndex(random_blocks_[i]) != indices[i];
+            logPerDesc("random, one by one", std::chrono::steady_clock::now() - start);
+            EXPECT_EQ(mismatches, 0u);
+
+            start = std::chrono::steady_clock::now();
+            sections_.getCoveringIndices(random_blocks_, indices);
+            logPerDesc("random, batched", std::chrono::steady_clock::now() - start);
+
+            start = std::chrono::steady_clock::now();
+            sections_.getCoveringIndices(sequential_blocks_, indices);
+            logPerDesc("sequential, batched", std::chrono::steady_clock::now() - start);
+
+            const nixlSecDescList &sections = sections_;
+            for (size_t i = 0; i < block_count; ++i) {
+                ASSERT_GE(indices[i], 0);
+                EXPECT_TRUE(sections[indices[i]].covers(sequential_blocks_[i]));
+            }
+        }
+    };
+
+    TEST_F(sectionLookupPerfTest, CoveringLookup) {
+        coveringLookup(1000, 500);
+    }
+
+    TEST_F(sectionLookupPerfTest, DISABLED_CoveringLookupLarge) {
+        coveringLookup(200000, 100000);
+    }
+
+    TEST_F(sectionLookupPerfTest, UncoveredAfterChange) {
+        addSections(1000, 0);
+        const nixlBasicDesc first_block(base_addr, block_len, 0);
+        ASSERT_EQ(sections_.getCoveringIndex(first_block), 0);
+
+        std::vector<int> indices;
+        sections_.remDesc(0);
+        nixl_xfer_dlist_t query(DRAM_SEG);
+        query.addDesc(first_block);
+        query.addDesc(nixlBasicDesc(base_addr + region_len, block_len, 0));
+        sections_.getCoveringIndices(query, indices);
+        ASSERT_EQ(indices.size(), 2u);
+        EXPECT_EQ(indices[0], -1);
+        EXPECT_EQ(indices[1], 0);
+    }
+
+} // namespace section_lookup_perf
+} // namespace gtest
@@ -0,0 +1,113 @@
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2025 NVIDIA CORPORATION & AFFILIATES. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <string>
+
+#include "nixl.h"
+#include "common.h"
+#include "mocks/gmock_engine.h"
+
+namespace gtest {
+namespace sync_mode_perf {
+
+    // Measures the agent overhead of postXferReq + getXferStatus in each thread sync mode.
+    // The mock backend returns immediately, so the difference between modes is the cost of
+    // the agent locking on the transfer path. The measurement is disabled by default, the
+    // unit suite runs a few iterations per mode.
+    class syncModePerfTest : public testing::TestWithParam<nixl_thread_sync_t> {
+    protected:
+        static constexpr const char *agent_name = "SyncModePerfAgent";
+
+        testing::NiceMock<mocks::GMockBackendEngine> gmock_engine_;
+        uintptr_t addr_ = 0x1000;
+        size_t len_ = 1024;
+
+        static std::string
+        modeStr(nixl_thread_sync_t mode) {
+            switch (mode) {
+            case nixl_thread_sync_t::NIXL_THREAD_SYNC_NONE:
+                return "NONE";
+            case nixl_thread_sync_t::NIXL_THREAD_SYNC_STRICT:
+                return "STRICT";
+            case nixl_thread_sync_t::NIXL_THREAD_SYNC_RW:
+                return "RW";
+            }
+            return "UNKNOWN";
+        }
+
+        void
+        postAndStatus(size_t iterations) {
+            nixlAgentConfig cfg(false, false, 0, GetParam());
+            nixlAgent agent(agent_name, cfg);
+
+            nixl_b_params_t params;
+            nixlBackendH *backend = nullptr;
+            gmock_engine_.SetToParams(params);
+            ASSERT_EQ(agent.createBackend(GetMockBackendName(), params, backend), NIXL_SUCCESS);
+
+            nixl_opt_args_t extra_params;
+            extra_params.backends = {backend};
+
+            nixl_reg_dlist_t reg_list(DRAM_SEG);
+            reg_list.addDesc(nixlBlobDesc(addr_, len_, 0, ""));
+            ASSERT_EQ(agent.registerMem(reg_list, &extra_params), NIXL_SUCCESS);
+
+            nixl_xfer_dlist_t src_list(DRAM_SEG), dst_list(DRAM_SEG);
+            src_list.addDesc(nixlBasicDesc(addr_, len_, 0));
+            dst_list.addDesc(nixlBasicDesc(addr_, len_, 0));
+
+            nixlXferReqH *xfer_req = nullptr;
+            ASSERT_EQ(agent.createXferReq(
+                          NIXL_WRITE, src_list, dst_list, agent_name, xfer_req, &extra_params),
+                      NIXL_SUCCESS);
+
+            size_t failures = 0;
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations; ++i) {
+                failures += agent.postXferReq(xfer_req) != NIXL_SUCCESS;
+                failures += agent.getXferStatus(xfer_req) != NIXL_SUCCESS;
+            }
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            EXPECT_EQ(failures, 0u);
+
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            Logger("PERF") << modeStr(GetParam()) << ": " << ns / iterations
+                           << " ns per postXferReq + getXferStatus";
+
+            EXPECT_EQ(agent.releaseXferReq(xfer_req), NIXL_SUCCESS);
+            EXPECT_EQ(agent.deregisterMem(reg_list, &extra_params), NIXL_SUCCESS);
+        }
+    };
+
+    TEST_P(syncModePerfTest, PostAndStatusOverhead) {
+        postAndStatus(100);
+    }
+
+    TEST_P(syncModePerfTest, DISABLED_PostAndStatusOverheadLarge) {
+        postAndStatus(100000);
+    }
+
+    INSTANTIATE_TEST_SUITE_P(SyncModes,
+                             syncModePerfTest,
+                             testing::Values(nixl_thread_sync_t::NIXL_THREAD_SYNC_NONE,
+                                             nixl_thread_sync_t::NIXL_THREAD_SYNC_STRICT,
+                                             nixl_thread_sync_t::NIXL_THREAD_SYNC_RW));
+
+} // namespace sync_mode_perf
+} // namespace gtest
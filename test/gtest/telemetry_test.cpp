@@ -23,6 +23,7 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <map>
 #include <cstdlib>
 #include <unistd.h>
 #include <climits>
@@ -141,25 +142,29 @@ TEST_F(telemetryTest, InvalidBufferSize) {
     envHelper_.popVar();
 }
 
-// Test transfer bytes tracking
+// Test transfer bytes tracking, transfer counters are written as sums over the interval
 TEST_F(telemetryTest, TransferBytesTracking) {
-    envHelper_.addVar(TELEMETRY_RUN_INTERVAL_VAR, "1");
-    nixlTelemetry telemetry(testFile_, backendMap_);
+    envHelper_.addVar(TELEMETRY_RUN_INTERVAL_VAR, "10000");
+    {
+        // Everything is written by the final flush
+        nixlTelemetry telemetry(testFile_, backendMap_);
 
-    EXPECT_NO_THROW(telemetry.updateTxBytes(1024));
-    EXPECT_NO_THROW(telemetry.updateRxBytes(1024));
-    EXPECT_NO_THROW(telemetry.updateTxRequestsNum(1));
-    EXPECT_NO_THROW(telemetry.updateRxRequestsNum(1));
-    EXPECT_NO_THROW(telemetry.updateErrorCount(nixl_status_t::NIXL_ERR_BACKEND));
-    EXPECT_NO_THROW(telemetry.updateMemoryRegistered(1024));
-    EXPECT_NO_THROW(telemetry.updateMemoryDeregistered(1024));
-    EXPECT_NO_THROW(telemetry.addXferTime(std::chrono::microseconds(100), true, 2000));
+        EXPECT_NO_THROW(telemetry.updateTxBytes(1024));
+        EXPECT_NO_THROW(telemetry.updateRxBytes(1024));
+        EXPECT_NO_THROW(telemetry.updateTxRequestsNum(1));
+        EXPECT_NO_THROW(telemetry.updateRxRequestsNum(1));
+        EXPECT_NO_THROW(telemetry.updateErrorCount(nixl_status_t::NIXL_ERR_BACKEND));
+        EXPECT_NO_THROW(telemetry.updateMemoryRegistered(1024));
+        EXPECT_NO_THROW(telemetry.updateMemoryDeregistered(1024));
+        EXPECT_NO_THROW(telemetry.addXferTime(std::chrono::microseconds(100), true, 2000));
+        EXPECT_NO_THROW(telemetry.addXferTime(std::chrono::microseconds(300), true, 2000));
+        EXPECT_NO_THROW(telemetry.addPostTime(std::chrono::microseconds(10)));
+    }
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(5));
     auto path = fs::path(testFile_);
     auto buffer = std::make_unique<sharedRingBuffer<nixlTelemetryEvent>>(
         path.string(), false, TELEMETRY_VERSION);
-    EXPECT_EQ(buffer->size(), 10);
+    EXPECT_EQ(buffer->size(), 9);
     EXPECT_EQ(buffer->version(), TELEMETRY_VERSION);
     EXPECT_EQ(buffer->capacity(), capacity_);
     EXPECT_EQ(buffer->empty(), false);
@@ -167,17 +172,23 @@ TEST_F(telemetryTest, TransferBytesTracking) {
     nixlTelemetryEvent event;
     buffer->pop(event);
     EXPECT_STREQ(event.eventName_, "agent_tx_bytes");
-    EXPECT_EQ(event.value_, 1024);
+    EXPECT_EQ(event.value_, 5048);
+    buffer->pop(event);
+    EXPECT_STREQ(event.eventName_, "agent_tx_requests_num");
+    EXPECT_EQ(event.value_, 3);
     buffer->pop(event);
     EXPECT_STREQ(event.eventName_, "agent_rx_bytes");
     EXPECT_EQ(event.value_, 1024);
     buffer->pop(event);
-    EXPECT_STREQ(event.eventName_, "agent_tx_requests_num");
-    EXPECT_EQ(event.value_, 1);
-    buffer->pop(event);
     EXPECT_STREQ(event.eventName_, "agent_rx_requests_num");
     EXPECT_EQ(event.value_, 1);
     buffer->pop(event);
+    EXPECT_STREQ(event.eventName_, "agent_xfer_time");
+    EXPECT_EQ(event.value_, 200);
+    buffer->pop(event);
+    EXPECT_STREQ(event.eventName_, "agent_xfer_post_time");
+    EXPECT_EQ(event.value_, 10);
+    buffer->pop(event);
     EXPECT_STREQ(event.eventName_,
                  nixlEnumStrings::statusStr(nixl_status_t::NIXL_ERR_BACKEND).c_str());
     EXPECT_EQ(event.value_, 1);
@@ -187,15 +198,78 @@ TEST_F(telemetryTest, TransferBytesTracking) {
     buffer->pop(event);
     EXPECT_STREQ(event.eventName_, "agent_memory_deregistered");
     EXPECT_EQ(event.value_, 1024);
-    buffer->pop(event);
-    EXPECT_STREQ(event.eventName_, "agent_xfer_time");
-    EXPECT_EQ(event.value_, 100);
-    buffer->pop(event);
-    EXPECT_STREQ(event.eventName_, "agent_tx_bytes");
-    EXPECT_EQ(event.value_, 2000);
-    buffer->pop(event);
-    EXPECT_STREQ(event.eventName_, "agent_tx_requests_num");
-    EXPECT_EQ(event.value_, 1);
+    envHelper_.popVar();
+}
+
+TEST_F(telemetryTest, LatencyHistogramBuckets) {
+    // Every value falls in a bucket whose range holds it, within 1/16 of the value
+    for (uint64_t value : {0ULL, 1ULL, 31ULL, 32ULL, 33ULL, 1000ULL, 123456789ULL, ~0ULL}) {
+        const size_t bucket = nixlLatencyHistogram::bucketOf(value);
+        ASSERT_LT(bucket, nixlLatencyHistogram::bucket_count);
+        EXPECT_GE(nixlLatencyHistogram::bucketMax(bucket), value);
+        EXPECT_LE(nixlLatencyHistogram::bucketMax(bucket) - value, value / 16);
+        if (bucket > 0) {
+            EXPECT_LT(nixlLatencyHistogram::bucketMax(bucket - 1), value);
+        }
+    }
+
+    auto hist = std::make_unique<nixlLatencyHistogram>();
+    EXPECT_EQ(hist->percentile(0.99), 0);
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        hist->record(value);
+    }
+    hist->record(1000000);
+
+    EXPECT_EQ(hist->count(), 1001);
+    EXPECT_EQ(hist->max(), 1000000);
+    EXPECT_NEAR(hist->percentile(0.5), 501, 501 / 16);
+    EXPECT_NEAR(hist->percentile(0.99), 991, 991 / 16);
+    EXPECT_EQ(hist->percentile(0.9999), 1000000);
+}
+
+TEST_F(telemetryTest, LatencyHistogramsSharedFile) {
+    {
+        nixlTelemetry telemetry(testFile_, backendMap_);
+        auto *slot = telemetry.histogram("UCX", "remote", NIXL_WRITE);
+        ASSERT_NE(slot, nullptr);
+        EXPECT_EQ(telemetry.histogram("UCX", "remote", NIXL_WRITE), slot);
+        EXPECT_NE(telemetry.histogram("UCX", "remote", NIXL_READ), slot);
+        for (uint64_t value = 1; value <= 100; ++value) {
+            slot->xferTime_.record(value);
+            slot->postTime_.record(1);
+        }
+
+        // Readers see the histograms while the agent records into them
+        sharedLatencyHistograms reader(testFile_ + TELEMETRY_HIST_SUFFIX, false);
+        ASSERT_EQ(reader.size(), 2);
+        EXPECT_STREQ(reader[0].backend_, "UCX");
+        EXPECT_STREQ(reader[0].remoteAgent_, "remote");
+        EXPECT_EQ(reader[0].op_, NIXL_WRITE);
+        EXPECT_EQ(reader[0].xferTime_.count(), 100);
+        EXPECT_NEAR(reader[0].xferTime_.percentile(0.5), 50, 50 / 16);
+        EXPECT_EQ(reader[0].postTime_.percentile(0.999), 1);
+        EXPECT_EQ(reader[1].xferTime_.count(), 0);
+    }
+
+    // A new agent starts from empty histograms
+    nixlTelemetry telemetry(testFile_, backendMap_);
+    sharedLatencyHistograms reader(testFile_ + TELEMETRY_HIST_SUFFIX, false);
+    EXPECT_EQ(reader.size(), 0);
+}
+
+TEST_F(telemetryTest, LatencyHistogramsFull) {
+    envHelper_.addVar(TELEMETRY_HIST_SLOTS_VAR, "2");
+    {
+        nixlTelemetry telemetry(testFile_, backendMap_);
+        EXPECT_NE(telemetry.histogram("UCX", "a", NIXL_WRITE), nullptr);
+        EXPECT_NE(telemetry.histogram("UCX", "b", NIXL_WRITE), nullptr);
+        EXPECT_EQ(telemetry.histogram("UCX", "c", NIXL_WRITE), nullptr);
+        EXPECT_NE(telemetry.histogram("UCX", "a", NIXL_WRITE), nullptr);
+
+        sharedLatencyHistograms reader(testFile_ + TELEMETRY_HIST_SUFFIX, false);
+        EXPECT_EQ(reader.capacity(), 2);
+        EXPECT_EQ(reader.size(), 2);
+    }
     envHelper_.popVar();
 }
 
@@ -235,6 +309,30 @@ TEST_F(telemetryTest, BufferOverflowHandling) {
     envHelper_.popVar();
 }
 
+TEST_F(telemetryTest, BufferPushBatch) {
+    sharedRingBuffer<nixlTelemetryEvent> buffer(testFile_, true, TELEMETRY_VERSION, 8);
+    std::vector<nixlTelemetryEvent> events;
+    for (uint64_t i = 0; i < 16; ++i) {
+        events.emplace_back(i, nixl_telemetry_category_t::NIXL_TELEMETRY_CUSTOM, "batch", i);
+    }
+
+    // One slot is kept free, what does not fit is dropped
+    EXPECT_EQ(buffer.push_n(events.data(), 5), 5);
+    nixlTelemetryEvent event;
+    for (int i = 0; i < 4; ++i) {
+        buffer.pop(event);
+    }
+    EXPECT_EQ(buffer.push_n(events.data() + 5, 11), 6);
+    EXPECT_TRUE(buffer.full());
+
+    // Pushed across the end of the buffer, in order
+    for (uint64_t i = 4; i < 11; ++i) {
+        ASSERT_TRUE(buffer.pop(event));
+        EXPECT_EQ(event.value_, i);
+    }
+    EXPECT_TRUE(buffer.empty());
+}
+
 TEST_F(telemetryTest, CustomTelemetryDirectory) {
     fs::path custom_dir = testDir_ / "custom_telemetry";
     fs::create_directory(custom_dir);
@@ -301,10 +399,92 @@ TEST_F(telemetryTest, ConcurrentAccess) {
         thread.join();
     }
     std::this_thread::sleep_for(std::chrono::milliseconds(5));
-    size_ = operations_per_thread * num_threads;
-    readPos_ = 0;
-    writePos_ = size_;
-    validateState();
+
+    // Counters may be split over several intervals, their sums must be exact
+    auto buffer = std::make_unique<sharedRingBuffer<nixlTelemetryEvent>>(
+        testFile_, false, TELEMETRY_VERSION);
+    std::map<std::string, uint64_t> totals;
+    nixlTelemetryEvent event;
+    while (buffer->pop(event)) {
+        EXPECT_EQ(event.category_, nixl_telemetry_category_t::NIXL_TELEMETRY_TRANSFER);
+        totals[event.eventName_] += event.value_;
+    }
+
+    const uint64_t sum_j = operations_per_thread * (operations_per_thread - 1) / 2;
+    EXPECT_EQ(totals["agent_tx_bytes"], sum_j * 100);
+    EXPECT_EQ(totals["agent_rx_bytes"], sum_j * 50);
+    EXPECT_EQ(totals["agent_tx_requests_num"], sum_j);
+    EXPECT_EQ(totals["agent_rx_requests_num"], sum_j);
+    envHelper_.popVar();
+}
+
+// Backend events recorded concurrently are all collected, in order per thread
+TEST_F(telemetryTest, BackendTelemetryEventsConcurrent) {
+    nixlBackendInitParams init_params;
+    nixl_b_params_t custom_params;
+    init_params.customParams = &custom_params;
+    init_params.enableTelemetry_ = true;
+    telemetryTestBackend backend(&init_params);
+
+    const int num_threads = 4;
+    const int events_per_thread = 500;
+    std::vector<std::thread> threads;
+    std::vector<nixlTelemetryEvent> events;
+    std::atomic<int> running{num_threads};
+
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&backend, &running, i]() {
+            for (int j = 0; j < events_per_thread; ++j) {
+                backend.addTestTelemetryEvent("thread_" + std::to_string(i), j);
+            }
+            --running;
+        });
+    }
+
+    while (running > 0) {
+        auto drained = backend.getTelemetryEvents();
+        events.insert(events.end(), drained.begin(), drained.end());
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    auto drained = backend.getTelemetryEvents();
+    events.insert(events.end(), drained.begin(), drained.end());
+
+    ASSERT_EQ(events.size(), num_threads * events_per_thread);
+    std::map<std::string, uint64_t> next_value;
+    for (const auto &event : events) {
+        EXPECT_EQ(event.value_, next_value[event.eventName_]++);
+    }
+}
+
+// Events of different threads are written in timestamp order
+TEST_F(telemetryTest, BackendTelemetryEventsMergedAcrossThreads) {
+    envHelper_.addVar(TELEMETRY_RUN_INTERVAL_VAR, "10000");
+    nixlBackendInitParams init_params;
+    nixl_b_params_t custom_params;
+    init_params.customParams = &custom_params;
+    init_params.enableTelemetry_ = true;
+    telemetryTestBackend backend(&init_params);
+    backendMap_["CUSTOM"] = &backend;
+    {
+        nixlTelemetry telemetry(testFile_, backendMap_);
+        for (int i = 0; i < 4; ++i) {
+            std::thread([&backend, i]() {
+                backend.addTestTelemetryEvent("thread_" + std::to_string(i), i);
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }).join();
+        }
+    }
+
+    sharedRingBuffer<nixlTelemetryEvent> buffer(testFile_, false, TELEMETRY_VERSION);
+    ASSERT_EQ(buffer.size(), 4);
+    nixlTelemetryEvent event;
+    for (uint64_t i = 0; i < 4; ++i) {
+        buffer.pop(event);
+        EXPECT_EQ(event.value_, i);
+        EXPECT_EQ(event.category_, nixl_telemetry_category_t::NIXL_TELEMETRY_BACKEND);
+    }
     envHelper_.popVar();
 }
 
@@ -17,7 +17,9 @@
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <atomic>
 #include <random>
+#include <thread>
 
 #include "common.h"
 #include "nixl.h"
@@ -68,8 +70,8 @@ namespace agent {
         std::unique_ptr<nixlAgent> agent_;
 
     public:
-        agentHelper(const std::string &name)
-            : agent_(std::make_unique<nixlAgent>(name, nixlAgentConfig(true))) {}
+        agentHelper(const std::string &name, const nixlAgentConfig &cfg = nixlAgentConfig(true))
+            : agent_(std::make_unique<nixlAgent>(name, cfg)) {}
 
         ~agentHelper() {
             /* We must release nixlAgent first (i.e. explicitly in the destructor), as it calls
@@ -88,9 +90,11 @@ namespace agent {
         }
 
         nixl_status_t
-        createBackendWithGMock(nixl_b_params_t &params, nixlBackendH *&backend) {
+        createBackendWithGMock(nixl_b_params_t &params,
+                               nixlBackendH *&backend,
+                               const nixl_backend_t &type = GetMockBackendName()) {
             gmock_engine_.SetToParams(params);
-            return agent_->createBackend(GetMockBackendName(), params, backend);
+            return agent_->createBackend(type, params, backend);
         }
 
         nixl_status_t
@@ -323,6 +327,823 @@ namespace agent {
         EXPECT_EQ(local_agent_->releaseXferReq(xfer_req), NIXL_SUCCESS);
     }
 
+    TEST_F(dualAgentBridgeFixture, XferReqMergeTest) {
+        nixl_b_params_t local_params, remote_params;
+        nixlBackendH *local_backend, *remote_backend;
+        EXPECT_EQ(local_agent_helper_->createBackendWithGMock(local_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->createBackendWithGMock(remote_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        nixl_reg_dlist_t local_reg_dlist(DRAM_SEG), remote_reg_dlist(DRAM_SEG);
+        nixl_opt_args_t local_extra_params, remote_extra_params;
+        blob local_blob, remote_blob;
+        EXPECT_EQ(local_agent_helper_->initAndRegisterMemory(
+                      local_blob, local_reg_dlist, local_extra_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->initAndRegisterMemory(
+                      remote_blob, remote_reg_dlist, remote_extra_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        std::string remote_agent_name_out;
+        EXPECT_EQ(local_agent_helper_->getAndLoadRemoteMd(remote_agent_, remote_agent_name_out),
+                  NIXL_SUCCESS);
+
+        // Back to back halves of each buffer, as two pairs
+        const nixlBasicDesc local_desc = local_blob.getDesc();
+        const nixlBasicDesc remote_desc = remote_blob.getDesc();
+        const size_t half = local_desc.len / 2;
+        nixl_xfer_dlist_t local_xfer_dlist(DRAM_SEG), remote_xfer_dlist(DRAM_SEG);
+        for (size_t offset = 0; offset < local_desc.len; offset += half) {
+            local_xfer_dlist.addDesc(
+                nixlBasicDesc(local_desc.addr + offset, half, local_desc.devId));
+            remote_xfer_dlist.addDesc(
+                nixlBasicDesc(remote_desc.addr + offset, half, remote_desc.devId));
+        }
+
+        // Merging is opt-in, descriptor indices of the request follow the given lists
+        static char backend_req;
+        for (bool merge : {false, true}) {
+            const int expected_count = merge ? 1 : 2;
+            EXPECT_CALL(local_agent_helper_->getGMockEngine(), prepXfer)
+                .WillOnce([=](const nixl_xfer_op_t &,
+                              const nixl_meta_dlist_t &src,
+                              const nixl_meta_dlist_t &dst,
+                              const std::string &,
+                              nixlBackendReqH *&handle,
+                              const nixl_opt_b_args_t *) {
+                    EXPECT_EQ(src.descCount(), expected_count);
+                    EXPECT_EQ(dst.descCount(), expected_count);
+                    EXPECT_EQ(src[0].len, local_desc.len / expected_count);
+                    EXPECT_EQ(dst[0].addr, remote_desc.addr);
+                    handle = reinterpret_cast<nixlBackendReqH *>(&backend_req);
+                    return NIXL_SUCCESS;
+                });
+
+            nixlXferReqH *xfer_req;
+            local_extra_params.mergeDescs = merge;
+            EXPECT_EQ(local_agent_->createXferReq(NIXL_WRITE,
+                                                  local_xfer_dlist,
+                                                  remote_xfer_dlist,
+                                                  remote_agent_name_out,
+                                                  xfer_req,
+                                                  &local_extra_params),
+                      NIXL_SUCCESS);
+
+            // Requests with merged descriptors cannot be addressed by index on the GPU,
+            // others reach the backend, which has no GPU support here
+            nixlGpuXferReqH gpu_req;
+            EXPECT_EQ(local_agent_->createGpuXferReq(*xfer_req, gpu_req),
+                      merge ? NIXL_ERR_INVALID_PARAM : NIXL_ERR_NOT_SUPPORTED);
+            EXPECT_EQ(local_agent_->releaseXferReq(xfer_req), NIXL_SUCCESS);
+        }
+    }
+
+    TEST_F(dualAgentBridgeFixture, XferReqAfterInvalidateTest) {
+        nixl_b_params_t local_params, remote_params;
+        nixlBackendH *local_backend, *remote_backend;
+        EXPECT_EQ(local_agent_helper_->createBackendWithGMock(local_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->createBackendWithGMock(remote_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        nixl_reg_dlist_t local_reg_dlist(DRAM_SEG), remote_reg_dlist(DRAM_SEG);
+        nixl_opt_args_t local_extra_params, remote_extra_params;
+        blob local_blob, remote_blob;
+        EXPECT_EQ(local_agent_helper_->initAndRegisterMemory(
+                      local_blob, local_reg_dlist, local_extra_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->initAndRegisterMemory(
+                      remote_blob, remote_reg_dlist, remote_extra_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        std::string remote_agent_name_out;
+        EXPECT_EQ(local_agent_helper_->getAndLoadRemoteMd(remote_agent_, remote_agent_name_out),
+                  NIXL_SUCCESS);
+
+        nixl_xfer_dlist_t local_xfer_dlist(DRAM_SEG), remote_xfer_dlist(DRAM_SEG);
+        local_xfer_dlist.addDesc(local_blob.getDesc());
+        remote_xfer_dlist.addDesc(remote_blob.getDesc());
+
+        nixlXferReqH *xfer_req;
+        EXPECT_EQ(local_agent_->createXferReq(NIXL_WRITE,
+                                              local_xfer_dlist,
+                                              remote_xfer_dlist,
+                                              remote_agent_name_out,
+                                              xfer_req,
+                                              &local_extra_params),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->postXferReq(xfer_req), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->getXferStatus(xfer_req), NIXL_SUCCESS);
+
+        // Reposting must notice the invalidation
+        EXPECT_EQ(local_agent_->invalidateRemoteMD(remote_agent_name_out), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->postXferReq(xfer_req), NIXL_ERR_NOT_FOUND);
+        EXPECT_EQ(local_agent_->postXferReq(xfer_req), NIXL_ERR_NOT_FOUND);
+
+        // The request points to the metadata that was freed, it stays stale once the remote
+        // is loaded again, while new requests work
+        EXPECT_EQ(local_agent_helper_->getAndLoadRemoteMd(remote_agent_, remote_agent_name_out),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->postXferReq(xfer_req), NIXL_ERR_NOT_FOUND);
+        EXPECT_EQ(local_agent_->releaseXferReq(xfer_req), NIXL_SUCCESS);
+
+        EXPECT_EQ(local_agent_->createXferReq(NIXL_WRITE,
+                                              local_xfer_dlist,
+                                              remote_xfer_dlist,
+                                              remote_agent_name_out,
+                                              xfer_req,
+                                              &local_extra_params),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->postXferReq(xfer_req), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->getXferStatus(xfer_req), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->releaseXferReq(xfer_req), NIXL_SUCCESS);
+    }
+
+    TEST_F(dualAgentBridgeFixture, FullMetadataReplacesTest) {
+        nixl_b_params_t local_params, remote_params;
+        nixlBackendH *local_backend, *remote_backend;
+        EXPECT_EQ(local_agent_helper_->createBackendWithGMock(local_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->createBackendWithGMock(remote_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        nixl_reg_dlist_t local_reg_dlist(DRAM_SEG), remote_reg_dlist(DRAM_SEG);
+        nixl_opt_args_t local_extra_params, remote_extra_params;
+        blob local_blob, remote_blob;
+        EXPECT_EQ(local_agent_helper_->initAndRegisterMemory(
+                      local_blob, local_reg_dlist, local_extra_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->initAndRegisterMemory(
+                      remote_blob, remote_reg_dlist, remote_extra_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        blob removed_blob;
+        nixl_reg_dlist_t removed_reg_dlist(DRAM_SEG);
+        removed_reg_dlist.addDesc(removed_blob.getDesc());
+        EXPECT_EQ(remote_agent_->registerMem(removed_reg_dlist, &remote_extra_params),
+                  NIXL_SUCCESS);
+
+        std::string remote_agent_name_out;
+        EXPECT_EQ(local_agent_helper_->getAndLoadRemoteMd(remote_agent_, remote_agent_name_out),
+                  NIXL_SUCCESS);
+
+        nixl_xfer_dlist_t local_xfer_dlist(DRAM_SEG), remote_xfer_dlist(DRAM_SEG);
+        nixl_xfer_dlist_t removed_xfer_dlist(DRAM_SEG);
+        local_xfer_dlist.addDesc(local_blob.getDesc());
+        remote_xfer_dlist.addDesc(remote_blob.getDesc());
+        removed_xfer_dlist.addDesc(removed_blob.getDesc());
+
+        nixlXferReqH *xfer_req;
+        EXPECT_EQ(local_agent_->createXferReq(NIXL_WRITE,
+                                              local_xfer_dlist,
+                                              remote_xfer_dlist,
+                                              remote_agent_name_out,
+                                              xfer_req,
+                                              &local_extra_params),
+                  NIXL_SUCCESS);
+
+        // The same version again changes nothing
+        EXPECT_EQ(local_agent_helper_->getAndLoadRemoteMd(remote_agent_, remote_agent_name_out),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->postXferReq(xfer_req), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->getXferStatus(xfer_req), NIXL_SUCCESS);
+
+        // A new full version drops the descriptors deregistered since the loaded one
+        EXPECT_EQ(remote_agent_->deregisterMem(removed_reg_dlist, &remote_extra_params),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_helper_->getAndLoadRemoteMd(remote_agent_, remote_agent_name_out),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->checkRemoteMD(remote_agent_name_out, remote_xfer_dlist),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->checkRemoteMD(remote_agent_name_out, removed_xfer_dlist),
+                  NIXL_ERR_NOT_FOUND);
+
+        uint64_t loaded_version, remote_version;
+        nixl_blob_t delta_md;
+        EXPECT_EQ(local_agent_->getRemoteMDVersion(remote_agent_name_out, loaded_version),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_->getLocalMDDelta(loaded_version, delta_md), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->loadRemoteMD(delta_md, remote_agent_name_out), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->getRemoteMDVersion(remote_agent_name_out, remote_version),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_version, loaded_version);
+
+        // Requests made before the replacement are stale
+        EXPECT_EQ(local_agent_->postXferReq(xfer_req), NIXL_ERR_NOT_FOUND);
+        EXPECT_EQ(local_agent_->releaseXferReq(xfer_req), NIXL_SUCCESS);
+    }
+
+    TEST_F(dualAgentBridgeFixture, XferReqRecycleTest) {
+        nixl_b_params_t local_params, remote_params;
+        nixlBackendH *local_backend, *remote_backend;
+        EXPECT_EQ(local_agent_helper_->createBackendWithGMock(local_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->createBackendWithGMock(remote_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        nixl_reg_dlist_t local_reg_dlist(DRAM_SEG), remote_reg_dlist(DRAM_SEG);
+        nixl_opt_args_t local_extra_params, remote_extra_params;
+        blob local_blob, remote_blob;
+        EXPECT_EQ(local_agent_helper_->initAndRegisterMemory(
+                      local_blob, local_reg_dlist, local_extra_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->initAndRegisterMemory(
+                      remote_blob, remote_reg_dlist, remote_extra_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        std::string remote_agent_name_out;
+        EXPECT_EQ(local_agent_helper_->getAndLoadRemoteMd(remote_agent_, remote_agent_name_out),
+                  NIXL_SUCCESS);
+
+        nixl_xfer_dlist_t local_xfer_dlist(DRAM_SEG), remote_xfer_dlist(DRAM_SEG);
+        local_xfer_dlist.addDesc(local_blob.getDesc());
+        remote_xfer_dlist.addDesc(remote_blob.getDesc());
+
+        // A released handle is reused by the next request, without its previous state
+        nixlXferReqH *first_req, *second_req;
+        local_extra_params.notifMsg = "notification";
+        local_extra_params.hasNotif = true;
+        EXPECT_EQ(local_agent_->createXferReq(NIXL_WRITE,
+                                              local_xfer_dlist,
+                                              remote_xfer_dlist,
+                                              remote_agent_name_out,
+                                              first_req,
+                                              &local_extra_params),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->postXferReq(first_req), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->releaseXferReq(first_req), NIXL_SUCCESS);
+
+        local_extra_params.hasNotif = false;
+        EXPECT_EQ(local_agent_->createXferReq(NIXL_READ,
+                                              local_xfer_dlist,
+                                              remote_xfer_dlist,
+                                              remote_agent_name_out,
+                                              second_req,
+                                              &local_extra_params),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(second_req, first_req);
+        EXPECT_EQ(local_agent_->getXferStatus(second_req), NIXL_ERR_NOT_POSTED);
+        EXPECT_EQ(local_agent_->postXferReq(second_req), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->releaseXferReq(second_req), NIXL_SUCCESS);
+    }
+
+    TEST_F(dualAgentBridgeFixture, CompactMetadataTest) {
+        nixlAgentConfig cfg(true);
+        cfg.compactMetadata = true;
+        remote_agent_helper_ = std::make_unique<agentHelper>(remote_agent_name, cfg);
+        remote_agent_ = remote_agent_helper_->getAgent();
+
+        nixl_b_params_t local_params, remote_params;
+        nixlBackendH *local_backend, *remote_backend;
+        EXPECT_EQ(local_agent_helper_->createBackendWithGMock(local_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->createBackendWithGMock(remote_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        nixl_reg_dlist_t local_reg_dlist(DRAM_SEG), remote_reg_dlist(DRAM_SEG);
+        nixl_opt_args_t local_extra_params, remote_extra_params;
+        blob local_blob, remote_blob;
+        EXPECT_EQ(local_agent_helper_->initAndRegisterMemory(
+                      local_blob, local_reg_dlist, local_extra_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->initAndRegisterMemory(
+                      remote_blob, remote_reg_dlist, remote_extra_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        // Remote metadata is compact, and loads the same as the default encoding
+        std::string remote_agent_name_out;
+        EXPECT_EQ(local_agent_helper_->getAndLoadRemoteMd(remote_agent_, remote_agent_name_out),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_name_out, remote_agent_name);
+
+        nixl_xfer_dlist_t local_xfer_dlist(DRAM_SEG), remote_xfer_dlist(DRAM_SEG);
+        local_xfer_dlist.addDesc(local_blob.getDesc());
+        remote_xfer_dlist.addDesc(remote_blob.getDesc());
+
+        nixlXferReqH *xfer_req;
+        EXPECT_EQ(local_agent_->createXferReq(NIXL_WRITE,
+                                              local_xfer_dlist,
+                                              remote_xfer_dlist,
+                                              remote_agent_name_out,
+                                              xfer_req,
+                                              &local_extra_params),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->releaseXferReq(xfer_req), NIXL_SUCCESS);
+    }
+
+    TEST_F(dualAgentBridgeFixture, LazyRemoteMetadataTest) {
+        nixlAgentConfig cfg(true);
+        cfg.lazyRemoteMD = true;
+        local_agent_helper_ = std::make_unique<agentHelper>(local_agent_name, cfg);
+        local_agent_ = local_agent_helper_->getAgent();
+
+        nixlBackendMD remote_md(false);
+        int unpacked = 0;
+        EXPECT_CALL(local_agent_helper_->getGMockEngine(), loadRemoteMD)
+            .WillRepeatedly([&](const nixlBlobDesc &,
+                                const nixl_mem_t &,
+                                const std::string &,
+                                nixlBackendMD *&output) {
+                ++unpacked;
+                output = &remote_md;
+                return NIXL_SUCCESS;
+            });
+
+        nixl_b_params_t local_params, remote_params;
+        nixlBackendH *local_backend, *remote_backend;
+        EXPECT_EQ(local_agent_helper_->createBackendWithGMock(local_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->createBackendWithGMock(remote_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        nixl_reg_dlist_t local_reg_dlist(DRAM_SEG), remote_reg_dlist(DRAM_SEG);
+        nixl_opt_args_t local_extra_params, remote_extra_params;
+        blob local_blob, remote_blob;
+        EXPECT_EQ(local_agent_helper_->initAndRegisterMemory(
+                      local_blob, local_reg_dlist, local_extra_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->initAndRegisterMemory(
+                      remote_blob, remote_reg_dlist, remote_extra_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        // Remote descriptors are only unpacked by the first transfer that uses them
+        std::string remote_agent_name_out;
+        EXPECT_EQ(local_agent_helper_->getAndLoadRemoteMd(remote_agent_, remote_agent_name_out),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(unpacked, 0);
+
+        nixl_xfer_dlist_t local_xfer_dlist(DRAM_SEG), remote_xfer_dlist(DRAM_SEG);
+        local_xfer_dlist.addDesc(local_blob.getDesc());
+        remote_xfer_dlist.addDesc(remote_blob.getDesc());
+
+        for (int i = 0; i < 2; ++i) {
+            nixlXferReqH *xfer_req;
+            EXPECT_EQ(local_agent_->createXferReq(NIXL_WRITE,
+                                                  local_xfer_dlist,
+                                                  remote_xfer_dlist,
+                                                  remote_agent_name_out,
+                                                  xfer_req,
+                                                  &local_extra_params),
+                      NIXL_SUCCESS);
+            EXPECT_EQ(local_agent_->postXferReq(xfer_req), NIXL_SUCCESS);
+            EXPECT_EQ(local_agent_->releaseXferReq(xfer_req), NIXL_SUCCESS);
+            EXPECT_EQ(unpacked, 1);
+        }
+
+        EXPECT_EQ(local_agent_->invalidateRemoteMD(remote_agent_name_out), NIXL_SUCCESS);
+    }
+
+    TEST_F(dualAgentBridgeFixture, MetadataDeltaTest) {
+        nixl_b_params_t local_params, remote_params;
+        nixlBackendH *local_backend, *remote_backend;
+        EXPECT_EQ(local_agent_helper_->createBackendWithGMock(local_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->createBackendWithGMock(remote_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        nixl_reg_dlist_t local_reg_dlist(DRAM_SEG), remote_reg_dlist(DRAM_SEG);
+        nixl_opt_args_t local_extra_params, remote_extra_params;
+        blob local_blob, remote_blob;
+        EXPECT_EQ(local_agent_helper_->initAndRegisterMemory(
+                      local_blob, local_reg_dlist, local_extra_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->initAndRegisterMemory(
+                      remote_blob, remote_reg_dlist, remote_extra_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        std::string remote_agent_name_out;
+        uint64_t version;
+        EXPECT_EQ(local_agent_->getRemoteMDVersion(remote_agent_name, version),
+                  NIXL_ERR_NOT_FOUND);
+        EXPECT_EQ(local_agent_helper_->getAndLoadRemoteMd(remote_agent_, remote_agent_name_out),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->getRemoteMDVersion(remote_agent_name, version), NIXL_SUCCESS);
+
+        nixl_xfer_dlist_t local_xfer_dlist(DRAM_SEG), remote_xfer_dlist(DRAM_SEG);
+        local_xfer_dlist.addDesc(local_blob.getDesc());
+        remote_xfer_dlist.addDesc(remote_blob.getDesc());
+
+        nixlXferReqH *xfer_req;
+        EXPECT_EQ(local_agent_->createXferReq(NIXL_WRITE,
+                                              local_xfer_dlist,
+                                              remote_xfer_dlist,
+                                              remote_agent_name_out,
+                                              xfer_req,
+                                              &local_extra_params),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->postXferReq(xfer_req), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->getXferStatus(xfer_req), NIXL_SUCCESS);
+
+        // Delta with a new registration only, existing requests stay valid
+        blob added_blob;
+        nixl_reg_dlist_t added_reg_dlist(DRAM_SEG);
+        added_reg_dlist.addDesc(added_blob.getDesc());
+        EXPECT_EQ(remote_agent_->registerMem(added_reg_dlist, &remote_extra_params),
+                  NIXL_SUCCESS);
+
+        nixl_blob_t full_md, delta_md;
+        EXPECT_EQ(remote_agent_->getLocalMDDelta(version, delta_md), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->loadRemoteMD(delta_md, remote_agent_name_out), NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_name_out, remote_agent_name);
+
+        uint64_t new_version;
+        EXPECT_EQ(local_agent_->getRemoteMDVersion(remote_agent_name, new_version), NIXL_SUCCESS);
+        EXPECT_NE(new_version, version);
+        EXPECT_EQ(local_agent_->postXferReq(xfer_req), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->getXferStatus(xfer_req), NIXL_SUCCESS);
+
+        nixl_xfer_dlist_t added_xfer_dlist(DRAM_SEG);
+        added_xfer_dlist.addDesc(added_blob.getDesc());
+        nixlXferReqH *added_req;
+        EXPECT_EQ(local_agent_->createXferReq(NIXL_WRITE,
+                                              local_xfer_dlist,
+                                              added_xfer_dlist,
+                                              remote_agent_name_out,
+                                              added_req,
+                                              &local_extra_params),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->releaseXferReq(added_req), NIXL_SUCCESS);
+
+        // Same delta does not apply twice
+        EXPECT_EQ(local_agent_->loadRemoteMD(delta_md, remote_agent_name_out),
+                  NIXL_ERR_MISMATCH);
+
+        // Delta with a deregistration, requests created before it are stale
+        EXPECT_EQ(remote_agent_->deregisterMem(remote_reg_dlist, &remote_extra_params),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_->getLocalMDDelta(new_version, delta_md), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->loadRemoteMD(delta_md, remote_agent_name_out), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->postXferReq(xfer_req), NIXL_ERR_NOT_FOUND);
+        EXPECT_EQ(local_agent_->releaseXferReq(xfer_req), NIXL_SUCCESS);
+        EXPECT_NE(local_agent_->createXferReq(NIXL_WRITE,
+                                              local_xfer_dlist,
+                                              remote_xfer_dlist,
+                                              remote_agent_name_out,
+                                              xfer_req,
+                                              &local_extra_params),
+                  NIXL_SUCCESS);
+
+        // Unknown versions get the full metadata
+        EXPECT_EQ(remote_agent_->getLocalMDDelta(0, delta_md), NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_->getLocalMD(full_md), NIXL_SUCCESS);
+        EXPECT_EQ(delta_md, full_md);
+    }
+
+    TEST_F(dualAgentBridgeFixture, PreppedDlistAfterDeltaTest) {
+        nixl_b_params_t local_params, remote_params;
+        nixlBackendH *local_backend, *remote_backend;
+        EXPECT_EQ(local_agent_helper_->createBackendWithGMock(local_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->createBackendWithGMock(remote_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        nixl_reg_dlist_t local_reg_dlist(DRAM_SEG), remote_reg_dlist(DRAM_SEG);
+        nixl_opt_args_t local_extra_params, remote_extra_params;
+        blob local_blob, remote_blob;
+        EXPECT_EQ(local_agent_helper_->initAndRegisterMemory(
+                      local_blob, local_reg_dlist, local_extra_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->initAndRegisterMemory(
+                      remote_blob, remote_reg_dlist, remote_extra_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        std::string remote_agent_name_out;
+        uint64_t version;
+        EXPECT_EQ(local_agent_helper_->getAndLoadRemoteMd(remote_agent_, remote_agent_name_out),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->getRemoteMDVersion(remote_agent_name, version), NIXL_SUCCESS);
+
+        nixl_xfer_dlist_t local_xfer_dlist(DRAM_SEG), remote_xfer_dlist(DRAM_SEG);
+        local_xfer_dlist.addDesc(local_blob.getDesc());
+        remote_xfer_dlist.addDesc(remote_blob.getDesc());
+
+        nixlDlistH *local_hndl, *remote_hndl;
+        EXPECT_EQ(local_agent_->prepXferDlist(NIXL_INIT_AGENT, local_xfer_dlist, local_hndl),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(
+            local_agent_->prepXferDlist(remote_agent_name_out, remote_xfer_dlist, remote_hndl),
+            NIXL_SUCCESS);
+
+        nixlXferReqH *xfer_req;
+        EXPECT_EQ(local_agent_->makeXferReq(
+                      NIXL_WRITE, local_hndl, {0}, remote_hndl, {0}, xfer_req),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->releaseXferReq(xfer_req), NIXL_SUCCESS);
+
+        // The delta unloads the metadata the prepped remote descriptors point to
+        nixl_blob_t delta_md;
+        EXPECT_EQ(remote_agent_->deregisterMem(remote_reg_dlist, &remote_extra_params),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_->getLocalMDDelta(version, delta_md), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->loadRemoteMD(delta_md, remote_agent_name_out), NIXL_SUCCESS);
+
+        nixlXferTemplateH *tmpl_hndl;
+        EXPECT_EQ(local_agent_->makeXferReq(
+                      NIXL_WRITE, local_hndl, {0}, remote_hndl, {0}, xfer_req),
+                  NIXL_ERR_NOT_FOUND);
+        EXPECT_EQ(local_agent_->prepXferTemplate(local_hndl, {0}, remote_hndl, {0}, tmpl_hndl),
+                  NIXL_ERR_NOT_FOUND);
+
+        EXPECT_EQ(local_agent_->releasedDlistH(local_hndl), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->releasedDlistH(remote_hndl), NIXL_SUCCESS);
+    }
+
+    TEST_F(dualAgentBridgeFixture, MetadataDeltaConcurrentXferTest) {
+        // Post/status run concurrently with metadata updates only in RW mode
+        local_agent_helper_ = std::make_unique<agentHelper>(
+            local_agent_name,
+            nixlAgentConfig(true, false, 0, nixl_thread_sync_t::NIXL_THREAD_SYNC_RW));
+        local_agent_ = local_agent_helper_->getAgent();
+
+        // Remote metadata must never be unloaded while the backend uses it in a post
+        static char md_token;
+        std::atomic<int> in_post{0};
+        std::atomic<int> unload_during_post{0};
+        auto &engine = local_agent_helper_->getGMockEngine();
+        ON_CALL(engine, loadRemoteMD)
+            .WillByDefault([](const nixlBlobDesc &,
+                              const nixl_mem_t &,
+                              const std::string &,
+                              nixlBackendMD *&output) {
+                output = reinterpret_cast<nixlBackendMD *>(&md_token);
+                return NIXL_SUCCESS;
+            });
+        ON_CALL(engine, postXfer)
+            .WillByDefault([&in_post](const nixl_xfer_op_t &,
+                                      const nixl_meta_dlist_t &,
+                                      const nixl_meta_dlist_t &,
+                                      const std::string &,
+                                      nixlBackendReqH *&,
+                                      const nixl_opt_b_args_t *) {
+                in_post.fetch_add(1);
+                std::this_thread::sleep_for(std::chrono::microseconds(20));
+                in_post.fetch_sub(1);
+                return NIXL_SUCCESS;
+            });
+        ON_CALL(engine, unloadMD).WillByDefault([&](nixlBackendMD *) {
+            if (in_post.load() != 0) unload_during_post.fetch_add(1);
+            return NIXL_SUCCESS;
+        });
+
+        nixl_b_params_t local_params, remote_params;
+        nixlBackendH *local_backend, *remote_backend;
+        EXPECT_EQ(local_agent_helper_->createBackendWithGMock(local_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->createBackendWithGMock(remote_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        nixl_reg_dlist_t local_reg_dlist(DRAM_SEG), remote_reg_dlist(DRAM_SEG);
+        nixl_opt_args_t local_extra_params, remote_extra_params;
+        blob local_blob, remote_blob;
+        EXPECT_EQ(local_agent_helper_->initAndRegisterMemory(
+                      local_blob, local_reg_dlist, local_extra_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->initAndRegisterMemory(
+                      remote_blob, remote_reg_dlist, remote_extra_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        std::string remote_agent_name_out;
+        uint64_t version;
+        EXPECT_EQ(local_agent_helper_->getAndLoadRemoteMd(remote_agent_, remote_agent_name_out),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->getRemoteMDVersion(remote_agent_name, version), NIXL_SUCCESS);
+
+        nixl_xfer_dlist_t local_xfer_dlist(DRAM_SEG), remote_xfer_dlist(DRAM_SEG);
+        local_xfer_dlist.addDesc(local_blob.getDesc());
+        remote_xfer_dlist.addDesc(remote_blob.getDesc());
+
+        // Requests made stale by a removal are recreated, the descriptor they use stays
+        const std::string xfer_remote = remote_agent_name_out;
+        std::atomic<bool> stop{false};
+        std::thread xfer_thread([&]() {
+            while (!stop.load()) {
+                nixlXferReqH *xfer_req;
+                if (local_agent_->createXferReq(NIXL_WRITE,
+                                                local_xfer_dlist,
+                                                remote_xfer_dlist,
+                                                xfer_remote,
+                                                xfer_req,
+                                                &local_extra_params) != NIXL_SUCCESS)
+                    continue;
+                while (!stop.load() && (local_agent_->postXferReq(xfer_req) == NIXL_SUCCESS))
+                    local_agent_->getXferStatus(xfer_req);
+                EXPECT_EQ(local_agent_->releaseXferReq(xfer_req), NIXL_SUCCESS);
+            }
+        });
+
+        // Deltas alternately add and remove a second registration of the remote
+        for (int i = 0; i < 200; ++i) {
+            blob added_blob;
+            nixl_reg_dlist_t added_reg_dlist(DRAM_SEG);
+            added_reg_dlist.addDesc(added_blob.getDesc());
+            nixl_blob_t delta_md;
+
+            EXPECT_EQ(remote_agent_->registerMem(added_reg_dlist, &remote_extra_params),
+                      NIXL_SUCCESS);
+            EXPECT_EQ(remote_agent_->getLocalMDDelta(version, delta_md), NIXL_SUCCESS);
+            EXPECT_EQ(local_agent_->loadRemoteMD(delta_md, remote_agent_name_out), NIXL_SUCCESS);
+            EXPECT_EQ(local_agent_->getRemoteMDVersion(remote_agent_name, version), NIXL_SUCCESS);
+
+            EXPECT_EQ(remote_agent_->deregisterMem(added_reg_dlist, &remote_extra_params),
+                      NIXL_SUCCESS);
+            EXPECT_EQ(remote_agent_->getLocalMDDelta(version, delta_md), NIXL_SUCCESS);
+            EXPECT_EQ(local_agent_->loadRemoteMD(delta_md, remote_agent_name_out), NIXL_SUCCESS);
+            EXPECT_EQ(local_agent_->getRemoteMDVersion(remote_agent_name, version), NIXL_SUCCESS);
+        }
+
+        stop.store(true);
+        xfer_thread.join();
+        EXPECT_EQ(unload_during_post.load(), 0);
+    }
+
+    TEST_F(dualAgentBridgeFixture, InvalidateConcurrentXferTest) {
+        // Post/status skip the agent lock in RW mode while the remote is unchanged
+        local_agent_helper_ = std::make_unique<agentHelper>(
+            local_agent_name,
+            nixlAgentConfig(true, false, 0, nixl_thread_sync_t::NIXL_THREAD_SYNC_RW));
+        local_agent_ = local_agent_helper_->getAgent();
+
+        // Remote metadata must not be unloaded, nor the remote disconnected, while the
+        // backend uses it in a post or status check
+        static char md_token;
+        std::atomic<int> in_xfer{0};
+        std::atomic<int> freed_during_xfer{0};
+        auto &engine = local_agent_helper_->getGMockEngine();
+        ON_CALL(engine, loadRemoteMD)
+            .WillByDefault([](const nixlBlobDesc &,
+                              const nixl_mem_t &,
+                              const std::string &,
+                              nixlBackendMD *&output) {
+                output = reinterpret_cast<nixlBackendMD *>(&md_token);
+                return NIXL_SUCCESS;
+            });
+        ON_CALL(engine, postXfer)
+            .WillByDefault([&in_xfer](const nixl_xfer_op_t &,
+                                      const nixl_meta_dlist_t &,
+                                      const nixl_meta_dlist_t &,
+                                      const std::string &,
+                                      nixlBackendReqH *&,
+                                      const nixl_opt_b_args_t *) {
+                in_xfer.fetch_add(1);
+                std::this_thread::sleep_for(std::chrono::microseconds(20));
+                in_xfer.fetch_sub(1);
+                return NIXL_IN_PROG;
+            });
+        ON_CALL(engine, checkXfer).WillByDefault([&in_xfer](nixlBackendReqH *) {
+            in_xfer.fetch_add(1);
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+            in_xfer.fetch_sub(1);
+            return NIXL_SUCCESS;
+        });
+        ON_CALL(engine, unloadMD).WillByDefault([&](nixlBackendMD *) {
+            if (in_xfer.load() != 0) freed_during_xfer.fetch_add(1);
+            return NIXL_SUCCESS;
+        });
+        ON_CALL(engine, disconnect).WillByDefault([&](const std::string &) {
+            if (in_xfer.load() != 0) freed_during_xfer.fetch_add(1);
+            return NIXL_SUCCESS;
+        });
+
+        nixl_b_params_t local_params, remote_params;
+        nixlBackendH *local_backend, *remote_backend;
+        EXPECT_EQ(local_agent_helper_->createBackendWithGMock(local_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->createBackendWithGMock(remote_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        nixl_reg_dlist_t local_reg_dlist(DRAM_SEG), remote_reg_dlist(DRAM_SEG);
+        nixl_opt_args_t local_extra_params, remote_extra_params;
+        blob local_blob, remote_blob;
+        EXPECT_EQ(local_agent_helper_->initAndRegisterMemory(
+                      local_blob, local_reg_dlist, local_extra_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->initAndRegisterMemory(
+                      remote_blob, remote_reg_dlist, remote_extra_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        std::string remote_agent_name_out;
+        EXPECT_EQ(local_agent_helper_->getAndLoadRemoteMd(remote_agent_, remote_agent_name_out),
+                  NIXL_SUCCESS);
+
+        nixl_xfer_dlist_t local_xfer_dlist(DRAM_SEG), remote_xfer_dlist(DRAM_SEG);
+        local_xfer_dlist.addDesc(local_blob.getDesc());
+        remote_xfer_dlist.addDesc(remote_blob.getDesc());
+
+        // Requests made stale by an invalidation are recreated once the remote is back
+        const std::string xfer_remote = remote_agent_name_out;
+        std::atomic<bool> stop{false};
+        std::atomic<int> completed{0};
+        std::thread xfer_thread([&]() {
+            while (!stop.load()) {
+                nixlXferReqH *xfer_req;
+                if (local_agent_->createXferReq(NIXL_WRITE,
+                                                local_xfer_dlist,
+                                                remote_xfer_dlist,
+                                                xfer_remote,
+                                                xfer_req,
+                                                &local_extra_params) != NIXL_SUCCESS)
+                    continue;
+                while (!stop.load() && (local_agent_->postXferReq(xfer_req) == NIXL_IN_PROG) &&
+                       (local_agent_->getXferStatus(xfer_req) == NIXL_SUCCESS))
+                    completed.fetch_add(1);
+                EXPECT_EQ(local_agent_->releaseXferReq(xfer_req), NIXL_SUCCESS);
+            }
+        });
+
+        for (int i = 0; i < 200; ++i) {
+            EXPECT_EQ(local_agent_->invalidateRemoteMD(remote_agent_name_out), NIXL_SUCCESS);
+            EXPECT_EQ(
+                local_agent_helper_->getAndLoadRemoteMd(remote_agent_, remote_agent_name_out),
+                NIXL_SUCCESS);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+
+        stop.store(true);
+        xfer_thread.join();
+        EXPECT_EQ(freed_during_xfer.load(), 0);
+        EXPECT_GT(completed.load(), 0);
+    }
+
+    TEST_F(dualAgentBridgeFixture, MetadataSnapshotTest) {
+        nixl_b_params_t local_params, remote_params;
+        nixlBackendH *local_backend, *remote_backend;
+        EXPECT_EQ(local_agent_helper_->createBackendWithGMock(local_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->createBackendWithGMock(remote_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        nixl_reg_dlist_t remote_reg_dlist(DRAM_SEG);
+        nixl_opt_args_t remote_extra_params;
+        blob remote_blob;
+        EXPECT_EQ(remote_agent_helper_->initAndRegisterMemory(
+                      remote_blob, remote_reg_dlist, remote_extra_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        const std::string path = testing::TempDir() + "nixl_md_snapshot_" + remote_agent_name;
+        std::string remote_agent_name_out;
+        EXPECT_EQ(local_agent_->saveRemoteMD(remote_agent_name, path), NIXL_ERR_NOT_FOUND);
+        EXPECT_EQ(local_agent_helper_->getAndLoadRemoteMd(remote_agent_, remote_agent_name_out),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->saveRemoteMD(remote_agent_name, path), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->loadRemoteMDSnapshot(path, remote_agent_name_out),
+                  NIXL_ERR_NOT_ALLOWED);
+
+        nixl_xfer_dlist_t remote_xfer_dlist(DRAM_SEG);
+        remote_xfer_dlist.addDesc(remote_blob.getDesc());
+        uint64_t version, snapshot_version;
+        EXPECT_EQ(local_agent_->getRemoteMDVersion(remote_agent_name, version), NIXL_SUCCESS);
+
+        // Restarted agent, snapshot is usable once validated by a delta, or right away if
+        // allowed to be used unvalidated
+        for (bool validated : {true, false}) {
+            agentHelper restarted_helper("RestartedAgent");
+            nixlAgent *restarted_agent = restarted_helper.getAgent();
+            nixl_b_params_t params;
+            nixlBackendH *backend;
+            EXPECT_EQ(restarted_helper.createBackendWithGMock(params, backend), NIXL_SUCCESS);
+
+            EXPECT_EQ(
+                restarted_agent->loadRemoteMDSnapshot(path, remote_agent_name_out, !validated),
+                NIXL_SUCCESS);
+            EXPECT_EQ(remote_agent_name_out, remote_agent_name);
+            EXPECT_EQ(restarted_agent->checkRemoteMD(remote_agent_name, remote_xfer_dlist),
+                      validated ? NIXL_ERR_NOT_FOUND : NIXL_SUCCESS);
+            EXPECT_EQ(restarted_agent->getRemoteMDVersion(remote_agent_name, snapshot_version),
+                      NIXL_SUCCESS);
+            EXPECT_EQ(snapshot_version, version);
+
+            nixl_blob_t md;
+            if (validated) {
+                nixlDlistH *dlist_hndl;
+                EXPECT_EQ(restarted_agent->prepXferDlist(
+                              remote_agent_name, remote_xfer_dlist, dlist_hndl),
+                          NIXL_ERR_NOT_ALLOWED);
+
+                EXPECT_EQ(remote_agent_->getLocalMDDelta(snapshot_version, md), NIXL_SUCCESS);
+                EXPECT_EQ(restarted_agent->loadRemoteMD(md, remote_agent_name_out),
+                          NIXL_SUCCESS);
+                EXPECT_EQ(restarted_agent->checkRemoteMD(remote_agent_name, remote_xfer_dlist),
+                          NIXL_SUCCESS);
+                EXPECT_EQ(restarted_agent->prepXferDlist(
+                              remote_agent_name, remote_xfer_dlist, dlist_hndl),
+                          NIXL_SUCCESS);
+                EXPECT_EQ(restarted_agent->releasedDlistH(dlist_hndl), NIXL_SUCCESS);
+                continue;
+            }
+
+            // Fresh metadata replaces the snapshot, instead of adding to it
+            EXPECT_EQ(remote_agent_->deregisterMem(remote_reg_dlist, &remote_extra_params),
+                      NIXL_SUCCESS);
+            EXPECT_EQ(remote_agent_->getLocalMD(md), NIXL_SUCCESS);
+            EXPECT_EQ(restarted_agent->loadRemoteMD(md, remote_agent_name_out), NIXL_SUCCESS);
+            EXPECT_EQ(restarted_agent->checkRemoteMD(remote_agent_name, remote_xfer_dlist),
+                      NIXL_ERR_NOT_FOUND);
+        }
+
+        std::remove(path.c_str());
+    }
+
     TEST_F(dualAgentBridgeFixture, XferReqSubFunctionsTest) {
         const std::string msg = "notification";
         EXPECT_CALL(remote_agent_helper_->getGMockEngine(), getNotifs)
@@ -392,6 +1213,97 @@ namespace agent {
         EXPECT_EQ(local_agent_->releasedDlistH(desc_hndl2), NIXL_SUCCESS);
     }
 
+    TEST_F(dualAgentBridgeFixture, XferTemplateTest) {
+        nixl_b_params_t local_params, remote_params;
+        nixlBackendH *local_backend, *remote_backend;
+        EXPECT_EQ(local_agent_helper_->createBackendWithGMock(local_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->createBackendWithGMock(remote_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        nixl_reg_dlist_t local_reg_dlist(DRAM_SEG), remote_reg_dlist(DRAM_SEG);
+        nixl_opt_args_t local_extra_params, remote_extra_params;
+        blob local_blob, remote_blob;
+        EXPECT_EQ(local_agent_helper_->initAndRegisterMemory(
+                      local_blob, local_reg_dlist, local_extra_params, local_backend),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_helper_->initAndRegisterMemory(
+                      remote_blob, remote_reg_dlist, remote_extra_params, remote_backend),
+                  NIXL_SUCCESS);
+
+        std::string remote_agent_name_out;
+        EXPECT_EQ(local_agent_helper_->getAndLoadRemoteMd(remote_agent_, remote_agent_name_out),
+                  NIXL_SUCCESS);
+
+        // Four back to back blocks of each buffer
+        const nixlBasicDesc local_desc = local_blob.getDesc();
+        const nixlBasicDesc remote_desc = remote_blob.getDesc();
+        const size_t block = local_desc.len / 4;
+        nixl_xfer_dlist_t local_xfer_dlist(DRAM_SEG), remote_xfer_dlist(DRAM_SEG);
+        for (size_t offset = 0; offset < local_desc.len; offset += block) {
+            local_xfer_dlist.addDesc(
+                nixlBasicDesc(local_desc.addr + offset, block, local_desc.devId));
+            remote_xfer_dlist.addDesc(
+                nixlBasicDesc(remote_desc.addr + offset, block, remote_desc.devId));
+        }
+
+        nixlDlistH *local_hndl, *remote_hndl;
+        EXPECT_EQ(local_agent_->prepXferDlist(NIXL_INIT_AGENT, local_xfer_dlist, local_hndl),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(
+            local_agent_->prepXferDlist(remote_agent_name_out, remote_xfer_dlist, remote_hndl),
+            NIXL_SUCCESS);
+
+        nixlXferTemplateH *tmpl_hndl;
+        const std::vector<int> indices = {0, 1, 2, 3};
+        EXPECT_EQ(local_agent_->prepXferTemplate(
+                      local_hndl, indices, remote_hndl, {0, 1, 2, 4}, tmpl_hndl),
+                  NIXL_ERR_INVALID_PARAM);
+        EXPECT_EQ(
+            local_agent_->prepXferTemplate(local_hndl, indices, remote_hndl, indices, tmpl_hndl),
+            NIXL_SUCCESS);
+
+        // Selected pairs are merged when back to back: all of them into one, {0}, {2, 3} into two
+        for (const std::vector<bool> &selected :
+             {std::vector<bool>(), std::vector<bool>({true, false, true, true})}) {
+            const int expected_count = selected.empty() ? 1 : 2;
+            EXPECT_CALL(local_agent_helper_->getGMockEngine(), prepXfer)
+                .WillOnce([=](const nixl_xfer_op_t &,
+                              const nixl_meta_dlist_t &src,
+                              const nixl_meta_dlist_t &dst,
+                              const std::string &,
+                              nixlBackendReqH *&,
+                              const nixl_opt_b_args_t *) {
+                    EXPECT_EQ(src.descCount(), expected_count);
+                    EXPECT_EQ(dst.descCount(), expected_count);
+                    EXPECT_EQ(src[expected_count - 1].len, local_desc.len / expected_count);
+                    return NIXL_SUCCESS;
+                });
+
+            nixlXferReqH *xfer_req;
+            EXPECT_EQ(local_agent_->makeXferReq(NIXL_WRITE, tmpl_hndl, selected, xfer_req),
+                      NIXL_SUCCESS);
+            EXPECT_EQ(local_agent_->postXferReq(xfer_req), NIXL_SUCCESS);
+            EXPECT_EQ(local_agent_->releaseXferReq(xfer_req), NIXL_SUCCESS);
+        }
+
+        nixlXferReqH *xfer_req;
+        EXPECT_EQ(local_agent_->makeXferReq(NIXL_WRITE, tmpl_hndl, {true, false}, xfer_req),
+                  NIXL_ERR_INVALID_PARAM);
+        EXPECT_EQ(local_agent_->makeXferReq(
+                      NIXL_WRITE, tmpl_hndl, {false, false, false, false}, xfer_req),
+                  NIXL_ERR_INVALID_PARAM);
+
+        // The template is stale once its remote is invalidated
+        EXPECT_EQ(local_agent_->invalidateRemoteMD(remote_agent_name_out), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->makeXferReq(NIXL_WRITE, tmpl_hndl, {}, xfer_req),
+                  NIXL_ERR_NOT_FOUND);
+
+        EXPECT_EQ(local_agent_->releaseXferTemplate(tmpl_hndl), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->releasedDlistH(local_hndl), NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_->releasedDlistH(remote_hndl), NIXL_SUCCESS);
+    }
+
     TEST_F(dualAgentBridgeFixture, GenNotifTest) {
         const std::string msg = "notification";
         EXPECT_CALL(remote_agent_helper_->getGMockEngine(), getNotifs)
@@ -461,6 +1373,91 @@ namespace agent {
         EXPECT_EQ(local_agent_->releaseXferReq(xfer_req), NIXL_SUCCESS);
     }
 
+    TEST_F(dualAgentBridgeFixture, BackendPreferenceTest) {
+        // Two DRAM capable backends on each side
+        nixl_b_params_t local_params, remote_params;
+        nixlBackendH *local_backends[2], *remote_backends[2];
+        const nixl_backend_t types[2] = {GetMockBackendName(), GetSecondMockBackendName()};
+        for (int i = 0; i < 2; i++) {
+            EXPECT_EQ(local_agent_helper_->createBackendWithGMock(
+                          local_params, local_backends[i], types[i]),
+                      NIXL_SUCCESS);
+            EXPECT_EQ(remote_agent_helper_->createBackendWithGMock(
+                          remote_params, remote_backends[i], types[i]),
+                      NIXL_SUCCESS);
+        }
+
+        nixl_reg_dlist_t local_reg_dlist(DRAM_SEG), remote_reg_dlist(DRAM_SEG);
+        nixl_opt_args_t local_extra_params, remote_extra_params;
+        blob local_blob, remote_blob;
+        local_reg_dlist.addDesc(local_blob.getDesc());
+        remote_reg_dlist.addDesc(remote_blob.getDesc());
+        local_extra_params.backends = {local_backends[0], local_backends[1]};
+        remote_extra_params.backends = {remote_backends[0], remote_backends[1]};
+        EXPECT_EQ(local_agent_->registerMem(local_reg_dlist, &local_extra_params), NIXL_SUCCESS);
+        EXPECT_EQ(remote_agent_->registerMem(remote_reg_dlist, &remote_extra_params),
+                  NIXL_SUCCESS);
+
+        std::string remote_agent_name_out;
+        EXPECT_EQ(local_agent_helper_->getAndLoadRemoteMd(remote_agent_, remote_agent_name_out),
+                  NIXL_SUCCESS);
+
+        EXPECT_EQ(local_agent_->setBackendPreference({nullptr}), NIXL_ERR_INVALID_PARAM);
+
+        nixl_xfer_dlist_t local_xfer_dlist(DRAM_SEG), remote_xfer_dlist(DRAM_SEG);
+        local_xfer_dlist.addDesc(local_blob.getDesc());
+        remote_xfer_dlist.addDesc(remote_blob.getDesc());
+
+        // No backends given, so the selection is made (and then reused) by the agent
+        auto expect_selected = [&](nixlBackendH *expected) {
+            for (int i = 0; i < 2; i++) {
+                nixlXferReqH *xfer_req;
+                EXPECT_EQ(local_agent_->createXferReq(NIXL_WRITE,
+                                                      local_xfer_dlist,
+                                                      remote_xfer_dlist,
+                                                      remote_agent_name_out,
+                                                      xfer_req),
+                          NIXL_SUCCESS);
+
+                nixlBackendH *backend_out;
+                EXPECT_EQ(local_agent_->queryXferBackend(xfer_req, backend_out), NIXL_SUCCESS);
+                EXPECT_EQ(backend_out, expected);
+
+                EXPECT_EQ(local_agent_->releaseXferReq(xfer_req), NIXL_SUCCESS);
+            }
+        };
+
+        // Each preference change drops the cached choice
+        EXPECT_EQ(local_agent_->setBackendPreference({local_backends[1], local_backends[0]}),
+                  NIXL_SUCCESS);
+        expect_selected(local_backends[1]);
+        EXPECT_EQ(local_agent_->setBackendPreference({local_backends[0], local_backends[1]}),
+                  NIXL_SUCCESS);
+        expect_selected(local_backends[0]);
+        EXPECT_EQ(local_agent_->setBackendPreference({local_backends[1]}), NIXL_SUCCESS);
+        expect_selected(local_backends[1]);
+
+        // Deregistering from the cached backend drops the choice, the other one is picked
+        nixl_opt_args_t second_params;
+        second_params.backends = {local_backends[1]};
+        EXPECT_EQ(local_agent_->deregisterMem(local_reg_dlist, &second_params), NIXL_SUCCESS);
+        expect_selected(local_backends[0]);
+
+        // Registering with it again makes the preferred backend usable again
+        EXPECT_EQ(local_agent_->registerMem(local_reg_dlist, &second_params), NIXL_SUCCESS);
+        expect_selected(local_backends[1]);
+
+        // Remote metadata loaded after an invalidation only has the other backend
+        EXPECT_EQ(local_agent_->invalidateRemoteMD(remote_agent_name_out), NIXL_SUCCESS);
+        nixl_opt_args_t remote_second_params;
+        remote_second_params.backends = {remote_backends[1]};
+        EXPECT_EQ(remote_agent_->deregisterMem(remote_reg_dlist, &remote_second_params),
+                  NIXL_SUCCESS);
+        EXPECT_EQ(local_agent_helper_->getAndLoadRemoteMd(remote_agent_, remote_agent_name_out),
+                  NIXL_SUCCESS);
+        expect_selected(local_backends[0]);
+    }
+
     TEST_F(dualAgentBridgeFixture, MakeConnectionTest) {
         nixl_b_params_t local_params, remote_params;
         nixlBackendH *local_backend, *remote_backend;
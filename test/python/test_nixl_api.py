@@ -262,6 +262,7 @@ def test_get_xfer_telemetry(backend_name):
 
         telem = agent1.get_xfer_telemetry(handle)
         assert telem.descCount == 2
+        assert telem.requestedDescCount == 2
         assert telem.totalBytes == mem_size
         assert telem.startTime > 0
         assert telem.postDuration > 0
@@ -319,6 +320,7 @@ def test_get_xfer_telemetry_cfg(backend_name):
 
         telem = agent1.get_xfer_telemetry(handle)
         assert telem.descCount == 2
+        assert telem.requestedDescCount == 2
         assert telem.totalBytes == mem_size
         assert telem.startTime > 0
         assert telem.postDuration > 0
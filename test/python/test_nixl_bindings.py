@@ -149,6 +149,7 @@ def test_agent():
     # Verify transfer telemetry
     telem = agent1.getXferTelemetry(handle)
     assert telem.descCount == 1
+    assert telem.requestedDescCount == 1
     assert telem.totalBytes == req_size
     assert telem.startTime > 0
     assert telem.postDuration > 0
@@ -24,6 +24,7 @@
 #include <cassert>
 #include <cstring>
 #include <string>
+#include <thread>
 #include <absl/strings/str_format.h>
 #include "nixl.h"
 #include "nixl_params.h"
@@ -727,6 +728,295 @@ test_posix_repost (std::string test_files_dir_path_abs_path, bool use_uring) {
     return 0;
 }
 
+namespace {
+    // A descriptor pair of a planning test transfer, offsets into the test buffer and file
+    struct planPair {
+        size_t mem_offset;
+        size_t file_offset;
+        size_t len;
+    };
+
+    nixl_status_t
+    run_xfer (nixlAgent &agent,
+              nixl_xfer_op_t op,
+              const nixl_xfer_dlist_t &mem,
+              const nixl_xfer_dlist_t &file,
+              const std::string &agent_name) {
+        nixlXferReqH *treq = nullptr;
+        nixl_status_t status = agent.createXferReq (op, mem, file, agent_name, treq);
+        if (status != NIXL_SUCCESS) {
+            return status;
+        }
+
+        status = agent.postXferReq (treq);
+        while (status == NIXL_IN_PROG) {
+            status = agent.getXferStatus (treq);
+        }
+        agent.releaseXferReq (treq);
+        return status;
+    }
+
+    /*
+     * Writes a buffer through the given descriptor pairs and reads it back into the cleared
+     * buffer. Checks the file content of every pair and the data read back.
+     * mem_regions are the (offset, length) ranges of the buffer registered separately.
+     */
+    int
+    plan_case (const std::string &title,
+               const std::string &test_files_dir_path_abs_path,
+               bool use_uring,
+               nixl_b_params_t params,
+               size_t mem_size,
+               const std::vector<std::pair<size_t, size_t>> &mem_regions,
+               const std::vector<planPair> &pairs) {
+        const std::string agent_name = "POSIXPlanTester";
+        std::cout << "- " << title << " (" << pairs.size() << " descriptors)" << std::endl;
+
+        params[use_uring ? "use_uring" : "use_aio"] = "true";
+        nixlAgent agent (agent_name, nixlAgentConfig (true));
+        nixlBackendH *posix = nullptr;
+        if (agent.createBackend ("POSIX", params, posix) != NIXL_SUCCESS) {
+            std::cerr << "Failed to create POSIX backend" << std::endl;
+            return 1;
+        }
+
+        void *ptr;
+        if (posix_memalign (&ptr, page_size, mem_size) != 0) {
+            std::cerr << "DRAM allocation failed" << std::endl;
+            return 1;
+        }
+        std::unique_ptr<void, PosixMemalignDeleter> mem (ptr);
+        char *base = static_cast<char *> (ptr);
+        // Position dependent pattern, so data landing at the wrong offset is caught
+        std::vector<char> expected (mem_size);
+        for (size_t i = 0; i < mem_size; ++i) {
+            expected[i] = static_cast<char> ((i * 7 + i / 4093) % 251);
+        }
+        memcpy (base, expected.data(), mem_size);
+
+        size_t file_size = 0;
+        for (const auto &pair : pairs) {
+            file_size = std::max (file_size, pair.file_offset + pair.len);
+        }
+        tempFile file (test_files_dir_path_abs_path + "/" +
+                           generate_timestamped_filename (test_file_name) + "_plan",
+                       O_RDWR | O_CREAT,
+                       S_IRUSR | S_IWUSR);
+
+        nixl_reg_dlist_t mem_reg (DRAM_SEG);
+        for (const auto &[offset, len] : mem_regions) {
+            mem_reg.addDesc (nixlBlobDesc (reinterpret_cast<uintptr_t> (base + offset), len, 0));
+        }
+        nixl_reg_dlist_t file_reg (FILE_SEG);
+        file_reg.addDesc (nixlBlobDesc (0, file_size, file.fd));
+        if (agent.registerMem (mem_reg) != NIXL_SUCCESS ||
+            agent.registerMem (file_reg) != NIXL_SUCCESS) {
+            std::cerr << "Failed to register memory with NIXL" << std::endl;
+            return 1;
+        }
+
+        nixl_xfer_dlist_t mem_xfer (DRAM_SEG);
+        nixl_xfer_dlist_t file_xfer (FILE_SEG);
+        for (const auto &pair : pairs) {
+            mem_xfer.addDesc (
+                nixlBasicDesc (reinterpret_cast<uintptr_t> (base + pair.mem_offset), pair.len, 0));
+            file_xfer.addDesc (nixlBasicDesc (pair.file_offset, pair.len, file.fd));
+        }
+
+        nixl_status_t status = run_xfer (agent, NIXL_WRITE, mem_xfer, file_xfer, agent_name);
+        if (status != NIXL_SUCCESS) {
+            std::cerr << "Write failed - status: " << nixlEnumStrings::statusStr (status)
+                      << std::endl;
+            return 1;
+        }
+
+        std::vector<char> file_data;
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            file_data.resize (pairs[i].len);
+            if (pread (file.fd, file_data.data(), pairs[i].len, pairs[i].file_offset) !=
+                    static_cast<ssize_t> (pairs[i].len) ||
+                memcmp (file_data.data(), &expected[pairs[i].mem_offset], pairs[i].len) != 0) {
+                std::cerr << "File content of descriptor " << i << " is wrong" << std::endl;
+                return 1;
+            }
+        }
+
+        clear_buffer (base, mem_size);
+        status = run_xfer (agent, NIXL_READ, mem_xfer, file_xfer, agent_name);
+        if (status != NIXL_SUCCESS) {
+            std::cerr << "Read failed - status: " << nixlEnumStrings::statusStr (status)
+                      << std::endl;
+            return 1;
+        }
+
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            if (memcmp (base + pairs[i].mem_offset, &expected[pairs[i].mem_offset],
+                        pairs[i].len) != 0) {
+                std::cerr << "Data read into descriptor " << i << " is wrong" << std::endl;
+                return 1;
+            }
+        }
+
+        agent.deregisterMem (file_reg);
+        agent.deregisterMem (mem_reg);
+        return 0;
+    }
+}
+
+// Transfers whose descriptors are merged, split, gathered or exceed the io_uring ring
+int
+test_posix_planning (std::string test_files_dir_path_abs_path, bool use_uring) {
+    constexpr size_t chunk = 64 * kb_size;
+    constexpr int num_chunks = 32;
+
+    print_segment_title ("NIXL STORAGE I/O PLANNING TEST STARTING (POSIX PLUGIN)");
+
+    // Back to back both in memory and in the file, merged into one I/O
+    std::vector<planPair> adjacent;
+    for (int i = 0; i < num_chunks; ++i) {
+        adjacent.push_back ({i * chunk, i * chunk, chunk});
+    }
+    if (plan_case ("Adjacent pairs merged", test_files_dir_path_abs_path, use_uring, {},
+                   num_chunks * chunk, {{0, num_chunks * chunk}}, adjacent)) {
+        return 1;
+    }
+
+    // One pair 16 times the split size, and one that is not a multiple of it
+    if (plan_case ("Oversized pair split", test_files_dir_path_abs_path, use_uring,
+                   {{"io_split_size", std::to_string (chunk)}}, 32 * chunk,
+                   {{0, 32 * chunk}}, {{0, 0, 16 * chunk}, {16 * chunk, 20 * chunk, 15 * chunk + 100}})) {
+        return 1;
+    }
+
+    // Split further to reach the target queue depth
+    if (plan_case ("Single pair spread to the target depth", test_files_dir_path_abs_path,
+                   use_uring, {{"io_target_depth", "8"}}, 8 * mb_size, {{0, 8 * mb_size}},
+                   {{0, 0, 8 * mb_size}})) {
+        return 1;
+    }
+
+    // Back to back in the file only, gathered into readv/writev
+    std::vector<planPair> scattered;
+    for (int i = 0; i < num_chunks; ++i) {
+        scattered.push_back ({(num_chunks - 1 - i) * 2 * chunk + 512, i * chunk, chunk});
+    }
+    if (plan_case ("Scattered memory gathered", test_files_dir_path_abs_path, use_uring, {},
+                   2 * num_chunks * chunk + kb_size, {{0, 2 * num_chunks * chunk + kb_size}},
+                   scattered)) {
+        return 1;
+    }
+
+    // Back to back across two registrations of the same buffer
+    if (plan_case ("Merge across two registrations", test_files_dir_path_abs_path, use_uring, {},
+                   num_chunks * chunk,
+                   {{0, num_chunks * chunk / 2}, {num_chunks * chunk / 2, num_chunks * chunk / 2}},
+                   adjacent)) {
+        return 1;
+    }
+
+    // Nothing merges, so every pair is its own I/O, many more than the ring entries
+    std::vector<planPair> many;
+    for (int i = 0; i < 256; ++i) {
+        many.push_back ({i * 2 * kb_size, (255 - i) * 4 * kb_size, kb_size + i});
+    }
+    if (plan_case ("More I/Os than io_uring ring entries", test_files_dir_path_abs_path,
+                   use_uring,
+                   {{"uring_ring_entries", "8"}, {"uring_window", "4"}, {"io_vectored", "false"}},
+                   512 * kb_size, {{0, 512 * kb_size}}, many)) {
+        return 1;
+    }
+
+    return 0;
+}
+
+// An io_uring request whose I/Os partly fail is reposted from other threads, while the window
+// keeps most of its I/Os queued behind the failed ones
+int
+test_posix_repost_after_error (std::string test_files_dir_path_abs_path) {
+    constexpr int num_pairs = 64;
+    constexpr size_t chunk = 4 * kb_size;
+    const std::string agent_name = "POSIXRepostErrorTester";
+
+    print_segment_title ("NIXL STORAGE REPOST AFTER ERROR TEST STARTING (POSIX PLUGIN)");
+
+    nixl_b_params_t params = {{"use_uring", "true"},
+                              {"uring_ring_entries", "8"},
+                              {"uring_window", "4"},
+                              {"io_vectored", "false"}};
+    nixlAgent agent (agent_name, nixlAgentConfig (true));
+    nixlBackendH *posix = nullptr;
+    if (agent.createBackend ("POSIX", params, posix) != NIXL_SUCCESS) {
+        std::cerr << "Failed to create POSIX backend" << std::endl;
+        return 1;
+    }
+
+    void *ptr;
+    if (posix_memalign (&ptr, page_size, num_pairs * chunk) != 0) {
+        std::cerr << "DRAM allocation failed" << std::endl;
+        return 1;
+    }
+    std::unique_ptr<void, PosixMemalignDeleter> mem (ptr);
+    fill_test_pattern (ptr, repost_test_phrase_1, num_pairs * chunk);
+
+    // Writes to the read-only file fail, the pairs alternate between both files
+    const std::string file_path =
+        test_files_dir_path_abs_path + "/" + generate_timestamped_filename (test_file_name);
+    tempFile good_file (file_path + "_rw", O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+    tempFile bad_file (file_path + "_ro", O_RDONLY | O_CREAT, S_IRUSR | S_IWUSR);
+
+    nixl_reg_dlist_t mem_reg (DRAM_SEG);
+    mem_reg.addDesc (nixlBlobDesc (reinterpret_cast<uintptr_t> (ptr), num_pairs * chunk, 0));
+    nixl_reg_dlist_t file_reg (FILE_SEG);
+    file_reg.addDesc (nixlBlobDesc (0, num_pairs * chunk, good_file.fd));
+    file_reg.addDesc (nixlBlobDesc (0, num_pairs * chunk, bad_file.fd));
+    if (agent.registerMem (mem_reg) != NIXL_SUCCESS ||
+        agent.registerMem (file_reg) != NIXL_SUCCESS) {
+        std::cerr << "Failed to register memory with NIXL" << std::endl;
+        return 1;
+    }
+
+    nixl_xfer_dlist_t mem_xfer (DRAM_SEG);
+    nixl_xfer_dlist_t file_xfer (FILE_SEG);
+    for (int i = 0; i < num_pairs; ++i) {
+        mem_xfer.addDesc (
+            nixlBasicDesc (reinterpret_cast<uintptr_t> (ptr) + i * chunk, chunk, 0));
+        file_xfer.addDesc (nixlBasicDesc (i * chunk, chunk, (i % 2) ? bad_file.fd : good_file.fd));
+    }
+
+    nixlXferReqH *treq = nullptr;
+    if (agent.createXferReq (NIXL_WRITE, mem_xfer, file_xfer, agent_name, treq) !=
+        NIXL_SUCCESS) {
+        std::cerr << "Failed to create write transfer request" << std::endl;
+        return 1;
+    }
+
+    auto post_and_wait = [&]() {
+        nixl_status_t status = agent.postXferReq (treq);
+        while (status == NIXL_IN_PROG) {
+            status = agent.getXferStatus (treq);
+        }
+        return status;
+    };
+
+    // Every post fails, each from a different thread and so on a different ring
+    for (int round = 0; round < 4; ++round) {
+        nixl_status_t status = NIXL_SUCCESS;
+        std::thread poster ([&]() { status = post_and_wait(); });
+        poster.join();
+        if (status == NIXL_SUCCESS || status == NIXL_IN_PROG) {
+            std::cerr << "Write to a read-only file did not fail in round " << round
+                      << std::endl;
+            agent.releaseXferReq (treq);
+            return 1;
+        }
+    }
+
+    agent.releaseXferReq (treq);
+    agent.deregisterMem (file_reg);
+    agent.deregisterMem (mem_reg);
+    return 0;
+}
+
 int
 main (int argc, char *argv[]) {
     if (page_size <= 0) {
@@ -809,5 +1099,19 @@ main (int argc, char *argv[]) {
         return 1;
     }
 
+    ret = test_posix_planning (test_files_dir_path_abs_path, use_uring);
+    if (ret != 0) {
+        std::cerr << "I/O Planning Test failed" << std::endl;
+        return 1;
+    }
+
+    if (use_uring) {
+        ret = test_posix_repost_after_error (test_files_dir_path_abs_path);
+        if (ret != 0) {
+            std::cerr << "Repost After Error Test failed" << std::endl;
+            return 1;
+        }
+    }
+
     return 0;
 }
@@ -17,6 +17,7 @@
 #include "serdes/serdes.h"
 #include <cassert>
 #include <iostream>
+#include <string_view>
 
 int main() {
 
@@ -61,5 +62,49 @@ int main() {
 
     free(ptr);
 
+    // In place deserialization, views point into the imported buffer
+    nixlSerDes sd3;
+    ret = sd3.importView(sdbuf);
+    assert(ret == 0);
+
+    // A buffer is only read with its stored length, a mismatch leaves the position unchanged
+    int64_t k = 0;
+    ret = sd3.getBuf(t1, &k, sizeof(k));
+    assert(ret == NIXL_ERR_MISMATCH);
+    int16_t h = 0;
+    ret = sd3.getBuf(t1, &h, sizeof(h));
+    assert(ret == NIXL_ERR_MISMATCH);
+
+    int j = 0;
+    ret = sd3.getBuf(t1, &j, sizeof(j));
+    assert(ret == 0);
+    assert(j == 0xff);
+
+    assert(sd3.remaining() == nixlSerDes::fieldSize(t2, s.size()));
+    std::string_view v = sd3.getStrView(t2);
+    assert(v == "testString");
+    assert(v.data() >= sdbuf.data() && v.data() < sdbuf.data() + sdbuf.size());
+    assert(sd3.remaining() == 0);
+
+    // Pre-sized output matches the field sizes, and can be moved out
+    nixlSerDes sd4;
+    size_t base_size = sd4.exportStr().size();
+    sd4.reserve(nixlSerDes::fieldSize(t1, sizeof(i)) + nixlSerDes::fieldSize(t2, s.size()));
+    sd4.addBuf(t1, &i, sizeof(i));
+    sd4.addStr(t2, s);
+    std::string sd4buf = std::move(sd4).exportStr();
+    assert(sd4buf == sdbuf);
+    assert(sd4buf.size() == base_size + nixlSerDes::fieldSize(t1, sizeof(i)) +
+                            nixlSerDes::fieldSize(t2, s.size()));
+
+    // Truncated input fails instead of reading past the end
+    nixlSerDes sd5;
+    ret = sd5.importView(std::string_view(sdbuf).substr(0, sdbuf.size() - 4));
+    assert(ret == 0);
+    assert(sd5.getBufLen(t1) == sizeof(i));
+    ret = sd5.getBuf(t1, &j, sizeof(j));
+    assert(ret == 0);
+    assert(sd5.getStrView(t2).empty());
+
     return 0;
 }